@@ -0,0 +1,65 @@
+﻿//
+// 行动名驻留表（ActCatalog）
+// --------------------------
+// 职责：
+// - 把行动名映射为从 0 开始的连续 ID，供敌人转移表按列索引
+// 关键约定：
+// - 只增不删；ID 在进程内稳定，不写入存档；按 ID 取名返回的引用指向 map 中的键，不随登记失效
+// - 登记只发生在加载期，查表路径不经过这里
+//
+#include "Battle/ActCatalog.h"
+#include <deque>
+#include <map>
+#include <mutex>
+
+namespace {
+std::mutex& catalogMutex() {
+	static std::mutex m;
+	return m;
+}
+
+std::map<sf::String, int>& catalog() {
+	static std::map<sf::String, int> names;
+	return names;
+}
+
+// 按 ID 排列，指向 catalog() 中的键
+std::deque<const sf::String*>& byId() {
+	static std::deque<const sf::String*> ids;
+	return ids;
+}
+}
+
+int ActCatalog::intern(const sf::String& name)
+{
+	std::lock_guard<std::mutex> lock(catalogMutex());
+	auto& names = catalog();
+	auto it = names.find(name);
+	if (it != names.end()) return it->second;
+	const int id = static_cast<int>(names.size());
+	it = names.emplace(name, id).first;
+	byId().push_back(&it->first);
+	return id;
+}
+
+int ActCatalog::find(const sf::String& name)
+{
+	std::lock_guard<std::mutex> lock(catalogMutex());
+	const auto& names = catalog();
+	auto it = names.find(name);
+	return (it != names.end()) ? it->second : -1;
+}
+
+const sf::String& ActCatalog::name(int id)
+{
+	static const sf::String none;
+	std::lock_guard<std::mutex> lock(catalogMutex());
+	const auto& ids = byId();
+	return (id >= 0 && static_cast<std::size_t>(id) < ids.size()) ? *ids[static_cast<std::size_t>(id)] : none;
+}
+
+std::size_t ActCatalog::size()
+{
+	std::lock_guard<std::mutex> lock(catalogMutex());
+	return catalog().size();
+}
@@ -0,0 +1,22 @@
+﻿/*
+行动名驻留表。
+包含：
+
+行动名 → 连续整数 ID（加载敌人定义、构造角色行动表时登记），ID → 行动名
+
+结算期敌人按 ID 查转移表，不再比较字符串
+*/
+#pragma once
+#include <SFML/System/String.hpp>
+#include <cstddef>
+
+class ActCatalog {
+public:
+	// 登记行动名并返回其 ID；同名返回同一 ID。加锁，可在任意线程调用
+	static int intern(const sf::String& name);
+	// 查询已登记的 ID；未登记返回 -1
+	static int find(const sf::String& name);
+	// ID 对应的行动名；未登记返回空串。引用在进程内一直有效
+	static const sf::String& name(int id);
+	static std::size_t size();
+};
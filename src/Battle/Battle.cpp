@@ -4,18 +4,19 @@
 // 功能概览：
 // - 管理战斗阶段：开场(Intro) -> 选择(Selection) -> 行动(ActionExecute) -> 弹幕(BulletHell) -> 回合结束(TurnEnd) -> 胜利/失败
 // - 维护我方与敌方状态，处理玩家在选择阶段生成的指令队列并在行动阶段应用
-// - 提供胜利/失败判定与简易战斗日志（仅保留最近 4 条）
+//   （数值结算交给 TurnResolver，本类只负责应用事件：消耗背包、写日志）
+// - 提供胜利/失败判定与简易战斗日志（环形缓冲仅保留最近 4 条，显示时才格式化）
 //
 #include "Battle/Battle.h"
 #include "Battle/Enemy.h"
 #include <algorithm>
-#include <sstream>
 
 // 构造：初始化敌人列表、我方队伍指针与战斗初始阶段
 Battle::Battle(std::vector<Enemy> enemies)
 	: m_enemies(std::move(enemies))
 {
 	m_party = &Global::partyHeroes;
+	m_resolver.prepare(*m_party);
 	m_phase = BattlePhase::Intro;
 	m_phaseTimer = 0.f;
 }
@@ -47,6 +48,12 @@ void Battle::startSelection()
 	}
 }
 
+// 增减 TP，夹在 [0, kMaxTP]
+void Battle::addTP(float amount)
+{
+	m_tp = std::clamp(m_tp + amount, 0.f, BattleRules::kMaxTP);
+}
+
 // 进入“行动执行阶段”：按队列逐条应用指令
 void Battle::startActionPhase()
 {
@@ -68,6 +75,7 @@ void Battle::startTurnEnd()
 	m_phase = BattlePhase::TurnEnd;
 	m_phaseTimer = 0.f;
 	m_commandQueue.clear();
+	m_turnEvents.clear();
 }
 
 // 执行本回合已选择的全部指令
@@ -142,104 +150,31 @@ bool Battle::isGameOver() const
 	});
 }
 
-// 处理本回合的所有已选择指令（逐条应用）
+// 处理本回合的所有已选择指令：纯结算得到事件列表，再统一应用副作用
+// 结算后把指令队列换入 m_resolvedCommands（交换不拷贝，清空的旧队列保留容量）
 void Battle::processQueuedCommands()
 {
-	for (const auto& cmd : m_commandQueue) {
-		applyCommand(cmd);
-	}
+	m_turnEvents.clear();
+	if (!m_party) return;
+	m_resolver.resolve(m_commandQueue, *m_party, m_enemies, m_turnEvents);
+	m_resolvedCommands.swap(m_commandQueue);
+	m_commandQueue.clear();
+	applyTurnEvents();
 }
 
-// 应用单条指令到战斗状态：依据类型进行伤害、治疗、仁慈值、标记等结算
-void Battle::applyCommand(const BattleCommand& cmd)
+// 应用结算事件的副作用：从背包消耗已生效的物品（同时归还菜单阶段的占用），并记录日志
+void Battle::applyTurnEvents()
 {
-	if (!m_party || m_party->empty()) return;
-	if (cmd.actorIndex < 0 || cmd.actorIndex >= static_cast<int>(m_party->size())) return;
-
-	HeroRuntime& actor = (*m_party)[cmd.actorIndex];
-	Enemy* target = nullptr;
-	if (cmd.targetIndex >= 0 && cmd.targetIndex < static_cast<int>(m_enemies.size())) {
-		target = &m_enemies[cmd.targetIndex];
-	}
-
-	switch (cmd.type) {
-	case ActionType::Fight: {
-		// 普通攻击：若目标可受伤，则计算伤害并记录日志
-		if (!target) break;
-		if (target->ignoreDamage()) {
-			pushLog(sf::String(actor.name + sf::String(L" 的攻击未对敌人造成影响。")));
-			break;
-		}
-		int dmg = std::max(1, actor.baseAttack + 6);
-		target->takeDamage(dmg);
-		std::ostringstream oss;
-		oss << actor.name.toAnsiString() << " 造成 " << dmg << " 伤害。";
-		pushLog(sf::String(oss.str().c_str()));
-		break; }
-	case ActionType::Act: {
-		// 行动：优先让敌人自定义处理；否则按通用字段结算（伤害/仁慈/治疗）
-		if (!target) break;
-		bool handled = false;
-		if (cmd.actData.has_value()) {
-			const ActData& act = *cmd.actData;
-			handled = target->onAct(act);
-			if (!handled) {
-				if (act.damage > 0) {
-					target->takeDamage(act.damage);
-				}
-				if (act.mercyAdd > 0.f) {
-					target->addMercy(act.mercyAdd);
-				}
-				if (act.heal > 0) {
-					actor.hp = std::min(actor.maxHP, actor.hp + act.heal);
-				}
+	for (const auto& ev : m_turnEvents) {
+		if (ev.kind == TurnEventKind::ItemUsed) {
+			const auto& itemID = m_resolvedCommands[ev.command].itemID;
+			if (itemID.has_value()) {
+				Global::inventory.consume(*itemID);
 			}
-			pushLog(sf::String(actor.name + sf::String(L" 使用行动：") + act.name));
-		}
-		break; }
-	case ActionType::Item: {
-		// 物品：根据 ID 决定治疗量，应用到目标我方角色，并尝试从背包移除一件对应物品
-		int heal = 50;
-		if (cmd.itemID.has_value() && cmd.itemID == std::string("luojia_drink")) {
-			heal = 80;
 		}
-		int targetHeroIdx = std::clamp(cmd.targetIndex, 0, static_cast<int>(m_party->size()) - 1);
-		HeroRuntime& targetHero = (*m_party)[targetHeroIdx];
-		targetHero.hp = std::min(targetHero.maxHP, targetHero.hp + heal);
-		pushLog(actor.name + sf::String(L" 使用道具，回复 ") + targetHero.name + sf::String(L" ") + sf::String(std::to_string(heal).c_str()) + sf::String(L" HP"));
-		// 简单移除背包里的第一瓶匹配物品
-		if (cmd.itemID.has_value()) {
-			auto& bag = Global::inventory;
-			auto it = std::find_if(bag.begin(), bag.end(), [&](const InventoryItem& item) {
-				return item.id == *cmd.itemID;
-			});
-			if (it != bag.end()) bag.erase(it);
-		}
-		break; }
-	case ActionType::Spare: {
-		// 饶恕：若敌人满足条件，则设置为“被饶恕”并记录日志
-		if (target) {
-			bool spared = target->trySpare();
-			if (spared) {
-				pushLog(actor.name + sf::String(L" 饶恕了敌人。"));
-			} else {
-				pushLog(actor.name + sf::String(L" 尝试饶恕，但敌人还没有放过你的意思。"));
-			}
+		LogEntry entry;
+		if (BattleLog::fromEvent(ev, m_resolvedCommands, entry)) {
+			m_log.push(entry);
 		}
-		break; }
-	case ActionType::Defend: {
-		// 防御：标记角色为防御状态，弹幕阶段降低伤害
-		actor.defending = true;
-		pushLog(sf::String(actor.name + sf::String(L" 防御，减少即将到来的伤害。")));
-		break; }
-	}
-}
-
-// 记录一条战斗日志：仅保留最近 4 条，便于 UI 展示
-void Battle::pushLog(const sf::String& line)
-{
-	m_log.push_back(line);
-	if (m_log.size() > 4) {
-		m_log.erase(m_log.begin());
 	}
 }
@@ -6,6 +6,9 @@
 #include "Game/GlobalContext.h"
 #include "Battle/BattleTypes.h"
 #include "Battle/Enemy.h"
+#include "Battle/TurnResolver.h"
+#include "Battle/BattleRules.h"
+#include "Battle/BattleLog.h"
 
 // 战斗核心逻辑：管理阶段、指令队列与结算
 class Battle {
@@ -24,31 +27,44 @@ public:
     void executeQueuedCommands();
     void update(float dt);
     void setBulletExtraWait(float wait) { m_bulletExtraWait = wait; }
+    // TP：全队共享的百分比，弹幕阶段擦弹获得
+    void addTP(float amount);
 
     // 查询
     BattlePhase getPhase() const { return m_phase; }
+    float getTP() const { return m_tp; }
     const std::vector<Enemy>& getEnemies() const { return m_enemies; }
     const std::vector<BattleCommand>& getCommandQueue() const { return m_commandQueue; }
     std::vector<Enemy>& enemiesMutable() { return m_enemies; }
     const std::vector<HeroRuntime>& getParty() const { return *m_party; }
     std::vector<HeroRuntime>& partyMutable() { return *m_party; }
-    const std::vector<sf::String>& getLog() const { return m_log; }
+    // 战斗日志：条目按需格式化，第 index 条（0 为最旧）
+    const BattleLog& getLog() const { return m_log; }
+    const sf::String& logLine(std::size_t index) const { return m_log.line(index, *m_party); }
+    // 最近一次 executeQueuedCommands 产生的回合事件与对应指令（事件中的指令下标指向 getResolvedCommands()）
+    const std::vector<TurnEvent>& getTurnEvents() const { return m_turnEvents; }
+    const std::vector<BattleCommand>& getResolvedCommands() const { return m_resolvedCommands; }
+    const ResolvedHeroStats& heroStats(std::size_t index) const { return m_resolver.heroStats(index); }
+    const TurnResolver& resolver() const { return m_resolver; }
     bool isVictory() const;
     bool isGameOver() const;
 
 private:
     void processQueuedCommands();
-    void applyCommand(const BattleCommand& cmd);
-    void pushLog(const sf::String& line);
+    void applyTurnEvents();
 
 private:
     BattlePhase m_phase = BattlePhase::Intro;
     float m_phaseTimer = 0.f;
     float m_actionDuration = 1.6f;
-    float m_bulletDuration = 4.f;
+    float m_bulletDuration = BattleRules::kBulletPhaseDuration;
     float m_bulletExtraWait = 0.f;
+    float m_tp = 0.f;
     std::vector<Enemy> m_enemies;
     std::vector<HeroRuntime>* m_party = nullptr; // 指向 Global::partyHeroes
     std::vector<BattleCommand> m_commandQueue;
-    std::vector<sf::String> m_log;
+    std::vector<BattleCommand> m_resolvedCommands; // 已结算的指令（与队列交换而来，供事件与日志回查）
+    TurnResolver m_resolver;              // 开战时按装备预解析的数值与治疗表
+    std::vector<TurnEvent> m_turnEvents;  // 本回合结算事件
+    BattleLog m_log;
 };
\ No newline at end of file
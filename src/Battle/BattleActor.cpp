@@ -1,4 +1,5 @@
 ﻿#include "Battle/BattleActor.h"
+#include "Game/StateTransition.h"
 #include <cmath>
 
 std::vector<sf::Texture> BattleActorVisual::loadTextures(const std::vector<std::string>& paths)
@@ -7,7 +8,7 @@ std::vector<sf::Texture> BattleActorVisual::loadTextures(const std::vector<std::
     out.reserve(paths.size());
     for (const auto& p : paths) {
         sf::Texture tex;
-        if (tex.loadFromFile(p)) {
+        if (StateTransition::loadTexture(tex, p)) {
             tex.setSmooth(false);
             out.push_back(std::move(tex));
         }
@@ -190,7 +191,7 @@ void BattleActorVisual::update(float dt)
     }
 }
 
-void BattleActorVisual::draw(sf::RenderWindow& window) const
+void BattleActorVisual::draw(sf::RenderTarget& target) const
 {
     if (!m_sprite) return;
     // 先画残影（简单做法：用当前帧贴图在历史位置绘制不同透明度）
@@ -200,12 +201,12 @@ void BattleActorVisual::draw(sf::RenderWindow& window) const
         sf::Color c = ghost.getColor();
         c.a = static_cast<std::uint8_t>(std::clamp(t.alpha, 0.f, 255.f));
         ghost.setColor(c);
-        window.draw(ghost);
+        target.draw(ghost);
     }
     // 再画本体（不透明）
     sf::Sprite cur = *m_sprite;
     sf::Color c = cur.getColor();
     c.a = 255;
     cur.setColor(c);
-    window.draw(cur);
+    target.draw(cur);
 }
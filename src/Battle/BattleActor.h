@@ -27,7 +27,7 @@ public:
     void startIdleLoop();
 
     void update(float dt);
-    void draw(sf::RenderWindow& window) const;
+    void draw(sf::RenderTarget& target) const;
 
     bool isAtTarget() const { return m_atTarget; }
 
@@ -0,0 +1,110 @@
+﻿//
+// 战斗日志（BattleLog）
+// --------------------
+// 职责：
+// - 以定长环形缓冲保存最近的结构化日志条目，写满后覆盖最旧的一条
+// - 显示时按模板把占位符替换为角色名/目标名/数值/行动名，并按槽位缓存结果
+// 关键约定：
+// - push()/clear() 只改写定长数组，不分配内存，可在行动结算路径上调用
+// - 模板占位符：%a 行动者名，%t 目标队员名，%n 数值，%s 行动名
+// - 名字保持 sf::String（UTF-32）拼接，不经过本地编码转换，中文名不会乱码
+//
+#include "Battle/BattleLog.h"
+#include "Battle/ActCatalog.h"
+#include <string>
+
+namespace {
+// 与 LogTemplate 顺序一致
+const wchar_t* const kTemplates[] = {
+	L"%a 造成 %n 伤害。",
+	L"%a 的攻击未对敌人造成影响。",
+	L"%a 使用行动：%s",
+	L"%a 使用道具，回复 %t %n HP",
+	L"%a 使用道具，但什么也没有发生。",
+	L"%a 饶恕了敌人。",
+	L"%a 尝试饶恕，但敌人还没有放过你的意思。",
+	L"%a 防御，减少即将到来的伤害。",
+};
+static_assert(sizeof(kTemplates) / sizeof(kTemplates[0]) == static_cast<std::size_t>(LogTemplate::Count), "log template table out of sync");
+
+const sf::String& heroName(const std::vector<HeroRuntime>& party, int index) {
+	static const sf::String unknown(L"???");
+	return (index >= 0 && index < static_cast<int>(party.size())) ? party[index].name : unknown;
+}
+}
+
+bool BattleLog::fromEvent(const TurnEvent& ev, const std::vector<BattleCommand>& commands, LogEntry& out)
+{
+	switch (ev.kind) {
+	case TurnEventKind::Damage:       out.id = LogTemplate::Damage; break;
+	case TurnEventKind::Immune:       out.id = LogTemplate::Immune; break;
+	case TurnEventKind::Act:          out.id = LogTemplate::Act; break;
+	case TurnEventKind::ItemUsed:     out.id = LogTemplate::ItemUsed; break;
+	case TurnEventKind::ItemNoEffect: out.id = LogTemplate::ItemNoEffect; break;
+	case TurnEventKind::Spared:       out.id = LogTemplate::Spared; break;
+	case TurnEventKind::SpareFailed:  out.id = LogTemplate::SpareFailed; break;
+	case TurnEventKind::Defend:       out.id = LogTemplate::Defend; break;
+	case TurnEventKind::Heal:         return false; // 行动附带的治疗并入行动日志
+	}
+	out.act = -1;
+	if (ev.command < commands.size() && commands[ev.command].actData.has_value()) {
+		const ActData& act = *commands[ev.command].actData;
+		// 未登记的行动（不经 BattleRules 构造）在此补登记，之后按 ID 取名
+		out.act = (act.actId >= 0) ? act.actId : ActCatalog::intern(act.name);
+	}
+	out.actor = ev.actor;
+	out.target = ev.target;
+	out.amount = ev.amount;
+	return true;
+}
+
+void BattleLog::push(const LogEntry& entry)
+{
+	m_entries[m_head] = entry;
+	m_revision[m_head] = m_nextRevision++;
+	if (m_nextRevision == 0) m_nextRevision = 1; // 0 保留给“未格式化”
+	m_head = (m_head + 1) % kCapacity;
+	if (m_count < kCapacity) ++m_count;
+}
+
+void BattleLog::clear()
+{
+	m_head = 0;
+	m_count = 0;
+}
+
+std::size_t BattleLog::slotOf(std::size_t index) const
+{
+	return (m_head + kCapacity - m_count + index) % kCapacity;
+}
+
+const LogEntry& BattleLog::entry(std::size_t index) const
+{
+	return m_entries[slotOf(index)];
+}
+
+const sf::String& BattleLog::line(std::size_t index, const std::vector<HeroRuntime>& party) const
+{
+	const std::size_t slot = slotOf(index);
+	if (m_textRevision[slot] == m_revision[slot]) return m_text[slot];
+
+	const LogEntry& e = m_entries[slot];
+	sf::String& out = m_text[slot];
+	out.clear();
+	const wchar_t* tmpl = kTemplates[static_cast<std::size_t>(e.id)];
+	for (const wchar_t* p = tmpl; *p; ++p) {
+		if (*p != L'%' || !p[1]) {
+			out += static_cast<char32_t>(*p);
+			continue;
+		}
+		switch (*++p) {
+		case L'a': out += heroName(party, e.actor); break;
+		case L't': out += heroName(party, e.target); break;
+		case L'n': out += sf::String(std::to_string(e.amount)); break;
+		case L's': out += ActCatalog::name(e.act); break;
+		default: out += static_cast<char32_t>(*p); break;
+		}
+	}
+	m_textRevision[slot] = m_revision[slot];
+	return out;
+}
@@ -0,0 +1,70 @@
+﻿/*
+战斗日志（定长环形缓冲）。
+包含：
+
+结构化日志条目（模板 ID + 行动者/目标/数值/行动 ID），不引用回合指令，跨回合显示也不会错位
+
+最多保留最近 4 条，写入不分配内存
+
+显示时才格式化，文本按条目缓存到条目被覆盖为止
+*/
+#pragma once
+#include <SFML/System/String.hpp>
+#include <array>
+#include <cstdint>
+#include <vector>
+#include "Battle/BattleTypes.h"
+#include "Battle/TurnResolver.h"
+#include "Game/GlobalContext.h"
+
+// 日志模板：文本见 BattleLog.cpp 中的模板表
+enum class LogTemplate : std::uint8_t {
+	Damage,
+	Immune,
+	Act,
+	ItemUsed,
+	ItemNoEffect,
+	Spared,
+	SpareFailed,
+	Defend,
+	Count
+};
+
+struct LogEntry {
+	LogTemplate id = LogTemplate::Damage;
+	std::int8_t actor = -1;   // 我方下标
+	std::int8_t target = -1;  // ItemUsed 时为我方下标
+	std::int32_t act = -1;    // 行动的 ActCatalog ID（Act 取行动名），-1 表示无
+	std::int32_t amount = 0;
+};
+
+class BattleLog {
+public:
+	static constexpr std::size_t kCapacity = 4;
+
+	// 回合事件转日志条目（commands 为产生事件的本回合指令，只在此时读取行动）；
+	// 不产生日志的事件（行动附带治疗）返回 false
+	static bool fromEvent(const TurnEvent& ev, const std::vector<BattleCommand>& commands, LogEntry& out);
+
+	void push(const LogEntry& entry);
+	void clear();
+	std::size_t size() const { return m_count; }
+	bool empty() const { return m_count == 0; }
+	// 0 为最旧的一条
+	const LogEntry& entry(std::size_t index) const;
+
+	// 第 index 条的显示文本：名字取自 party，行动名取自 ActCatalog；条目未变时返回缓存
+	const sf::String& line(std::size_t index, const std::vector<HeroRuntime>& party) const;
+
+private:
+	std::size_t slotOf(std::size_t index) const;
+
+	std::array<LogEntry, kCapacity> m_entries{};
+	std::array<std::uint32_t, kCapacity> m_revision{};     // 每次写入槽位时更新
+	std::size_t m_head = 0;  // 下一次写入的槽位
+	std::size_t m_count = 0;
+	std::uint32_t m_nextRevision = 1;
+
+	mutable std::array<sf::String, kCapacity> m_text;
+	mutable std::array<std::uint32_t, kCapacity> m_textRevision{}; // 缓存文本对应的条目版本，0 表示未格式化
+};
@@ -0,0 +1,286 @@
+﻿//
+// 战斗规则（BattleRules）
+// -----------------------
+// 职责：
+// - 各角色的 Act 清单（菜单与模拟共用，静态表只构造一次，行动名在构造时驻留为 ID）
+// - 战斗箱位置与心形活动范围、敌人站位
+// - 弹幕模式 A/B 的生成参数（位置、速度、贴图种类、伤害、是否群体）；多敌人时各自贡献一路弹幕
+// - 圣斗篷共享护盾的登记、回合重置与消耗
+// - 弹幕命中后的我方受伤结算（防御取开战时预解析的数值）；命中事件在碰撞内核之后单独结算
+// 关键约定：
+// - 不持有任何贴图或全局状态，随机数由调用方传入，便于在多线程模拟中复用
+// - 护盾可用时整次命中被吸收，不再计算伤害
+//
+#include "Battle/BattleRules.h"
+#include "Battle/ActCatalog.h"
+#include <algorithm>
+#include <cmath>
+
+namespace BattleRules {
+
+namespace {
+// 构造行动并驻留其名字，敌人按 ID 查转移表
+ActData makeAct(const sf::String& name, const sf::String& description, int damage, int heal, float mercyAdd)
+{
+	ActData act{ name, description, damage, heal, mercyAdd };
+	act.actId = ActCatalog::intern(name);
+	return act;
+}
+}
+
+const std::vector<HeroAct>& heroActs(const std::string& heroId)
+{
+	static const std::vector<HeroAct> kris = {
+		{ sf::String(L"注意到"), makeAct(sf::String(L"查看"), sf::String(L"你试着使用瞪眼法...\n可惜你不是拉马努金。"), 0, 0, 15.f ) },
+		{ sf::String(L"尝试计算化简"), makeAct(sf::String(L"计算"), sf::String(L"你尝试着进行计算"), 10, 0, 10.f ) },
+		{ sf::String(L"换元（不包括三角换元）"), makeAct(sf::String(L"凑微分"), sf::String(L"你进行了凑微分变形"), 6, 0, 18.f ) },
+	};
+	static const std::vector<HeroAct> susie = {
+		{ sf::String(L"给你路打油"), makeAct(sf::String(L"逃跑"), sf::String(L"Susie尝试逃跑...\nRalsei制止了她!"), 8, 0, 8.f ) },
+		{ sf::String(L"将区间拆分后积分"), makeAct(sf::String(L"拆分积分"), sf::String(L"Susie进行了拆分积分"), 14, 0, 6.f ) },
+	};
+	static const std::vector<HeroAct> ralsei = {
+		{ sf::String(L"使用三角代换求解"), makeAct(sf::String(L"三角代换"), sf::String(L"Ralsei使用了三角代换。"), 0, 0, 22.f ) },
+		{ sf::String(L"三角恒等变换"), makeAct(sf::String(L"三角恒等变换"), sf::String(L"Ralsei使用了三角恒等变换。"), 0, 0, 28.f ) },
+	};
+	static const std::vector<HeroAct> unknown = {
+		{ sf::String(L"注意到"), makeAct(sf::String(L"查看"), sf::String(L"你试着使用瞪眼法...\n可惜你不是拉马努金。"), 0, 0, 15.f ) },
+	};
+	static const std::vector<HeroAct> none = {
+		{ sf::String(L"查看敌方参数"), makeAct(sf::String(L"查看"), sf::String(L"你检查了敌方状态"), 0, 0, 15.f ) },
+	};
+	if (heroId.empty()) return none;
+	if (heroId == "kris") return kris;
+	if (heroId == "susie") return susie;
+	if (heroId == "ralsei") return ralsei;
+	return unknown;
+}
+
+sf::Vector2f battleBoxPosition(const sf::Vector2f& viewSize)
+{
+	return { viewSize.x * 0.5f - 25.f, viewSize.y * 0.50f + 15.f - 100.f };
+}
+
+// 固定 145x145，显示位置上施加少量偏移以对齐素材
+sf::FloatRect soulBounds(const sf::Vector2f& boxPosition)
+{
+	const sf::Vector2f size{ 145.f, 145.f };
+	return sf::FloatRect({ boxPosition.x - size.x * 0.5f + 28.f, boxPosition.y - size.y * 0.5f + 32.f }, size);
+}
+
+BulletPattern patternForTurn(int turn)
+{
+	return ((turn % 2) == 1) ? BulletPattern::PatternA : BulletPattern::PatternB;
+}
+
+// 一只敌人时原点与旧版固定站位一致；人数增多时先纵向排满 kMaxRows 行再向左加列，整体等比缩小以放进面板上方
+std::vector<EnemySlot> layoutEnemies(std::size_t count, const sf::Vector2f& viewSize)
+{
+	constexpr std::size_t kMaxRows = 3;
+	constexpr float kRowStride = 140.f;
+	constexpr float kColStride = 180.f;
+	constexpr float kMargin = 16.f;
+	std::vector<EnemySlot> slots;
+	if (count == 0) return slots;
+
+	const float panelTop = viewSize.y * 0.6f + 30.f;
+	const sf::Vector2f anchor{ viewSize.x - 260.f, panelTop - 220.f };
+	const std::size_t rows = std::min(count, kMaxRows);
+	const std::size_t cols = (count + rows - 1) / rows;
+	const float fitY = (panelTop - 2.f * kMargin) / (static_cast<float>(rows) * kRowStride);
+	const float fitX = (viewSize.x * 0.5f) / (static_cast<float>(cols) * kColStride);
+	const float scale = std::min({ 1.f, fitY, fitX });
+	const float rowStride = kRowStride * scale;
+	const float colStride = kColStride * scale;
+	const float maxTop = std::max(kMargin, panelTop - kMargin - static_cast<float>(rows) * rowStride);
+	const float top = std::clamp(anchor.y - static_cast<float>(rows - 1) * rowStride * 0.5f, kMargin, maxTop);
+
+	slots.reserve(count);
+	for (std::size_t i = 0; i < count; ++i) {
+		const std::size_t col = i / rows;
+		const std::size_t row = i % rows;
+		// 奇数行略向右错开，避免同列敌人上下贴成一条
+		const float stagger = (row % 2 == 1) ? 20.f * scale : 0.f;
+		slots.push_back({ { anchor.x - static_cast<float>(col) * colStride + stagger, top + static_cast<float>(row) * rowStride }, scale });
+	}
+	return slots;
+}
+
+// 每只在场敌人一路：阶段指定模式优先，否则按 (回合 + 序号) 轮换，使相邻敌人错开 A/B；
+// 生成间隔按路数放大，合并后的总生成速率与单敌人相同，弹幕池规模不随人数增长
+std::vector<EnemyAttack> attacksForTurn(const std::vector<Enemy>& enemies, int turn)
+{
+	std::vector<EnemyAttack> attacks;
+	for (std::size_t i = 0; i < enemies.size(); ++i) {
+		const Enemy& e = enemies[i];
+		if (e.isDefeated() || e.isSpared()) continue;
+		EnemyAttack a;
+		a.enemy = static_cast<int>(i);
+		a.pattern = e.stagePattern().value_or(patternForTurn(turn + static_cast<int>(i)));
+		attacks.push_back(a);
+	}
+	const float streams = static_cast<float>(std::max<std::size_t>(1, attacks.size()));
+	for (auto& a : attacks) a.interval = spawnInterval(a.pattern) * streams;
+	return attacks;
+}
+
+float spawnInterval(BulletPattern pattern)
+{
+	return (pattern == BulletPattern::PatternA) ? 0.5f : 0.3f;
+}
+
+const char* bulletSpritePath(std::uint8_t kind)
+{
+	return (kind == kBulletDiamond) ? "assets/sprite/Bullet/spr_diamondbullet.png" : "assets/sprite/Bullet/spr_clubsball_a.png";
+}
+
+// 模式 A：在心形周围随机角度 150px 处生成，朝心形方向匀速推进；伤害偏高
+BulletSpawn spawnPatternA(const sf::Vector2f& heart, std::mt19937& rng)
+{
+	std::uniform_real_distribution<float> angleDist(0.f, 6.2831853f);
+	const float ang = angleDist(rng);
+	const sf::Vector2f dir{ std::cos(ang), std::sin(ang) };
+	BulletSpawn s;
+	s.position = { heart.x + dir.x * 150.f, heart.y + dir.y * 150.f };
+	sf::Vector2f toHeart{ heart.x - s.position.x, heart.y - s.position.y };
+	float len = std::sqrt(toHeart.x * toHeart.x + toHeart.y * toHeart.y);
+	if (len < 1e-3f) len = 1.f;
+	const float speed = 192.f; // 20% slower
+	s.velocity = { toHeart.x / len * speed, toHeart.y / len * speed };
+	s.damage = 15;
+	return s;
+}
+
+// 模式 B：在盒子上边界随机 X 生成，竖直下落；群体伤害，更容易触发共享护盾
+BulletSpawn spawnPatternB(const sf::FloatRect& box, std::mt19937& rng)
+{
+	std::uniform_real_distribution<float> xDist(box.position.x, box.position.x + box.size.x);
+	BulletSpawn s;
+	s.position = { xDist(rng), box.position.y - 8.f };
+	s.velocity = { 0.f, 260.f };
+	s.kind = kBulletDiamond;
+	s.rotation = 90.f;
+	s.damage = 10;
+	s.hitsAll = true;
+	return s;
+}
+
+bool HolyShield::wearsMantle(const HeroRuntime& hero)
+{
+	for (const auto& armor : hero.armorID) {
+		if (armor == "holy_mantle" || armor == "HolyMantle") return true;
+	}
+	return false;
+}
+
+void HolyShield::init(const std::vector<HeroRuntime>& party)
+{
+	hasMantle.assign(party.size(), false);
+	ready.assign(party.size(), false);
+	sharedReady = false;
+	for (std::size_t i = 0; i < party.size(); ++i) {
+		hasMantle[i] = wearsMantle(party[i]);
+		ready[i] = hasMantle[i];
+		sharedReady = sharedReady || hasMantle[i];
+	}
+}
+
+void HolyShield::resetForTurn(const std::vector<HeroRuntime>& party)
+{
+	const std::size_t n = party.size();
+	ready.resize(n, false);
+	sharedReady = false;
+	for (std::size_t i = 0; i < n; ++i) {
+		const bool has = (i < hasMantle.size()) ? hasMantle[i] : false;
+		ready[i] = has && party[i].hp > 0;
+		sharedReady = sharedReady || ready[i];
+	}
+}
+
+bool HolyShield::mantleAlive(const std::vector<HeroRuntime>& party) const
+{
+	const std::size_t n = std::min(party.size(), hasMantle.size());
+	for (std::size_t i = 0; i < n; ++i) {
+		if (hasMantle[i] && party[i].hp > 0) return true;
+	}
+	return false;
+}
+
+bool HolyShield::anyReady() const
+{
+	return sharedReady && std::any_of(ready.begin(), ready.end(), [](bool v) { return v; });
+}
+
+void HolyShield::consume()
+{
+	sharedReady = false;
+	std::fill(ready.begin(), ready.end(), false);
+}
+
+namespace {
+// 对单个角色结算：返回实际扣除的 HP
+int hurtHero(HeroRuntime& hero, int dmg, int defense)
+{
+	int realDmg = std::max(0, dmg - defense);
+	if (hero.defending) {
+		realDmg = (realDmg + 1) / 2; // 50% 减伤，向上取整
+	}
+	if (realDmg <= 0) return 0;
+	const int before = hero.hp;
+	hero.hp = std::max(0, hero.hp - realDmg);
+	return before - hero.hp;
+}
+}
+
+DamageResult applyDamageRandomHero(int dmg, std::vector<HeroRuntime>& party, const TurnResolver& stats, HolyShield& shield, std::mt19937& rng)
+{
+	DamageResult res{};
+	if (party.empty()) return res;
+	if (shield.sharedReady && shield.mantleAlive(party)) {
+		shield.consume();
+		res.shieldTriggered = true;
+		return res;
+	}
+	std::vector<int> alive;
+	alive.reserve(party.size());
+	for (int i = 0; i < static_cast<int>(party.size()); ++i) {
+		if (party[i].hp > 0) alive.push_back(i);
+	}
+	if (alive.empty()) return res;
+	std::uniform_int_distribution<int> idxDist(0, static_cast<int>(alive.size()) - 1);
+	const int chosen = alive[static_cast<std::size_t>(idxDist(rng))];
+	res.totalDamage = hurtHero(party[chosen], dmg, stats.heroStats(static_cast<std::size_t>(chosen)).defense);
+	res.damageApplied = res.totalDamage > 0;
+	return res;
+}
+
+DamageResult applyDamageAllHeroes(int dmg, std::vector<HeroRuntime>& party, const TurnResolver& stats, HolyShield& shield)
+{
+	DamageResult res{};
+	if (shield.sharedReady && shield.mantleAlive(party)) {
+		shield.consume();
+		res.shieldTriggered = true;
+		return res;
+	}
+	for (std::size_t i = 0; i < party.size(); ++i) {
+		if (party[i].hp <= 0) continue;
+		res.totalDamage += hurtHero(party[i], dmg, stats.heroStats(i).defense);
+	}
+	res.damageApplied = res.totalDamage > 0;
+	return res;
+}
+
+HitResolution resolveHits(const std::vector<BulletHit>& hits, bool invincible, std::vector<HeroRuntime>& party,
+	const TurnResolver& stats, HolyShield& shield, std::mt19937& rng)
+{
+	HitResolution res;
+	if (hits.empty() || invincible) return res;
+	const BulletHit& first = hits.front();
+	res.resolved = true;
+	res.damage = first.hitsAll
+		? applyDamageAllHeroes(first.damage, party, stats, shield)
+		: applyDamageRandomHero(first.damage, party, stats, shield, rng);
+	return res;
+}
+
+}
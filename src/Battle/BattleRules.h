@@ -0,0 +1,128 @@
+﻿/*
+战斗规则（弹幕生成与受伤结算）。
+包含：
+
+弹幕阶段时长、命中无敌时间等公共常量
+
+擦弹半径、TP 奖励与擦弹网格格子大小
+
+各角色可用的 Act 清单
+
+敌人站位
+
+弹幕模式 A/B 的生成参数，多敌人时每只各贡献一路
+
+弹幕贴图种类与贴图路径（绘制与碰撞掩码共用）
+
+圣斗篷共享护盾与我方受伤结算
+
+BattleState 与离线平衡模拟共用同一份实现，保证两边数值一致
+*/
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+#include "Game/GlobalContext.h"
+#include "Battle/BattleTypes.h"
+#include "Battle/TurnResolver.h"
+
+namespace BattleRules {
+
+constexpr float kBulletPhaseDuration = 4.f; // Battle 内置的弹幕阶段时长
+constexpr float kBulletExtraWait = 5.f;     // 每回合弹幕阶段额外追加的时长
+constexpr float kHitInvincibility = 0.5f;   // 心形被命中后的无敌时间
+constexpr float kHitPause = 0.06f;          // 结算一次命中后弹幕停顿的时长（生成与移动都暂停）
+
+constexpr float kMaxTP = 100.f;             // TP 为全队共享的百分比
+constexpr float kGrazeRadius = 12.f;        // 弹幕判定框与心形判定框的间距不超过该值即擦弹
+constexpr float kGrazeTP = 2.f;             // 每颗弹幕首次擦弹获得的 TP
+constexpr float kGrazeCellSize = 32.f;      // 擦弹网格（覆盖战斗箱）的格子边长
+
+// 角色可用的 Act：hint 为菜单中的说明，data 为结算数据（heroId 为小写 ID，未登记时回退到“查看”）
+struct HeroAct {
+	sf::String hint;
+	ActData data;
+};
+const std::vector<HeroAct>& heroActs(const std::string& heroId);
+
+// 战斗箱：显示位置由视图尺寸决定，心形移动/碰撞范围为其中固定大小的矩形
+sf::Vector2f battleBoxPosition(const sf::Vector2f& viewSize);
+sf::FloatRect soulBounds(const sf::Vector2f& boxPosition);
+
+// 敌人站位：贴图/占位框原点与统一缩放（人数多时缩小），位于右侧、底部面板上方
+struct EnemySlot {
+	sf::Vector2f position;
+	float scale = 1.f;
+};
+std::vector<EnemySlot> layoutEnemies(std::size_t count, const sf::Vector2f& viewSize);
+
+// 默认弹幕轮换：奇数回合 A（追踪心形），偶数回合 B（从盒子顶部落下的群体伤害）
+BulletPattern patternForTurn(int turn);
+float spawnInterval(BulletPattern pattern);
+
+// 本回合每只在场敌人贡献的一路弹幕；各路独立计时，生成的弹幕进入同一个池
+struct EnemyAttack {
+	int enemy = -1;
+	BulletPattern pattern = BulletPattern::PatternA;
+	float interval = 0.f; // 已按路数放大的生成间隔
+	float timer = 0.f;
+};
+std::vector<EnemyAttack> attacksForTurn(const std::vector<Enemy>& enemies, int turn);
+
+// 弹幕贴图种类：BulletPool 按种类分批绘制，并按种类选用由贴图 alpha 生成的碰撞掩码
+constexpr std::uint8_t kBulletClubs = 0;   // spr_clubsball_a（模式 A）
+constexpr std::uint8_t kBulletDiamond = 1; // spr_diamondbullet（模式 B）
+constexpr std::uint8_t kBulletKindCount = 2;
+const char* bulletSpritePath(std::uint8_t kind);
+
+// 一颗弹幕的生成参数（只记贴图种类，BattleState 与模拟据此写入 BulletPool）
+struct BulletSpawn {
+	sf::Vector2f position;
+	sf::Vector2f velocity;
+	std::uint8_t kind = kBulletClubs;
+	float rotation = 0.f;
+	int damage = 0;
+	bool hitsAll = false;
+};
+BulletSpawn spawnPatternA(const sf::Vector2f& heart, std::mt19937& rng);
+BulletSpawn spawnPatternB(const sf::FloatRect& box, std::mt19937& rng);
+
+// 圣斗篷：每回合一次的共享护盾，队伍中有佩戴且存活的角色时吸收本回合第一次命中
+struct HolyShield {
+	std::vector<bool> hasMantle;
+	std::vector<bool> ready;
+	bool sharedReady = false;
+
+	static bool wearsMantle(const HeroRuntime& hero);
+	// 开战时按装备登记（佩戴者首回合直接就绪）
+	void init(const std::vector<HeroRuntime>& party);
+	// 新回合：存活的佩戴者重新就绪
+	void resetForTurn(const std::vector<HeroRuntime>& party);
+	bool mantleAlive(const std::vector<HeroRuntime>& party) const;
+	bool anyReady() const;
+	void consume();
+};
+
+struct DamageResult {
+	bool shieldTriggered = false;
+	bool damageApplied = false;
+	int totalDamage = 0; // 本次实际扣除的 HP 总和
+};
+
+// 单体伤害：随机选一名存活角色；伤害 = max(0, dmg - 防御)，防御中减半（向上取整）
+DamageResult applyDamageRandomHero(int dmg, std::vector<HeroRuntime>& party, const TurnResolver& stats, HolyShield& shield, std::mt19937& rng);
+// 群体伤害：所有存活角色各自按防御与防御状态结算
+DamageResult applyDamageAllHeroes(int dmg, std::vector<HeroRuntime>& party, const TurnResolver& stats, HolyShield& shield);
+
+// 一帧命中事件的结算：无敌窗口内全部忽略；窗口外只结算生成最早的一颗，同帧其余命中并入这次受击
+// resolved 为真时调用方开启无敌与停顿，并按 damage 中的标志各播放一次音效
+struct HitResolution {
+	bool resolved = false;
+	DamageResult damage;
+};
+HitResolution resolveHits(const std::vector<BulletHit>& hits, bool invincible, std::vector<HeroRuntime>& party,
+	const TurnResolver& stats, HolyShield& shield, std::mt19937& rng);
+
+}
@@ -0,0 +1,404 @@
+﻿//
+// 离线战斗模拟（BattleSimulator）
+// -------------------------------
+// 职责：
+// - 以 TurnResolver 结算指令、以 BattleRules 生成弹幕与结算受伤，完整复现一场战斗的回合循环
+// - 菜单 AI：低血量优先喝饮品；可饶恕时饶恕；按概率在临时副本上试出能推进解题的 Act
+// - 心形 AI：按固定间隔决策，远离预测位置附近的弹幕并避开盒子边缘，按概率失误
+// - 多线程：在任务系统上按块 parallelFor 战斗序号，结果写回各自下标，最后统一汇总
+// 关键约定：
+// - 不创建窗口、不创建贴图、不读写 Global::*；只读访问 Database（需先 init）；
+//   弹幕碰撞掩码与 BattleState 相同（经 CollisionMask 缓存读取贴图 alpha，读取失败时回退到方形判定框）
+// - 第 i 场的随机数由 (seed, i) 派生，同一配置的结果与线程数、调度顺序无关
+// - 心形判定框与 Soul 一致，弹幕与 BattleState 共用 BulletPool 内核与命中结算，视图按 640x480 计算
+//
+#include "Battle/BattleSimulator.h"
+#include "Battle/BattleRules.h"
+#include "Battle/BulletPool.h"
+#include "Battle/BulletGrid.h"
+#include "Battle/TurnResolver.h"
+#include "Game/Database.h"
+#include "Utils/JobSystem.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <random>
+
+namespace {
+const sf::Vector2f kViewSize{ 640.f, 480.f };
+const sf::Vector2f kSoulStart{ 320.f, 180.f };     // 战斗箱入场完成时心形的中心
+constexpr float kSoulSpeed = 160.f;
+constexpr float kSoulSprite = 16.f * 1.3f;         // 心形贴图 16px，放大 1.3 倍
+constexpr float kSoulHitbox = kSoulSprite * 0.7f - 2.f;               // Soul::getBounds
+constexpr float kSoulClampHalf = kSoulSprite * 0.7f * 0.5f - 1.f;     // Soul::handleInput 的夹取半径
+constexpr std::size_t kChunk = 16;                 // 每个任务模拟的战斗数
+const char* const kHealItem = "luojia_drink";
+
+std::vector<HeroRuntime> makeParty(int mantleWearer) {
+	std::vector<HeroRuntime> party;
+	for (const char* id : { "kris", "susie", "ralsei" }) {
+		auto it = Database::heroes.find(id);
+		if (it == Database::heroes.end()) continue;
+		const Hero& h = it->second;
+		HeroRuntime rt;
+		rt.id = h.id;
+		rt.name = h.name;
+		rt.maxHP = h.maxHP;
+		rt.hp = h.maxHP;
+		rt.baseAttack = h.baseAttack;
+		rt.baseDefense = h.baseDefense;
+		rt.baseMagic = h.baseMagic;
+		rt.weaponID = h.weaponID;
+		rt.armorID[0] = h.armorID[0];
+		rt.armorID[1] = h.armorID[1];
+		party.push_back(std::move(rt));
+	}
+	if (mantleWearer >= 0 && mantleWearer < static_cast<int>(party.size())) {
+		party[mantleWearer].armorID[1] = "holy_mantle";
+	}
+	return party;
+}
+
+bool chance(std::mt19937& rng, float p) {
+	return std::uniform_real_distribution<float>(0.f, 1.f)(rng) < p;
+}
+
+bool allDown(const std::vector<HeroRuntime>& party) {
+	return std::all_of(party.begin(), party.end(), [](const HeroRuntime& h) { return h.hp <= 0; });
+}
+
+bool allResolved(const std::vector<Enemy>& enemies) {
+	return std::all_of(enemies.begin(), enemies.end(), [](const Enemy& e) { return e.isDefeated() || e.isSpared(); });
+}
+
+// 在敌人副本上试用 Act：阶段推进、或仁慈值/伤害有增长即视为有效
+bool actProgresses(const Enemy& enemy, const ActData& act) {
+	Enemy probe = enemy;
+	if (!probe.onAct(act)) return act.damage > 0 || act.mercyAdd > 0.f;
+	return probe.getStage() != enemy.getStage() || probe.getMercy() > enemy.getMercy();
+}
+
+// 菜单 AI：按队伍顺序逐个决定指令，每条指令先在临时副本上结算，后续角色据此决策
+std::vector<BattleCommand> chooseCommands(const std::vector<HeroRuntime>& party, const std::vector<Enemy>& enemies,
+	const TurnResolver& resolver, int drinks, const MenuPolicy& policy, std::mt19937& rng)
+{
+	std::vector<BattleCommand> commands;
+	std::vector<HeroRuntime> scratchParty = party;
+	std::vector<Enemy> scratchEnemies = enemies;
+	std::vector<BattleCommand> single(1);
+	std::vector<TurnEvent> scratchEvents;
+	bool healQueued = false;
+
+	for (int i = 0; i < static_cast<int>(party.size()); ++i) {
+		int target = 0;
+		for (int e = 0; e < static_cast<int>(scratchEnemies.size()); ++e) {
+			if (!scratchEnemies[e].isDefeated() && !scratchEnemies[e].isSpared()) { target = e; break; }
+		}
+		BattleCommand cmd{ i, target, ActionType::Fight, std::nullopt, std::nullopt };
+
+		int lowest = -1;
+		float lowestRatio = 1.f;
+		for (int h = 0; h < static_cast<int>(scratchParty.size()); ++h) {
+			const auto& hero = scratchParty[h];
+			if (hero.hp <= 0 || hero.maxHP <= 0) continue;
+			const float ratio = static_cast<float>(hero.hp) / static_cast<float>(hero.maxHP);
+			if (ratio < lowestRatio) { lowestRatio = ratio; lowest = h; }
+		}
+
+		const auto& acts = BattleRules::heroActs(party[i].id);
+		const Enemy* enemy = scratchEnemies.empty() ? nullptr : &scratchEnemies[target];
+		if (!healQueued && drinks > 0 && lowest >= 0 && lowestRatio < policy.healBelow) {
+			cmd.type = ActionType::Item;
+			cmd.targetIndex = lowest;
+			cmd.itemID = std::string(kHealItem);
+			healQueued = true;
+		} else if (enemy && enemy->isSpareable()) {
+			cmd.type = ActionType::Spare;
+		} else {
+			const ActData* solving = nullptr;
+			if (enemy && chance(rng, policy.solveChance)) {
+				for (const auto& act : acts) {
+					if (actProgresses(*enemy, act.data)) { solving = &act.data; break; }
+				}
+			}
+			if (solving) {
+				cmd.type = ActionType::Act;
+				cmd.actData = *solving;
+			} else if (chance(rng, policy.defendChance)) {
+				cmd.type = ActionType::Defend;
+			} else if (!acts.empty() && chance(rng, 0.5f)) {
+				std::uniform_int_distribution<std::size_t> pick(0, acts.size() - 1);
+				cmd.type = ActionType::Act;
+				cmd.actData = acts[pick(rng)].data;
+			}
+		}
+
+		single[0] = cmd;
+		scratchEvents.clear();
+		resolver.resolve(single, scratchParty, scratchEnemies, scratchEvents);
+		commands.push_back(std::move(cmd));
+	}
+	return commands;
+}
+
+// 心形 AI：远离预测位置在危险半径内的弹幕（按距离平方反比加权），贴近盒壁时向内推
+sf::Vector2f chooseDodge(const sf::Vector2f& soul, const sf::FloatRect& box, const BulletPool& bullets,
+	const DodgerPolicy& policy, std::mt19937& rng)
+{
+	if (!chance(rng, policy.skill)) {
+		std::uniform_int_distribution<int> dirDist(-1, 1);
+		return { static_cast<float>(dirDist(rng)), static_cast<float>(dirDist(rng)) };
+	}
+	sf::Vector2f push{ 0.f, 0.f };
+	const float r2 = policy.dangerRadius * policy.dangerRadius;
+	for (std::size_t i = 0; i < bullets.size(); ++i) {
+		const sf::Vector2f predicted = bullets.position(i) + bullets.velocity(i) * policy.lookahead;
+		const sf::Vector2f d = soul - predicted;
+		const float dist2 = d.x * d.x + d.y * d.y;
+		if (dist2 >= r2) continue;
+		push += d / std::max(dist2, 1.f);
+	}
+	const float wall = 14.f;
+	const float weight = 1.f / (wall * wall);
+	if (soul.x - box.position.x < wall) push.x += weight;
+	if (box.position.x + box.size.x - soul.x < wall) push.x -= weight;
+	if (soul.y - box.position.y < wall) push.y += weight;
+	if (box.position.y + box.size.y - soul.y < wall) push.y -= weight;
+	if (push.x * push.x + push.y * push.y < 1e-8f) return { 0.f, 0.f };
+	return push;
+}
+
+struct BulletPhaseResult {
+	int damage = 0;
+	int hits = 0;
+	int shieldTriggers = 0;
+	int grazes = 0;
+};
+
+BulletPhaseResult simulateBulletPhase(int turn, const std::vector<Enemy>& enemies, std::vector<HeroRuntime>& party, const TurnResolver& resolver,
+	BattleRules::HolyShield& shield, const SimulationConfig& config, std::mt19937& rng)
+{
+	BulletPhaseResult res;
+	std::vector<BattleRules::EnemyAttack> attacks = BattleRules::attacksForTurn(enemies, turn);
+	const sf::FloatRect box = BattleRules::soulBounds(BattleRules::battleBoxPosition(kViewSize));
+	const sf::FloatRect view({ 0.f, 0.f }, kViewSize);
+	const float duration = BattleRules::kBulletPhaseDuration + BattleRules::kBulletExtraWait;
+	const float dt = config.timeStep;
+
+	BulletPool bullets;
+	BulletGrid grid;
+	std::vector<BulletHit> hits;
+	std::vector<std::uint32_t> grazed;
+	bullets.loadSpriteMasks();
+	bullets.setGrazeArea(box, config.grazeRadius);
+	sf::Vector2f soul = kSoulStart;
+	sf::Vector2f moveDir{ 0.f, 0.f };
+	float decisionTimer = 0.f;
+	float invincible = 0.f;
+	float hitPause = 0.f;
+
+	for (float t = 0.f; t < duration; t += dt) {
+		// 心形：按反应间隔重新决策方向，移动后夹在盒内
+		decisionTimer -= dt;
+		if (decisionTimer <= 0.f) {
+			moveDir = chooseDodge(soul, box, bullets, config.dodger, rng);
+			const float len = std::sqrt(moveDir.x * moveDir.x + moveDir.y * moveDir.y);
+			if (len > 0.001f) moveDir /= len;
+			decisionTimer += config.dodger.reactionTime;
+		}
+		soul += moveDir * (kSoulSpeed * dt);
+		soul.x = std::clamp(soul.x, box.position.x + kSoulClampHalf, box.position.x + box.size.x - kSoulClampHalf);
+		soul.y = std::clamp(soul.y, box.position.y + kSoulClampHalf, box.position.y + box.size.y - kSoulClampHalf);
+		invincible = std::max(0.f, invincible - dt);
+		if (hitPause > 0.f) {
+			hitPause = std::max(0.f, hitPause - dt);
+			continue;
+		}
+
+		for (auto& attack : attacks) {
+			attack.timer += dt;
+			while (attack.timer >= attack.interval) {
+				attack.timer -= attack.interval;
+				const BattleRules::BulletSpawn s = (attack.pattern == BulletPattern::PatternA)
+					? BattleRules::spawnPatternA(soul, rng)
+					: BattleRules::spawnPatternB(box, rng);
+				bullets.spawn(s);
+			}
+		}
+
+		const float half = kSoulHitbox * 0.5f;
+		const sf::FloatRect soulRect({ soul.x - half, soul.y - half }, { kSoulHitbox, kSoulHitbox });
+		hits.clear();
+		bullets.step(dt, soulRect, view, hits);
+		const BattleRules::HitResolution hit = BattleRules::resolveHits(hits, invincible > 0.f, party, resolver, shield, rng);
+		bullets.compact();
+		if (hit.resolved) {
+			++res.hits;
+			res.damage += hit.damage.totalDamage;
+			if (hit.damage.shieldTriggered) ++res.shieldTriggers;
+			invincible = BattleRules::kHitInvincibility;
+			hitPause = BattleRules::kHitPause;
+		}
+		// 擦弹：与 BattleState::updateGraze 相同，无敌期间不计
+		if (invincible <= 0.f && !bullets.empty()) {
+			grid.rebuild(bullets, BattleRules::kGrazeCellSize);
+			grazed.clear();
+			bullets.collectGrazes(grid, soulRect, config.grazeRadius, grazed);
+			res.grazes += static_cast<int>(grazed.size());
+		}
+
+		if (allDown(party)) break;
+	}
+	return res;
+}
+
+// 按升序样本取分位数
+template <typename T>
+T percentile(const std::vector<T>& sorted, float p) {
+	if (sorted.empty()) return T{};
+	const std::size_t idx = static_cast<std::size_t>(p * static_cast<float>(sorted.size() - 1) + 0.5f);
+	return sorted[std::min(idx, sorted.size() - 1)];
+}
+
+template <typename T>
+double mean(const std::vector<T>& values) {
+	if (values.empty()) return 0.0;
+	double sum = 0.0;
+	for (const auto& v : values) sum += static_cast<double>(v);
+	return sum / static_cast<double>(values.size());
+}
+}
+
+BattleSimulator::BattleSimulator(SimulationConfig config)
+	: m_config(std::move(config))
+{
+}
+
+BattleOutcome BattleSimulator::simulateOne(const std::vector<Enemy>& encounter, std::uint32_t index) const
+{
+	std::seed_seq seq{ m_config.seed, index };
+	std::mt19937 rng(seq);
+
+	BattleOutcome out;
+	std::vector<HeroRuntime> party = makeParty(m_config.mantleWearer);
+	std::vector<Enemy> enemies = encounter;
+	TurnResolver resolver;
+	resolver.prepare(party);
+	BattleRules::HolyShield shield;
+	shield.init(party);
+	int drinks = m_config.menu.startingDrinks;
+	std::vector<TurnEvent> events;
+
+	for (int turn = 1; turn <= m_config.maxTurns; ++turn) {
+		out.turns = turn;
+		for (auto& h : party) h.defending = false;
+		shield.resetForTurn(party);
+		if (shield.anyReady()) ++out.shieldTurns;
+
+		const std::vector<BattleCommand> commands = chooseCommands(party, enemies, resolver, drinks, m_config.menu, rng);
+		events.clear();
+		resolver.resolve(commands, party, enemies, events);
+		for (const auto& ev : events) {
+			if (ev.kind == TurnEventKind::ItemUsed) --drinks;
+		}
+		if (allResolved(enemies)) {
+			out.won = true;
+			break;
+		}
+
+		const BulletPhaseResult phase = simulateBulletPhase(turn, enemies, party, resolver, shield, m_config, rng);
+		out.damageTaken += phase.damage;
+		out.hits += phase.hits;
+		out.shieldTriggers += phase.shieldTriggers;
+		out.grazes += phase.grazes;
+		out.tp = std::min(BattleRules::kMaxTP, out.tp + BattleRules::kGrazeTP * static_cast<float>(phase.grazes));
+		if (allDown(party)) break;
+	}
+	out.timedOut = !out.won && !allDown(party);
+	out.knockouts = static_cast<int>(std::count_if(party.begin(), party.end(), [](const HeroRuntime& h) { return h.hp <= 0; }));
+	return out;
+}
+
+SimulationReport BattleSimulator::run(const std::vector<Enemy>& encounter) const
+{
+	SimulationReport report;
+	report.config = m_config;
+	const std::uint32_t total = static_cast<std::uint32_t>(std::max(0, m_config.battles));
+	report.outcomes.resize(total);
+
+	// 默认共用全局任务系统；指定线程数（或块数不足以用满）时临时建一个对应规模的任务系统
+	JobSystem& global = JobSystem::getInstance();
+	const int globalThreads = static_cast<int>(global.workerCount()) + 1;
+	int threads = m_config.threads > 0 ? m_config.threads : globalThreads;
+	threads = std::clamp(threads, 1, static_cast<int>(std::max<std::size_t>(1, (total + kChunk - 1) / kChunk)));
+	report.threadsUsed = threads;
+	std::unique_ptr<JobSystem> local;
+	if (threads != globalThreads) local = std::make_unique<JobSystem>(static_cast<unsigned>(threads - 1));
+	JobSystem& jobs = local ? *local : global;
+
+	const auto start = std::chrono::steady_clock::now();
+	jobs.parallelFor(total, kChunk, [&](std::size_t begin, std::size_t end) {
+		for (std::size_t i = begin; i < end; ++i) {
+			report.outcomes[i] = simulateOne(encounter, static_cast<std::uint32_t>(i));
+		}
+	});
+	report.elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	return report;
+}
+
+std::string SimulationReport::format() const
+{
+	const std::size_t n = outcomes.size();
+	int wins = 0, timeouts = 0, shieldTurns = 0, shieldTriggers = 0, hits = 0, grazes = 0;
+	std::vector<int> turnsToWin;
+	std::vector<int> damage;
+	std::vector<int> knockouts;
+	std::vector<float> tp;
+	damage.reserve(n);
+	tp.reserve(n);
+	for (const auto& o : outcomes) {
+		if (o.won) { ++wins; turnsToWin.push_back(o.turns); }
+		if (o.timedOut) ++timeouts;
+		shieldTurns += o.shieldTurns;
+		shieldTriggers += o.shieldTriggers;
+		hits += o.hits;
+		grazes += o.grazes;
+		tp.push_back(o.tp);
+		damage.push_back(o.damageTaken);
+		knockouts.push_back(o.knockouts);
+	}
+	std::sort(turnsToWin.begin(), turnsToWin.end());
+	std::sort(damage.begin(), damage.end());
+
+	auto ratio = [](double a, double b) { return b > 0.0 ? a / b : 0.0; };
+	char buf[1024];
+	std::string s;
+	std::snprintf(buf, sizeof(buf), "Battle simulation: %zu battles, seed %u, %d threads, %.2fs (%.0f battles/s)\n",
+		n, config.seed, threadsUsed, elapsedSeconds, ratio(static_cast<double>(n), elapsedSeconds));
+	s += buf;
+	std::snprintf(buf, sizeof(buf), "  policy: solve %.2f defend %.2f healBelow %.2f drinks %d | dodger skill %.2f reaction %.2fs\n",
+		config.menu.solveChance, config.menu.defendChance, config.menu.healBelow, config.menu.startingDrinks,
+		config.dodger.skill, config.dodger.reactionTime);
+	s += buf;
+	std::snprintf(buf, sizeof(buf), "  win rate      %.1f%%  (losses %.1f%%, timeouts %.1f%%)\n",
+		100.0 * ratio(wins, static_cast<double>(n)),
+		100.0 * ratio(static_cast<double>(n) - wins - timeouts, static_cast<double>(n)),
+		100.0 * ratio(timeouts, static_cast<double>(n)));
+	s += buf;
+	std::snprintf(buf, sizeof(buf), "  turns to win  mean %.2f  p50 %d  p90 %d  max %d\n",
+		mean(turnsToWin), percentile(turnsToWin, 0.5f), percentile(turnsToWin, 0.9f), turnsToWin.empty() ? 0 : turnsToWin.back());
+	s += buf;
+	std::snprintf(buf, sizeof(buf), "  damage taken  mean %.1f  p10 %d  p50 %d  p90 %d  max %d  (hits/battle %.2f, KOs/battle %.2f)\n",
+		mean(damage), percentile(damage, 0.1f), percentile(damage, 0.5f), percentile(damage, 0.9f), damage.empty() ? 0 : damage.back(),
+		ratio(hits, static_cast<double>(n)), mean(knockouts));
+	s += buf;
+	std::snprintf(buf, sizeof(buf), "  holy shield   triggered on %.1f%% of ready turns, absorbed %.1f%% of hits\n",
+		100.0 * ratio(shieldTriggers, shieldTurns), 100.0 * ratio(shieldTriggers, hits));
+	s += buf;
+	std::snprintf(buf, sizeof(buf), "  graze         %.2f/battle (radius %.0f), final TP mean %.1f%%\n",
+		ratio(grazes, static_cast<double>(n)), config.grazeRadius, mean(tp));
+	s += buf;
+	return s;
+}
@@ -0,0 +1,81 @@
+﻿/*
+离线战斗平衡模拟器（无窗口）。
+包含：
+
+按种子批量模拟整场战斗（菜单 AI 策略 + 自动躲弹幕的心形）
+
+多线程分摊，每场战斗使用独立的随机数，结果与线程数无关
+
+统计胜率、取胜回合数、受伤分布、护盾触发率与擦弹获得的 TP
+*/
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Battle/Enemy.h"
+#include "Battle/BattleRules.h"
+
+// 菜单 AI 策略参数
+struct MenuPolicy {
+	float solveChance = 0.8f;  // 每名角色选择“推进解题”的 Act 的概率（否则随机行动）
+	float defendChance = 0.2f; // 未推进解题时选择防御的概率（其余为攻击或随机 Act）
+	float healBelow = 0.35f;   // 有队员 HP 比例低于此值且持有治疗物品时优先使用
+	int startingDrinks = 2;    // 开战时背包中的珞珈饮品数量
+};
+
+// 自动躲弹幕参数
+struct DodgerPolicy {
+	float skill = 0.75f;        // 每次决策采用“躲避方向”的概率（否则随机乱走）
+	float reactionTime = 0.08f; // 两次决策之间的间隔（秒）
+	float dangerRadius = 48.f;  // 只考虑该距离内的弹幕
+	float lookahead = 0.15f;    // 按弹幕速度预测该时长后的位置
+};
+
+struct SimulationConfig {
+	int battles = 1000;
+	std::uint32_t seed = 1;
+	int threads = 0;      // 0 表示共用全局任务系统（全部硬件线程）
+	int maxTurns = 30;    // 超过视为未分胜负
+	int mantleWearer = -1; // 第二护甲位换上神圣斗篷的队员下标，-1 表示不佩戴
+	float timeStep = 1.f / 60.f;
+	float grazeRadius = BattleRules::kGrazeRadius;
+	MenuPolicy menu;
+	DodgerPolicy dodger;
+};
+
+// 单场战斗结果
+struct BattleOutcome {
+	bool won = false;
+	bool timedOut = false;
+	int turns = 0;
+	int damageTaken = 0;    // 全队累计实际扣除的 HP
+	int hits = 0;           // 心形被命中次数（含被护盾吸收的）
+	int shieldTriggers = 0;
+	int shieldTurns = 0;    // 回合开始时护盾就绪的回合数
+	int grazes = 0;         // 擦弹次数（每颗弹幕至多一次）
+	float tp = 0.f;         // 战斗结束时的 TP（本模拟不消耗 TP）
+	int knockouts = 0;      // 战斗结束时 HP 为 0 的队员数
+};
+
+struct SimulationReport {
+	SimulationConfig config;
+	std::vector<BattleOutcome> outcomes;
+	double elapsedSeconds = 0.0;
+	int threadsUsed = 0;
+
+	std::string format() const;
+};
+
+class BattleSimulator {
+public:
+	explicit BattleSimulator(SimulationConfig config);
+
+	// 需在 Database::init 之后调用；encounter 为每场战斗的初始敌人（逐场复制）
+	SimulationReport run(const std::vector<Enemy>& encounter) const;
+
+	// 模拟单场（第 index 场的随机种子由 config.seed 与 index 派生）
+	BattleOutcome simulateOne(const std::vector<Enemy>& encounter, std::uint32_t index) const;
+
+private:
+	SimulationConfig m_config;
+};
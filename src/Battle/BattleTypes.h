@@ -1,5 +1,6 @@
 ﻿#pragma once
 #include <SFML/Graphics.hpp>
+#include <cstdint>
 #include <optional>
 #include <string>
 
@@ -23,6 +24,19 @@ enum class ActionType {
     Defend      // 防御
 };
 
+// 弹幕模式：A 追踪心形，B 从盒子顶部落下（群体伤害）
+enum class BulletPattern {
+    PatternA,
+    PatternB
+};
+
+// 弹幕命中心形的事件：由碰撞内核产生，结算在内核之后单独进行
+struct BulletHit {
+    std::uint32_t bullet;  // 本步弹幕池中的下标（即生成顺序）
+    std::int32_t damage;
+    bool hitsAll;          // 群体伤害
+};
+
 // 一个具体的技能/行动定义
 struct ActData {
     sf::String name;       // 技能名 (e.g. "Rude Buster", "Check")
@@ -30,6 +44,7 @@ struct ActData {
     int damage = 0;         // 伤害值 (0表示非攻击)
     int heal = 0;           // 治疗值
     float mercyAdd = 0.f;   // 增加多少饶恕度
+    int actId = -1;         // ActCatalog 驻留的整数 ID（敌人按 ID 查转移表），-1 表示未登记
 };
 
 // 玩家选完指令后生成的“命令包”
@@ -0,0 +1,108 @@
+﻿#include "Battle/BulletBenchmark.h"
+#include "Battle/BulletPool.h"
+#include "Battle/BulletGrid.h"
+#include "Utils/JobSystem.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <thread>
+#include <vector>
+
+//
+// 弹幕更新基准（BulletBenchmark）
+// ------------------------------
+// 职责：
+// - 按种子生成同一批弹幕，分别用 1..N 个线程（N-1 个工作线程 + 调用线程）推进相同步数
+// - 每步：并行积分/判定 → 按块序合并命中 → 压紧 → 擦弹，与 BattleState::updateBullets 的流程一致
+// - 擦弹单独计时（网格重建 + 查询；范围标记已含在判定内核中）：网格与游戏中一样覆盖战斗箱外扩的范围
+// 关键约定：
+// - 弹幕速度较低，基准期间大部分弹幕留在视图内，规模近似恒定
+// - 弹幕与模式 A 同为梅花弹，使用游戏中的碰撞掩码（宽相位命中者再做掩码判定）
+// - 命中校验值由 (步序, 弹幕下标, 伤害) 累积，任一线程数与单线程不同即报告 MISMATCH
+//
+
+namespace {
+const sf::FloatRect kView({ 0.f, 0.f }, { 640.f, 480.f });
+const sf::FloatRect kSoul({ 312.f, 232.f }, { 16.f, 16.f }); // 位于战斗箱内
+
+struct RunResult {
+	double msPerStep = 0.0;
+	double grazeMsPerStep = 0.0;
+	std::size_t grazes = 0;
+	std::uint64_t checksum = 0;
+	std::size_t remaining = 0;
+};
+
+RunResult runOnce(const BulletBenchmarkConfig& config, JobSystem& jobs)
+{
+	std::mt19937 rng(config.seed);
+	std::uniform_real_distribution<float> px(0.f, kView.size.x);
+	std::uniform_real_distribution<float> py(0.f, kView.size.y);
+	std::uniform_real_distribution<float> pv(-40.f, 40.f);
+	BulletPool pool;
+	pool.reserve(static_cast<std::size_t>(std::max(0, config.bullets)));
+	pool.loadSpriteMasks();
+	pool.setGrazeArea(BattleRules::soulBounds(BattleRules::battleBoxPosition(kView.size)), BattleRules::kGrazeRadius);
+	for (int i = 0; i < config.bullets; ++i) {
+		BattleRules::BulletSpawn s;
+		s.position = { px(rng), py(rng) };
+		s.velocity = { pv(rng), pv(rng) };
+		s.damage = 1 + (i % 7);
+		pool.spawn(s);
+	}
+
+	RunResult result;
+	std::vector<BulletHit> hits;
+	BulletGrid grid;
+	std::vector<std::uint32_t> grazed;
+	double grazeMs = 0.0;
+	const auto start = std::chrono::steady_clock::now();
+	for (int step = 0; step < config.steps; ++step) {
+		hits.clear();
+		pool.step(config.timeStep, kSoul, kView, hits, jobs);
+		for (const auto& h : hits) {
+			result.checksum = result.checksum * 1000003u + (static_cast<std::uint64_t>(step) << 32) + h.bullet * 31u + static_cast<std::uint64_t>(h.damage);
+		}
+		pool.compact();
+
+		const auto grazeStart = std::chrono::steady_clock::now();
+		grid.rebuild(pool, BattleRules::kGrazeCellSize);
+		grazed.clear();
+		pool.collectGrazes(grid, kSoul, BattleRules::kGrazeRadius, grazed);
+		grazeMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - grazeStart).count();
+		result.grazes += grazed.size();
+	}
+	const double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	result.msPerStep = (elapsed - grazeMs) / std::max(1, config.steps);
+	result.grazeMsPerStep = grazeMs / std::max(1, config.steps);
+	result.remaining = pool.size();
+	return result;
+}
+}
+
+std::string runBulletBenchmark(const BulletBenchmarkConfig& config)
+{
+	const int maxThreads = config.maxThreads > 0
+		? config.maxThreads
+		: static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+	char buf[256];
+	std::string s;
+	std::snprintf(buf, sizeof(buf), "Bullet update benchmark: %d bullets, %d steps, grain %zu, seed %u\n",
+		config.bullets, config.steps, BulletPool::kParallelGrain, config.seed);
+	s += buf;
+	s += "  threads   ms/step   speedup   graze ms   result\n";
+
+	RunResult baseline;
+	for (int threads = 1; threads <= maxThreads; ++threads) {
+		JobSystem jobs(static_cast<unsigned>(threads - 1));
+		const RunResult r = runOnce(config, jobs);
+		if (threads == 1) baseline = r;
+		const bool same = r.checksum == baseline.checksum && r.remaining == baseline.remaining && r.grazes == baseline.grazes;
+		std::snprintf(buf, sizeof(buf), "  %7d  %8.3f  %7.2fx   %8.3f   %s (%zu left, %zu grazes)\n",
+			threads, r.msPerStep, r.msPerStep > 0.0 ? baseline.msPerStep / r.msPerStep : 0.0, r.grazeMsPerStep,
+			same ? "match" : "MISMATCH", r.remaining, r.grazes);
+		s += buf;
+	}
+	return s;
+}
@@ -0,0 +1,24 @@
+﻿/*
+弹幕更新基准测试（无窗口）。
+包含：
+
+生成大规模随机弹幕，按 1..N 个线程分别跑同样的若干步
+
+统计每步耗时与相对单线程的加速比，以及擦弹（网格重建 + 心形附近查询）的单独耗时
+
+校验各线程数下的命中事件与剩余弹幕和单线程完全一致
+*/
+#pragma once
+#include <cstdint>
+#include <string>
+
+struct BulletBenchmarkConfig {
+	int bullets = 50000;
+	int steps = 240;
+	std::uint32_t seed = 1;
+	int maxThreads = 0; // 0 表示硬件线程数
+	float timeStep = 1.f / 60.f;
+};
+
+// 运行并返回可直接打印的报告
+std::string runBulletBenchmark(const BulletBenchmarkConfig& config);
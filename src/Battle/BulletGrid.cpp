@@ -0,0 +1,49 @@
+﻿#include "Battle/BulletGrid.h"
+#include "Battle/BulletPool.h"
+#include <cmath>
+
+//
+// 弹幕网格（BulletGrid）
+// ---------------------
+// 职责：
+// - 为心形附近的弹幕查询（擦弹）提供宽相位：只检查查询矩形覆盖的格子
+// 关键约定：
+// - 每步压紧后重建，下标与 BulletPool 当前顺序一致；范围外的弹幕不进入网格
+// - 是否在范围内由判定内核顺带标记；全池只扫一遍标志，无分支地把候选收进表
+//   （弹幕大多在战斗箱外，分支难以预测），按格计数、前缀和与散布都只针对候选；容量随池复用
+//
+
+void BulletGrid::rebuild(const BulletPool& pool, float cellSize)
+{
+	const sf::FloatRect& bounds = pool.grazeArea();
+	m_origin = bounds.position;
+	m_size = bounds.size;
+	m_invCell = 1.f / std::max(cellSize, 1.f);
+	m_cols = std::max(1, static_cast<int>(std::ceil(m_size.x * m_invCell)));
+	m_rows = std::max(1, static_cast<int>(std::ceil(m_size.y * m_invCell)));
+	const std::size_t cells = static_cast<std::size_t>(m_cols) * static_cast<std::size_t>(m_rows);
+
+	const std::size_t n = pool.size();
+	m_cellStart.assign(cells + 1, 0);
+	m_inside.resize(n);
+	m_insideCell.resize(n);
+	std::size_t count = 0;
+	for (std::size_t i = 0; i < n; ++i) {
+		// 范围外的弹幕也写入当前槽位，但不推进 count，随后被覆盖
+		m_inside[count] = static_cast<std::uint32_t>(i);
+		count += pool.inGrazeArea(i);
+	}
+	for (std::size_t j = 0; j < count; ++j) {
+		const sf::Vector2f c = pool.position(m_inside[j]);
+		const std::uint32_t k = static_cast<std::uint32_t>(cell(c.y - m_origin.y, m_rows) * m_cols + cell(c.x - m_origin.x, m_cols));
+		m_insideCell[j] = k;
+		++m_cellStart[k + 1];
+	}
+	for (std::size_t k = 1; k <= cells; ++k) m_cellStart[k] += m_cellStart[k - 1];
+
+	m_indices.resize(count);
+	m_fill.assign(m_cellStart.begin(), m_cellStart.end() - 1);
+	for (std::size_t j = 0; j < count; ++j) {
+		m_indices[m_fill[m_insideCell[j]]++] = m_inside[j];
+	}
+}
@@ -0,0 +1,58 @@
+﻿/*
+弹幕宽相位网格。
+包含：
+
+覆盖弹幕池擦弹范围的均匀网格，每步按弹幕中心重建（计数排序，不做逐格分配）
+
+按矩形查询候选弹幕下标，代价只与附近格子里的弹幕数有关
+*/
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+class BulletPool;
+
+class BulletGrid {
+public:
+	// 重建：范围取 pool.grazeArea()，只收录本步 classify 标记为在范围内的弹幕，每颗弹幕只属于一个格子
+	void rebuild(const BulletPool& pool, float cellSize);
+
+	// 对与 area 相交的格子中的弹幕下标调用 fn(index)；格子按中心归属，调用方需把 area 外扩宽相位框的半边长
+	// 同一格内按下标升序，格子按行优先，结果与线程数无关
+	template <typename Fn>
+	void query(const sf::FloatRect& area, const Fn& fn) const
+	{
+		if (m_cols == 0 || m_rows == 0) return;
+		const float x1 = area.position.x - m_origin.x, y1 = area.position.y - m_origin.y;
+		const float x2 = x1 + area.size.x, y2 = y1 + area.size.y;
+		if (x2 < 0.f || y2 < 0.f || x1 >= m_size.x || y1 >= m_size.y) return;
+		const int c0 = cell(x1, m_cols), c1 = cell(x2, m_cols);
+		const int r0 = cell(y1, m_rows), r1 = cell(y2, m_rows);
+		for (int r = r0; r <= r1; ++r) {
+			for (int c = c0; c <= c1; ++c) {
+				const std::size_t k = static_cast<std::size_t>(r * m_cols + c);
+				for (std::uint32_t j = m_cellStart[k]; j < m_cellStart[k + 1]; ++j) fn(m_indices[j]);
+			}
+		}
+	}
+
+private:
+	// 相对网格原点的坐标 → 行/列号（夹在范围内）
+	int cell(float local, int count) const
+	{
+		return std::clamp(static_cast<int>(local * m_invCell), 0, count - 1);
+	}
+
+	sf::Vector2f m_origin{ 0.f, 0.f };
+	sf::Vector2f m_size{ 0.f, 0.f };
+	float m_invCell = 0.f;
+	int m_cols = 0;
+	int m_rows = 0;
+	std::vector<std::uint32_t> m_cellStart; // 各格在 m_indices 中的起点，末尾多一项为总数
+	std::vector<std::uint32_t> m_indices;   // 按格子排列的弹幕下标
+	std::vector<std::uint32_t> m_inside;     // 重建时范围内弹幕的下标（按下标升序）
+	std::vector<std::uint32_t> m_insideCell; // 与 m_inside 对应的格子
+	std::vector<std::uint32_t> m_fill;       // 重建时各格的写入位置
+};
@@ -0,0 +1,261 @@
+﻿#include "Battle/BulletPool.h"
+#include "Battle/BulletGrid.h"
+#include "Battle/CollisionMask.h"
+#include "Utils/JobSystem.h"
+#include <algorithm>
+#include <cmath>
+
+//
+// 弹幕池（BulletPool）
+// -------------------
+// 职责：
+// - 以结构数组保存弹幕，积分与判定内核按字段顺序遍历，便于编译器向量化
+// - 判定内核只写标志位，不结算伤害、不播音效；命中以紧凑事件交给上层单独结算
+// 关键约定：
+// - 命中分两阶段：宽相位框（半边长按种类查表，有掩码时取掩码外接半径）与心形相交的弹幕，
+//   再按其贴图掩码旋转后的实心像素精确判定；没有掩码的种类为 10x10 方形判定框，宽相位即结果
+// - 宽相位框与视图不相交即出界；宽相位命中很少，窄相位放在无分支的判定循环之后单独扫描
+// - 命中的弹幕无论是否造成伤害都会被移除（与旧版一致）
+// - 压紧保持生成顺序，命中事件按生成顺序排列
+// - 擦弹：判定内核顺带标记位于擦弹范围内的弹幕（数据已在寄存器中），网格只收录这些弹幕；
+//   压紧后经网格检查心形附近的弹幕，已擦标志随压紧保留；掩码判定时心形矩形外扩擦弹半径（角上按方形近似）
+// - 并行步按固定粒度分块（与线程数无关），各块命中写入独立列表后按块序拼接，结果确定
+//
+
+namespace {
+constexpr float kHalfHitbox = BulletPool::kHitboxSize * 0.5f;
+}
+
+BulletPool::BulletPool()
+{
+	m_kindHalf.fill(kHalfHitbox);
+}
+
+void BulletPool::clear()
+{
+	m_x.clear(); m_y.clear();
+	m_vx.clear(); m_vy.clear();
+	m_rotation.clear();
+	m_damage.clear();
+	m_flags.clear();
+	m_kind.clear();
+}
+
+void BulletPool::reserve(std::size_t count)
+{
+	m_x.reserve(count); m_y.reserve(count);
+	m_vx.reserve(count); m_vy.reserve(count);
+	m_rotation.reserve(count);
+	m_damage.reserve(count);
+	m_flags.reserve(count);
+	m_kind.reserve(count);
+}
+
+void BulletPool::spawn(const BattleRules::BulletSpawn& spawn)
+{
+	m_x.push_back(spawn.position.x);
+	m_y.push_back(spawn.position.y);
+	m_vx.push_back(spawn.velocity.x);
+	m_vy.push_back(spawn.velocity.y);
+	m_rotation.push_back(spawn.rotation);
+	m_damage.push_back(spawn.damage);
+	m_flags.push_back(spawn.hitsAll ? kHitsAll : 0);
+	m_kind.push_back(spawn.kind);
+}
+
+void BulletPool::setMask(std::uint8_t kind, std::shared_ptr<const CollisionMask> mask)
+{
+	if (m_masks.size() <= kind) m_masks.resize(static_cast<std::size_t>(kind) + 1);
+	m_kindHalf[kind] = mask ? mask->radius() : kHalfHitbox;
+	m_masks[kind] = std::move(mask);
+	m_maxHalf = *std::max_element(m_kindHalf.begin(), m_kindHalf.end());
+}
+
+void BulletPool::loadSpriteMasks()
+{
+	for (std::uint8_t kind = 0; kind < BattleRules::kBulletKindCount; ++kind) {
+		setMask(kind, CollisionMask::load(BattleRules::bulletSpritePath(kind)));
+	}
+}
+
+void BulletPool::step(float dt, const sf::FloatRect& soul, const sf::FloatRect& view, std::vector<BulletHit>& hits)
+{
+	integrate(0, size(), dt);
+	classify(0, size(), soul, view);
+	collectHits(0, size(), hits);
+}
+
+void BulletPool::step(float dt, const sf::FloatRect& soul, const sf::FloatRect& view, std::vector<BulletHit>& hits, JobSystem& jobs)
+{
+	const std::size_t n = size();
+	if (n < 2 * kParallelGrain || jobs.workerCount() == 0) {
+		step(dt, soul, view, hits);
+		return;
+	}
+	const std::size_t chunks = (n + kParallelGrain - 1) / kParallelGrain;
+	if (m_chunkHits.size() < chunks) m_chunkHits.resize(chunks);
+	jobs.parallelFor(n, kParallelGrain, [&](std::size_t begin, std::size_t end) {
+		std::vector<BulletHit>& local = m_chunkHits[begin / kParallelGrain];
+		local.clear();
+		integrate(begin, end, dt);
+		classify(begin, end, soul, view);
+		collectHits(begin, end, local);
+	});
+	for (std::size_t c = 0; c < chunks; ++c) {
+		hits.insert(hits.end(), m_chunkHits[c].begin(), m_chunkHits[c].end());
+	}
+}
+
+void BulletPool::integrate(std::size_t begin, std::size_t end, float dt)
+{
+	float* x = m_x.data();
+	float* y = m_y.data();
+	const float* vx = m_vx.data();
+	const float* vy = m_vy.data();
+	for (std::size_t i = begin; i < end; ++i) {
+		x[i] += vx[i] * dt;
+		y[i] += vy[i] * dt;
+	}
+}
+
+void BulletPool::classify(std::size_t begin, std::size_t end, const sf::FloatRect& soul, const sf::FloatRect& view)
+{
+	const float sx1 = soul.position.x, sy1 = soul.position.y;
+	const float sx2 = sx1 + soul.size.x, sy2 = sy1 + soul.size.y;
+	const float vx1 = view.position.x, vy1 = view.position.y;
+	const float vx2 = vx1 + view.size.x, vy2 = vy1 + view.size.y;
+	const float gx1 = m_grazeArea.position.x, gy1 = m_grazeArea.position.y;
+	const float gx2 = gx1 + m_grazeArea.size.x, gy2 = gy1 + m_grazeArea.size.y;
+	const float* x = m_x.data();
+	const float* y = m_y.data();
+	const float* half = m_kindHalf.data();
+	const std::uint8_t* kind = m_kind.data();
+	std::uint8_t* flags = m_flags.data();
+	for (std::size_t i = begin; i < end; ++i) {
+		const float h = half[kind[i]];
+		const float bx1 = x[i] - h, bx2 = x[i] + h;
+		const float by1 = y[i] - h, by2 = y[i] + h;
+		// 全部用按位运算组合比较结果，循环内没有分支
+		const bool hit = !((sx2 < bx1) | (sx1 > bx2) | (sy2 < by1) | (sy1 > by2));
+		const bool out = (bx2 < vx1) | (bx1 > vx2) | (by2 < vy1) | (by1 > vy2);
+		const bool near = (x[i] >= gx1) & (x[i] < gx2) & (y[i] >= gy1) & (y[i] < gy2);
+		const std::uint8_t keep = flags[i] & (kHitsAll | kGrazed);
+		flags[i] = static_cast<std::uint8_t>(keep | (hit ? kHit : 0) | (out ? kRemove : 0) | (near ? kNear : 0));
+	}
+	// 窄相位：只处理宽相位命中的弹幕，确认命中才移除
+	for (std::size_t i = begin; i < end; ++i) {
+		if (!(flags[i] & kHit)) continue;
+		if (maskOverlaps(i, soul)) flags[i] |= kRemove;
+		else flags[i] &= static_cast<std::uint8_t>(~kHit);
+	}
+}
+
+bool BulletPool::maskOverlaps(std::size_t i, const sf::FloatRect& rect) const
+{
+	const std::uint8_t kind = m_kind[i];
+	const CollisionMask* mask = (kind < m_masks.size()) ? m_masks[kind].get() : nullptr;
+	if (!mask) return true;
+	float c = 1.f, s = 0.f;
+	if (m_rotation[i] != 0.f) {
+		const float rad = m_rotation[i] * 3.14159265f / 180.f;
+		c = std::cos(rad);
+		s = std::sin(rad);
+	}
+	return mask->overlaps({ m_x[i], m_y[i] }, c, s, rect);
+}
+
+void BulletPool::collectHits(std::size_t begin, std::size_t end, std::vector<BulletHit>& hits) const
+{
+	for (std::size_t i = begin; i < end; ++i) {
+		if (!(m_flags[i] & kHit)) continue;
+		hits.push_back({ static_cast<std::uint32_t>(i), m_damage[i], (m_flags[i] & kHitsAll) != 0 });
+	}
+}
+
+void BulletPool::compact()
+{
+	// 大多数步没有弹幕离场：先找第一个待移除项，没有则直接返回
+	const std::size_t n = size();
+	std::size_t out = 0;
+	while (out < n && !(m_flags[out] & kRemove)) ++out;
+	if (out == n) return;
+	for (std::size_t i = out + 1; i < n; ++i) {
+		if (m_flags[i] & kRemove) continue;
+		m_x[out] = m_x[i]; m_y[out] = m_y[i];
+		m_vx[out] = m_vx[i]; m_vy[out] = m_vy[i];
+		m_rotation[out] = m_rotation[i];
+		m_damage[out] = m_damage[i];
+		m_flags[out] = m_flags[i];
+		m_kind[out] = m_kind[i];
+		++out;
+	}
+	m_x.resize(out); m_y.resize(out);
+	m_vx.resize(out); m_vy.resize(out);
+	m_rotation.resize(out);
+	m_damage.resize(out);
+	m_flags.resize(out);
+	m_kind.resize(out);
+}
+
+void BulletPool::setGrazeArea(const sf::FloatRect& box, float radius)
+{
+	const float reach = radius + m_maxHalf;
+	m_grazeArea = sf::FloatRect({ box.position.x - reach, box.position.y - reach }, { box.size.x + 2.f * reach, box.size.y + 2.f * reach });
+}
+
+void BulletPool::collectGrazes(const BulletGrid& grid, const sf::FloatRect& soul, float radius, std::vector<std::uint32_t>& grazed)
+{
+	const float sx1 = soul.position.x, sy1 = soul.position.y;
+	const float sx2 = sx1 + soul.size.x, sy2 = sy1 + soul.size.y;
+	const float reach = radius + m_maxHalf;
+	const sf::FloatRect area({ sx1 - reach, sy1 - reach }, { soul.size.x + 2.f * reach, soul.size.y + 2.f * reach });
+	const sf::FloatRect inflated({ sx1 - radius, sy1 - radius }, { soul.size.x + 2.f * radius, soul.size.y + 2.f * radius });
+	const float radius2 = radius * radius;
+	grid.query(area, [&](std::uint32_t i) {
+		if (m_flags[i] & (kGrazed | kRemove)) return;
+		const float h = m_kindHalf[m_kind[i]];
+		const float bx1 = m_x[i] - h, bx2 = m_x[i] + h;
+		const float by1 = m_y[i] - h, by2 = m_y[i] + h;
+		// 宽相位框与心形之间的最短距离（相交时为 0）
+		const float dx = std::max(0.f, std::max(bx1 - sx2, sx1 - bx2));
+		const float dy = std::max(0.f, std::max(by1 - sy2, sy1 - by2));
+		if (dx * dx + dy * dy > radius2) return;
+		if (!maskOverlaps(i, inflated)) return;
+		m_flags[i] |= kGrazed;
+		grazed.push_back(i);
+	});
+}
+
+sf::FloatRect BulletPool::bounds(std::size_t i) const
+{
+	const float h = m_kindHalf[m_kind[i]];
+	return sf::FloatRect({ m_x[i] - h, m_y[i] - h }, { 2.f * h, 2.f * h });
+}
+
+void BulletPool::appendQuads(std::uint8_t kind, const sf::Texture& texture, sf::VertexArray& out) const
+{
+	const sf::Vector2f tex(texture.getSize());
+	const sf::Vector2f half = tex * 0.5f;
+	const sf::Vector2f corner[4] = { { -half.x, -half.y }, { half.x, -half.y }, { half.x, half.y }, { -half.x, half.y } };
+	const sf::Vector2f uv[4] = { { 0.f, 0.f }, { tex.x, 0.f }, { tex.x, tex.y }, { 0.f, tex.y } };
+	for (std::size_t i = 0; i < size(); ++i) {
+		if (m_kind[i] != kind) continue;
+		float c = 1.f, s = 0.f;
+		if (m_rotation[i] != 0.f) {
+			const float rad = m_rotation[i] * 3.14159265f / 180.f;
+			c = std::cos(rad);
+			s = std::sin(rad);
+		}
+		sf::Vertex v[4];
+		for (int k = 0; k < 4; ++k) {
+			const sf::Vector2f p = corner[k];
+			v[k] = { { m_x[i] + p.x * c - p.y * s, m_y[i] + p.x * s + p.y * c }, sf::Color::White, uv[k] };
+		}
+		out.append(v[0]);
+		out.append(v[1]);
+		out.append(v[2]);
+		out.append(v[0]);
+		out.append(v[2]);
+		out.append(v[3]);
+	}
+}
@@ -0,0 +1,103 @@
+﻿/*
+弹幕池（结构数组）。
+包含：
+
+按字段分开存放的位置、速度、旋转、伤害与标志
+
+积分与命中/出界判定内核（只写本池数组，可按区间分块；弹幕很多时交给 JobSystem 并行）
+
+两阶段命中：按种类外接半径的 AABB 宽相位，命中者再按贴图碰撞掩码（含旋转）精确判定
+
+命中事件输出与压紧
+
+擦弹判定（经 BulletGrid 只检查心形附近的弹幕，每颗弹幕只计一次）
+
+按贴图种类批量生成绘制顶点
+*/
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "Battle/BattleTypes.h"
+#include "Battle/BattleRules.h"
+
+class JobSystem;
+class BulletGrid;
+class CollisionMask;
+
+class BulletPool {
+public:
+	static constexpr float kHitboxSize = 10.f; // 没有碰撞掩码的种类使用的方形判定框边长
+	static constexpr std::size_t kParallelGrain = 4096; // 并行时每块的弹幕数；不足两块时直接串行
+
+	BulletPool();
+
+	void clear();
+	void reserve(std::size_t count);
+	std::size_t size() const { return m_x.size(); }
+	bool empty() const { return m_x.empty(); }
+
+	// spawn.kind 为贴图种类：绘制时按种类分批，碰撞按种类选用掩码
+	void spawn(const BattleRules::BulletSpawn& spawn);
+
+	// kind 种弹幕的碰撞掩码（为空则回退到 kHitboxSize 的方形判定框，不随旋转）；
+	// 宽相位框的半边长取掩码外接半径。须在 setGrazeArea 之前设置，clear 不清除
+	void setMask(std::uint8_t kind, std::shared_ptr<const CollisionMask> mask);
+	// 按 BattleRules::bulletSpritePath 为每个种类设置掩码（CollisionMask::load 有缓存，只在首次读取贴图）
+	void loadSpriteMasks();
+
+	// 一步模拟：integrate + classify 全区间，再按下标升序收集命中
+	void step(float dt, const sf::FloatRect& soul, const sf::FloatRect& view, std::vector<BulletHit>& hits);
+	// 并行版本：按 kParallelGrain 分块，各块积分、判定并把命中写入本块的列表，再按块序拼接
+	// 块划分与线程数无关，命中事件与串行版本逐项相同
+	void step(float dt, const sf::FloatRect& soul, const sf::FloatRect& view, std::vector<BulletHit>& hits, JobSystem& jobs);
+	// 内核：只读写 [begin, end) 内的元素，互不重叠的区间可并行执行
+	void integrate(std::size_t begin, std::size_t end, float dt);
+	void classify(std::size_t begin, std::size_t end, const sf::FloatRect& soul, const sf::FloatRect& view);
+	// 把 [begin, end) 内 classify 标记的命中按下标升序追加到 hits（即生成顺序）
+	void collectHits(std::size_t begin, std::size_t end, std::vector<BulletHit>& hits) const;
+	// 移除本步命中或出界的弹幕，保持剩余弹幕的相对顺序
+	void compact();
+	// 擦弹范围：心形活动范围 box 外扩 radius + 最大的宽相位半边长；classify 顺带标记中心在范围内的弹幕，供网格收录
+	void setGrazeArea(const sf::FloatRect& box, float radius);
+	const sf::FloatRect& grazeArea() const { return m_grazeArea; }
+	bool inGrazeArea(std::size_t i) const { return (m_flags[i] & kNear) != 0; }
+	// 擦弹：grid 须在压紧后按本池重建；心形须在 setGrazeArea 的 box 内
+	// 与心形的间距不超过 radius（有掩码时为实心像素落在心形外扩 radius 的矩形内）且尚未擦过的弹幕记为擦弹，
+	// 下标按网格查询顺序追加到 grazed
+	void collectGrazes(const BulletGrid& grid, const sf::FloatRect& soul, float radius, std::vector<std::uint32_t>& grazed);
+
+	sf::Vector2f position(std::size_t i) const { return { m_x[i], m_y[i] }; }
+	sf::Vector2f velocity(std::size_t i) const { return { m_vx[i], m_vy[i] }; }
+	// 宽相位框（以弹幕中心为中心；有掩码时覆盖任意旋转下的全部实心像素）
+	sf::FloatRect bounds(std::size_t i) const;
+	// 追加 kind 种弹幕的贴图四边形（两三角形，含旋转）
+	void appendQuads(std::uint8_t kind, const sf::Texture& texture, sf::VertexArray& out) const;
+
+private:
+	enum Flag : std::uint8_t {
+		kHitsAll = 1 << 0,
+		kHit = 1 << 1,    // 宽相位命中；窄相位确认后才同时带 kRemove
+		kRemove = 1 << 2,
+		kGrazed = 1 << 3, // 已擦过（跨步保留）
+		kNear = 1 << 4,   // 本步弹幕中心位于擦弹范围内
+	};
+
+	std::vector<float> m_x, m_y;
+	std::vector<float> m_vx, m_vy;
+	std::vector<float> m_rotation; // 角度制
+	std::vector<std::int32_t> m_damage;
+	std::vector<std::uint8_t> m_flags;
+	std::vector<std::uint8_t> m_kind;
+	std::vector<std::vector<BulletHit>> m_chunkHits; // 并行步各块的命中（复用容量）
+	sf::FloatRect m_grazeArea{}; // 为空时不标记任何弹幕
+
+	// 窄相位：第 i 颗弹幕按其种类的掩码（含旋转）是否与 rect 相交；没有掩码时视为相交
+	bool maskOverlaps(std::size_t i, const sf::FloatRect& rect) const;
+
+	std::vector<std::shared_ptr<const CollisionMask>> m_masks; // 按种类下标
+	std::array<float, 256> m_kindHalf;                         // 各种类宽相位框的半边长（按 kind 直接查表）
+	float m_maxHalf = kHitboxSize * 0.5f;
+};
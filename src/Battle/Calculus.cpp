@@ -1,8 +1,17 @@
 ﻿#include "Battle/Calculus.h"
+#include <algorithm>
 
-std::vector<Enemy> makeCalculusEncounter()
+std::vector<Enemy> makeEncounter(const std::vector<std::string>& enemyIds)
 {
 	std::vector<Enemy> enemies;
-	enemies.push_back(Enemy::makeCalculus());
+	enemies.reserve(enemyIds.size());
+	for (const auto& id : enemyIds) {
+		enemies.push_back(Enemy::create(id));
+	}
 	return enemies;
 }
+
+std::vector<Enemy> makeCalculusEncounter(int count)
+{
+	return makeEncounter(std::vector<std::string>(static_cast<std::size_t>(std::max(1, count)), "calculus"));
+}
@@ -1,6 +1,10 @@
 ﻿#pragma once
+#include <string>
 #include <vector>
 #include "Battle/Enemy.h"
 
-// 生成 "高数题" 遭遇配置（目前只有一只）
-std::vector<Enemy> makeCalculusEncounter();
\ No newline at end of file
+// 按敌人 ID 列表生成遭遇（同一 ID 可重复，各只共享定义、状态独立）
+std::vector<Enemy> makeEncounter(const std::vector<std::string>& enemyIds);
+
+// 生成 "高数题" 遭遇配置（count 只，定义见 assets/enemy/calculus.json）
+std::vector<Enemy> makeCalculusEncounter(int count = 1);
\ No newline at end of file
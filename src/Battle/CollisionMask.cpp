@@ -0,0 +1,105 @@
+﻿#include "Battle/CollisionMask.h"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <mutex>
+#include <unordered_map>
+
+//
+// 弹幕碰撞掩码（CollisionMask）
+// ---------------------------
+// 职责：
+// - 从 sf::Image 的 alpha 通道生成逐像素位图，并求出实心像素的外接半径
+// - 精确判定：把矩形四角逆旋转到掩码像素坐标，只扫描其包围盒覆盖的行；
+//   每行按字取出实心位，逐个把像素中心旋转回世界坐标检查是否落在矩形内
+// 关键约定：
+// - 像素 (x, y) 的中心在掩码局部坐标 (x + 0.5 - width/2, y + 0.5 - height/2)，旋转方式与 BulletPool::appendQuads 相同
+// - 只由宽相位命中的少数弹幕调用，每次的代价与矩形覆盖的像素数成正比
+// - 缓存持有掩码直到进程结束；读取失败同样缓存，调用方回退到方形判定框
+//
+
+CollisionMask::CollisionMask(const sf::Image& image, std::uint8_t alphaThreshold)
+	: m_width(image.getSize().x), m_height(image.getSize().y)
+{
+	m_stride = (m_width + 63) / 64;
+	m_bits.assign(static_cast<std::size_t>(m_stride) * m_height, 0);
+	const std::uint8_t* pixels = image.getPixelsPtr();
+	if (!pixels) return;
+	const float hx = m_width * 0.5f, hy = m_height * 0.5f;
+	float radius2 = 0.f;
+	for (unsigned y = 0; y < m_height; ++y) {
+		for (unsigned x = 0; x < m_width; ++x) {
+			if (pixels[(static_cast<std::size_t>(y) * m_width + x) * 4 + 3] <= alphaThreshold) continue;
+			m_bits[static_cast<std::size_t>(y) * m_stride + x / 64] |= std::uint64_t{ 1 } << (x % 64);
+			// 像素离中心最远的角
+			const float dx = std::max(std::abs(x - hx), std::abs(x + 1.f - hx));
+			const float dy = std::max(std::abs(y - hy), std::abs(y + 1.f - hy));
+			radius2 = std::max(radius2, dx * dx + dy * dy);
+		}
+	}
+	m_radius = std::sqrt(radius2);
+}
+
+std::shared_ptr<const CollisionMask> CollisionMask::load(const std::string& path)
+{
+	static std::mutex mutex;
+	static std::unordered_map<std::string, std::shared_ptr<const CollisionMask>> cache;
+	std::lock_guard<std::mutex> lock(mutex);
+	if (auto it = cache.find(path); it != cache.end()) return it->second;
+	std::shared_ptr<const CollisionMask> mask;
+	sf::Image image;
+	if (image.loadFromFile(path)) mask = std::make_shared<const CollisionMask>(image);
+	cache.emplace(path, mask);
+	return mask;
+}
+
+bool CollisionMask::solid(int x, int y) const
+{
+	if (x < 0 || y < 0 || x >= static_cast<int>(m_width) || y >= static_cast<int>(m_height)) return false;
+	return (m_bits[static_cast<std::size_t>(y) * m_stride + static_cast<unsigned>(x) / 64] >> (x % 64)) & 1u;
+}
+
+bool CollisionMask::overlaps(const sf::Vector2f& center, float cosA, float sinA, const sf::FloatRect& rect) const
+{
+	const float hx = m_width * 0.5f, hy = m_height * 0.5f;
+	const float rx1 = rect.position.x, ry1 = rect.position.y;
+	const float rx2 = rx1 + rect.size.x, ry2 = ry1 + rect.size.y;
+
+	// 矩形四角 → 掩码像素坐标（逆旋转），取包围盒
+	float lx1 = static_cast<float>(m_width), ly1 = static_cast<float>(m_height), lx2 = 0.f, ly2 = 0.f;
+	const sf::Vector2f corners[4] = { { rx1, ry1 }, { rx2, ry1 }, { rx2, ry2 }, { rx1, ry2 } };
+	for (const sf::Vector2f& p : corners) {
+		const float dx = p.x - center.x, dy = p.y - center.y;
+		const float lx = dx * cosA + dy * sinA + hx;
+		const float ly = -dx * sinA + dy * cosA + hy;
+		lx1 = std::min(lx1, lx); lx2 = std::max(lx2, lx);
+		ly1 = std::min(ly1, ly); ly2 = std::max(ly2, ly);
+	}
+	// 像素中心 x + 0.5 落在 [lx1, lx2] 内的列
+	const int x0 = std::max(0, static_cast<int>(std::ceil(lx1 - 0.5f)));
+	const int x1 = std::min(static_cast<int>(m_width) - 1, static_cast<int>(std::floor(lx2 - 0.5f)));
+	const int y0 = std::max(0, static_cast<int>(std::ceil(ly1 - 0.5f)));
+	const int y1 = std::min(static_cast<int>(m_height) - 1, static_cast<int>(std::floor(ly2 - 0.5f)));
+	if (x0 > x1 || y0 > y1) return false;
+
+	const unsigned w0 = static_cast<unsigned>(x0) / 64, w1 = static_cast<unsigned>(x1) / 64;
+	for (int y = y0; y <= y1; ++y) {
+		const std::uint64_t* row = m_bits.data() + static_cast<std::size_t>(y) * m_stride;
+		const float py = y + 0.5f - hy;
+		for (unsigned w = w0; w <= w1; ++w) {
+			std::uint64_t bits = row[w];
+			// 截掉 [x0, x1] 以外的列
+			if (w == w0) bits &= ~std::uint64_t{ 0 } << (x0 % 64);
+			if (w == w1 && x1 % 64 != 63) bits &= (std::uint64_t{ 1 } << (x1 % 64 + 1)) - 1;
+			while (bits) {
+				const int x = static_cast<int>(w * 64 + std::countr_zero(bits));
+				bits &= bits - 1;
+				const float px = x + 0.5f - hx;
+				const float wx = center.x + px * cosA - py * sinA;
+				const float wy = center.y + px * sinA + py * cosA;
+				if (wx >= rx1 && wx <= rx2 && wy >= ry1 && wy <= ry2) return true;
+			}
+		}
+	}
+	return false;
+}
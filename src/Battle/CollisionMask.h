@@ -0,0 +1,45 @@
+﻿/*
+弹幕碰撞掩码。
+包含：
+
+由贴图 alpha 通道生成的逐像素位图（每行按 64 位字存放），原点在贴图中心
+
+旋转不变的外接半径，供 AABB 宽相位使用
+
+旋转后的掩码与轴对齐矩形的精确相交判定
+
+按贴图路径缓存：每张贴图只读取、生成一次
+*/
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+class CollisionMask {
+public:
+	static constexpr std::uint8_t kAlphaThreshold = 127; // alpha 大于该值的像素视为实心
+
+	explicit CollisionMask(const sf::Image& image, std::uint8_t alphaThreshold = kAlphaThreshold);
+
+	// 按路径读取图片并生成掩码；结果（包括读取失败时的空指针）在进程内缓存，可在任意线程调用
+	static std::shared_ptr<const CollisionMask> load(const std::string& path);
+
+	unsigned width() const { return m_width; }
+	unsigned height() const { return m_height; }
+	bool solid(int x, int y) const;
+	// 实心像素的角到贴图中心的最大距离（没有实心像素时为 0）
+	float radius() const { return m_radius; }
+
+	// 掩码中心位于 center、按 (cosA, sinA) 旋转（与 BulletPool 绘制贴图一致）时，
+	// 是否有实心像素的中心落在 rect（闭区间）内
+	bool overlaps(const sf::Vector2f& center, float cosA, float sinA, const sf::FloatRect& rect) const;
+
+private:
+	unsigned m_width = 0;
+	unsigned m_height = 0;
+	unsigned m_stride = 0; // 每行的 64 位字数
+	std::vector<std::uint64_t> m_bits;
+	float m_radius = 0.f;
+};
@@ -13,24 +13,30 @@
 #pragma once
 #include <SFML/Graphics.hpp>
 #include <vector>
-#include <map>
 #include <memory>
+#include <optional>
+#include <string>
 #include "Battle/BattleTypes.h"
+#include "Battle/EnemyDefinition.h"
+#include "UI/RectBatch.h"
 
 // 轻量的敌人数据结构，主打 "能跑起来"。
 class Enemy {
 public:
-	enum class CalcStage { One0, OneA1, OneA2, OneB1, OneB2, OneB3 };
-
 	Enemy() = default;
 	Enemy(const sf::String& name, int maxHP, int atk, int def);
+	explicit Enemy(std::shared_ptr<const EnemyDefinition> definition);
 
-	// 工厂：构造一只 "高数题" 敌人
-	static Enemy makeCalculus();
+	// 工厂：按 EnemyRegistry 中的定义构造；定义缺失时返回以 ID 命名的占位敌人
+	static Enemy create(const std::string& id);
 
 	bool ignoreDamage() const { return m_ignoreDamage; }
+	// 行动：按定义的转移表推进阶段并追加仁慈值；返回 true 表示已自行处理（不再走通用结算）
 	bool onAct(const ActData& act);
-	CalcStage getCalcStage() const { return m_calcStage; }
+	int getStage() const { return m_stage; }
+	const EnemyDefinition* definition() const { return m_def.get(); }
+	// 当前阶段指定的弹幕模式（空表示按回合轮换）
+	std::optional<BulletPattern> stagePattern() const;
 	bool isSpared() const { return m_spared; }
 	bool trySpare();
 
@@ -50,14 +56,17 @@ public:
 	void addMercy(float amount);
 	void heal(int amount);
 
-	// 渲染：目前用占位矩形+文字，后续可替换为贴图
-	void draw(sf::RenderWindow& window, const sf::Font& font, const sf::Vector2f& origin) const;
+	// 渲染：有阶段贴图时画贴图；否则由调用方把占位框与血条合批（appendPlaceholder），名字另行绘制
+	bool hasSprite() const;
+	void draw(sf::RenderTarget& target, const sf::Vector2f& origin, float scale = 1.f) const;
+	void appendPlaceholder(RectBatch& batch, const sf::Vector2f& origin, float scale = 1.f) const;
+	// 占位名字相对站位原点的偏移与颜色（仁慈满或已饶恕时变黄）
+	sf::Vector2f nameOffset() const { return {12.f, 8.f}; }
+	sf::Color nameColor() const;
 
 private:
-	static void ensureCalcTextures();
-	static const sf::Texture* textureForStage(CalcStage stage);
-	void setCalcStage(CalcStage stage);
-
+	std::shared_ptr<const EnemyDefinition> m_def; // 数据驱动的敌人共享同一份定义
+	int m_stage = 0;
 	sf::String m_name;
 	int m_maxHP = 0;
 	int m_hp = 0;
@@ -67,8 +76,5 @@ private:
 	std::vector<ActData> m_actList;
 	sf::Vector2f m_size{160.f, 90.f};
 	bool m_ignoreDamage = false;
-	bool m_isCalc = false;
 	bool m_spared = false;
-	CalcStage m_calcStage = CalcStage::One0;
-	static std::map<CalcStage, std::shared_ptr<sf::Texture>> s_calcTextures;
 };
\ No newline at end of file
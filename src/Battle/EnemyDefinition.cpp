@@ -0,0 +1,165 @@
+﻿//
+// 敌人定义与登记表（EnemyDefinition / EnemyRegistry）
+// -------------------------------------------------
+// 职责：
+// - 解析 assets/enemy/<id>.json：数值、阶段（贴图/弹幕模式）、行动转移
+// - 把按行动名书写的转移编译为整数表：行动名经 ActCatalog 驻留为 ID，
+//   只为本敌人用到的行动分配列，查表为 transitions[stage * columnCount + column]
+// - 在主线程按需加载阶段贴图（经 StateTransition，过渡期间使用预解码图片）
+// 关键约定：
+// - 阶段与转移用字符串 ID 书写，加载时一次性解析成下标；未知阶段的转移被忽略并报错
+// - "pattern" 取 "A"/"B"，省略表示按回合轮换
+// - 文件缺失或解析失败时 get() 返回 nullptr，并缓存失败结果避免重复读盘
+//
+#include "Battle/EnemyDefinition.h"
+#include "Battle/ActCatalog.h"
+#include "Game/StateTransition.h"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <json.hpp>
+
+using json = nlohmann::json;
+
+std::map<std::string, std::shared_ptr<EnemyDefinition>> EnemyRegistry::s_definitions;
+
+namespace {
+sf::String utf8(const std::string& s) {
+	return sf::String::fromUtf8(s.begin(), s.end());
+}
+
+std::optional<BulletPattern> readPattern(const json& j) {
+	const std::string p = j.value("pattern", "");
+	if (p == "A") return BulletPattern::PatternA;
+	if (p == "B") return BulletPattern::PatternB;
+	return std::nullopt;
+}
+}
+
+const EnemyTransition* EnemyDefinition::transition(int stage, int actId) const
+{
+	if (stage < 0 || stage >= static_cast<int>(stages.size())) return nullptr;
+	if (actId < 0 || actId >= static_cast<int>(actColumn.size())) return nullptr;
+	const int column = actColumn[static_cast<std::size_t>(actId)];
+	if (column < 0) return nullptr;
+	const EnemyTransition& t = transitions[static_cast<std::size_t>(stage) * columnCount + static_cast<std::size_t>(column)];
+	return (t.to >= 0) ? &t : nullptr;
+}
+
+int EnemyDefinition::stageIndex(const std::string& stageId) const
+{
+	for (std::size_t i = 0; i < stages.size(); ++i) {
+		if (stages[i].id == stageId) return static_cast<int>(i);
+	}
+	return -1;
+}
+
+const sf::Texture* EnemyDefinition::stageTexture(int stage) const
+{
+	if (stage < 0 || stage >= static_cast<int>(stageTextures.size())) return nullptr;
+	return stageTextures[static_cast<std::size_t>(stage)].get();
+}
+
+std::shared_ptr<const EnemyDefinition> EnemyRegistry::get(const std::string& id)
+{
+	auto it = s_definitions.find(id);
+	if (it == s_definitions.end()) {
+		it = s_definitions.emplace(id, load(id)).first;
+	}
+	return it->second;
+}
+
+std::vector<std::string> EnemyRegistry::spritePaths(const std::string& id)
+{
+	std::vector<std::string> paths;
+	if (auto def = get(id)) {
+		for (const auto& stage : def->stages) {
+			if (!stage.sprite.empty()) paths.push_back(stage.sprite);
+		}
+	}
+	return paths;
+}
+
+void EnemyRegistry::loadTextures(const std::string& id)
+{
+	get(id);
+	auto it = s_definitions.find(id);
+	if (it == s_definitions.end() || !it->second) return;
+	EnemyDefinition& def = *it->second;
+	if (!def.stageTextures.empty()) return;
+	def.stageTextures.resize(def.stages.size());
+	for (std::size_t i = 0; i < def.stages.size(); ++i) {
+		const std::string& path = def.stages[i].sprite;
+		if (path.empty()) continue;
+		auto tex = std::make_shared<sf::Texture>();
+		if (StateTransition::loadTexture(*tex, path)) {
+			tex->setSmooth(false);
+			def.stageTextures[i] = std::move(tex);
+		}
+	}
+}
+
+std::shared_ptr<EnemyDefinition> EnemyRegistry::load(const std::string& id)
+{
+	const std::string path = "assets/enemy/" + id + ".json";
+	std::ifstream file(path);
+	if (!file.is_open()) {
+		std::cerr << "EnemyRegistry: missing enemy file " << path << std::endl;
+		return nullptr;
+	}
+
+	auto def = std::make_shared<EnemyDefinition>();
+	try {
+		json j;
+		file >> j;
+		def->id = id;
+		def->name = utf8(j.value("name", id));
+		def->maxHP = j.value("hp", 1);
+		def->attack = j.value("attack", 0);
+		def->defense = j.value("defense", 0);
+		def->ignoreDamage = j.value("ignore_damage", false);
+		def->initialMercy = j.value("mercy", 0.f);
+		def->consumeActs = j.value("consume_acts", false);
+		if (j.contains("sprite")) {
+			const json& s = j["sprite"];
+			def->spriteScale = s.value("scale", 1.f);
+			const json& off = s.value("offset", json::array());
+			if (off.is_array() && off.size() >= 2) def->spriteOffset = { off[0].get<float>(), off[1].get<float>() };
+		}
+
+		for (const auto& s : j.value("stages", json::array())) {
+			def->stages.push_back({ s.value("id", ""), s.value("sprite", ""), readPattern(s) });
+		}
+		if (def->stages.empty()) {
+			def->stages.push_back({ "default", "", std::nullopt });
+		}
+		def->initialStage = std::max(0, def->stageIndex(j.value("initial_stage", def->stages.front().id)));
+
+		// 先驻留全部行动名、分配列号，再填表
+		struct RawTransition { int from; int to; int actId; float mercy; };
+		std::vector<RawTransition> raw;
+		for (const auto& t : j.value("transitions", json::array())) {
+			const int from = def->stageIndex(t.value("from", ""));
+			const int to = def->stageIndex(t.value("to", ""));
+			if (from < 0 || to < 0) {
+				std::cerr << "EnemyRegistry: " << id << " transition references unknown stage" << std::endl;
+				continue;
+			}
+			raw.push_back({ from, to, ActCatalog::intern(utf8(t.value("act", ""))), t.value("mercy", 0.f) });
+		}
+		def->actColumn.assign(ActCatalog::size(), -1);
+		for (const auto& r : raw) {
+			auto& column = def->actColumn[static_cast<std::size_t>(r.actId)];
+			if (column < 0) column = static_cast<std::int16_t>(def->columnCount++);
+		}
+		def->transitions.assign(def->stages.size() * def->columnCount, EnemyTransition{});
+		for (const auto& r : raw) {
+			const std::size_t column = static_cast<std::size_t>(def->actColumn[static_cast<std::size_t>(r.actId)]);
+			def->transitions[static_cast<std::size_t>(r.from) * def->columnCount + column] = { static_cast<std::int16_t>(r.to), r.mercy };
+		}
+	} catch (const json::exception& e) {
+		std::cerr << "EnemyRegistry: failed to parse " << path << ": " << e.what() << std::endl;
+		return nullptr;
+	}
+	return def;
+}
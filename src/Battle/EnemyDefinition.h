@@ -0,0 +1,76 @@
+﻿/*
+敌人定义（数据驱动）。
+包含：
+
+基础数值、免伤与初始仁慈值
+
+阶段列表：每个阶段的贴图与弹幕模式
+
+行动转移：加载时编译为按 (阶段, 行动 ID) 索引的整数表
+
+按 ID 读取 assets/enemy/<id>.json 的登记表
+*/
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+#include "Battle/BattleTypes.h"
+
+// 敌人的一个行为阶段
+struct EnemyStage {
+	std::string id;
+	std::string sprite;                   // 贴图路径，空表示使用占位矩形
+	std::optional<BulletPattern> pattern; // 本阶段的弹幕模式，空表示按回合轮换
+};
+
+// 转移表中的一格：行动命中后跳转的阶段与追加的仁慈值
+struct EnemyTransition {
+	std::int16_t to = -1; // -1 表示该行动在此阶段无效
+	float mercy = 0.f;
+};
+
+struct EnemyDefinition {
+	std::string id;
+	sf::String name;
+	int maxHP = 0;
+	int attack = 0;
+	int defense = 0;
+	bool ignoreDamage = false; // 攻击不造成伤害（只能靠行动解题）
+	float initialMercy = 0.f;
+	bool consumeActs = false;  // 为 true 时行动只按转移表推进，不再走通用的伤害/仁慈/治疗结算
+	float spriteScale = 1.f;
+	sf::Vector2f spriteOffset{0.f, 0.f};
+	int initialStage = 0;
+	std::vector<EnemyStage> stages;
+
+	// 编译后的转移表：行 = 阶段，列 = actColumn[actId]
+	std::vector<std::int16_t> actColumn; // 行动 ID → 列号，-1 表示该敌人不响应
+	std::size_t columnCount = 0;
+	std::vector<EnemyTransition> transitions;
+
+	// 主线程加载的阶段贴图（下标与 stages 一致）；离线模拟不加载
+	std::vector<std::shared_ptr<sf::Texture>> stageTextures;
+
+	// 查表：阶段与行动 ID 均为整数，越界或不响应时返回 nullptr
+	const EnemyTransition* transition(int stage, int actId) const;
+	int stageIndex(const std::string& stageId) const;
+	const sf::Texture* stageTexture(int stage) const;
+};
+
+class EnemyRegistry {
+public:
+	// 按 ID 取定义：首次访问时读取并编译 assets/enemy/<id>.json；失败返回 nullptr（只在主线程调用）
+	static std::shared_ptr<const EnemyDefinition> get(const std::string& id);
+	// 阶段贴图路径（供状态过渡预解码）
+	static std::vector<std::string> spritePaths(const std::string& id);
+	// 加载阶段贴图（已加载则跳过）
+	static void loadTextures(const std::string& id);
+
+private:
+	static std::shared_ptr<EnemyDefinition> load(const std::string& id);
+	static std::map<std::string, std::shared_ptr<EnemyDefinition>> s_definitions;
+};
@@ -108,9 +108,9 @@ void Soul::update(float dt)
 	}
 }
 
-void Soul::draw(sf::RenderWindow& window) const
+void Soul::draw(sf::RenderTarget& target) const
 {
-	if (m_sprite) window.draw(*m_sprite);
+	if (m_sprite) target.draw(*m_sprite);
 }
 
 sf::FloatRect Soul::getBounds() const
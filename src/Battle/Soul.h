@@ -26,7 +26,7 @@ public:
 
 	void handleInput(sf::RenderWindow& window, float dt);
 	void update(float dt);
-	void draw(sf::RenderWindow& window) const;
+	void draw(sf::RenderTarget& target) const;
 
 	sf::FloatRect getBounds() const;
 	const sf::Vector2f& getPosition() const { return m_position; }
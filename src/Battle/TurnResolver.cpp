@@ -0,0 +1,156 @@
+﻿//
+// 回合结算（TurnResolver）
+// ------------------------
+// 职责：
+// - prepare()：战斗开始时把武器/护甲加成折算进角色数值，并缓存治疗物品表
+// - resolve()：按指令顺序结算 Fight/Act/Item/Spare/Defend，输出紧凑事件列表
+// 关键约定：
+// - resolve() 只修改传入的 party/enemies，不读写 Global::*，也不消耗背包；
+//   物品消耗与日志由调用方（Battle）在应用事件时完成
+// - 越界的行动者被跳过；Fight/Act/Spare 的目标越界时不产生事件
+// - 伤害事件记录敌人实际扣除的 HP（已计入敌人防御与血量下限）
+//
+#include "Battle/TurnResolver.h"
+#include "Game/Database.h"
+#include <algorithm>
+
+namespace {
+const ResolvedHeroStats kEmptyStats{};
+
+int weaponAttack(const std::string& id) {
+	auto it = Database::weapons.find(id);
+	return (it != Database::weapons.end()) ? it->second.attack : 0;
+}
+
+int armorDefense(const std::string& id) {
+	auto it = Database::armors.find(id);
+	return (it != Database::armors.end()) ? it->second.defense : 0;
+}
+
+// 治疗我方并返回实际回复量
+int healHero(HeroRuntime& hero, int amount) {
+	const int before = hero.hp;
+	hero.hp = std::min(hero.maxHP, hero.hp + amount);
+	return hero.hp - before;
+}
+
+// 对敌人造成伤害并返回实际扣除的 HP
+int damageEnemy(Enemy& enemy, int amount) {
+	const int before = enemy.getHP();
+	enemy.takeDamage(amount);
+	return before - enemy.getHP();
+}
+}
+
+void TurnResolver::prepare(const std::vector<HeroRuntime>& party)
+{
+	m_heroStats.clear();
+	m_heroStats.reserve(party.size());
+	for (const auto& h : party) {
+		ResolvedHeroStats s;
+		s.attack = h.baseAttack + weaponAttack(h.weaponID);
+		s.defense = h.baseDefense;
+		for (const auto& armor : h.armorID) {
+			s.defense += armorDefense(armor);
+		}
+		s.magic = h.baseMagic;
+		m_heroStats.push_back(s);
+	}
+
+	m_healById.clear();
+	for (const auto& [id, item] : Database::hellingItems) {
+		m_healById.emplace(id, item.healAmount);
+	}
+}
+
+const ResolvedHeroStats& TurnResolver::heroStats(std::size_t index) const
+{
+	return (index < m_heroStats.size()) ? m_heroStats[index] : kEmptyStats;
+}
+
+int TurnResolver::healAmount(const std::string& itemId) const
+{
+	auto it = m_healById.find(itemId);
+	return (it != m_healById.end()) ? it->second : 0;
+}
+
+void TurnResolver::resolve(const std::vector<BattleCommand>& commands,
+	std::vector<HeroRuntime>& party,
+	std::vector<Enemy>& enemies,
+	std::vector<TurnEvent>& out) const
+{
+	const int partyCount = static_cast<int>(party.size());
+	const int enemyCount = static_cast<int>(enemies.size());
+	if (partyCount == 0) return;
+
+	for (std::size_t ci = 0; ci < commands.size(); ++ci) {
+		const BattleCommand& cmd = commands[ci];
+		if (cmd.actorIndex < 0 || cmd.actorIndex >= partyCount) continue;
+
+		TurnEvent ev;
+		ev.command = static_cast<std::uint8_t>(ci);
+		ev.actor = static_cast<std::int8_t>(cmd.actorIndex);
+		HeroRuntime& actor = party[cmd.actorIndex];
+		Enemy* target = nullptr;
+		if (cmd.targetIndex >= 0 && cmd.targetIndex < enemyCount) {
+			target = &enemies[cmd.targetIndex];
+			ev.target = static_cast<std::int8_t>(cmd.targetIndex);
+		}
+
+		switch (cmd.type) {
+		case ActionType::Fight: {
+			if (!target) break;
+			if (target->ignoreDamage()) {
+				ev.kind = TurnEventKind::Immune;
+			} else {
+				ev.kind = TurnEventKind::Damage;
+				ev.amount = damageEnemy(*target, std::max(1, heroStats(cmd.actorIndex).attack));
+			}
+			out.push_back(ev);
+			break; }
+		case ActionType::Act: {
+			// 优先让敌人自定义处理；否则按通用字段结算（伤害/仁慈/治疗）
+			if (!target || !cmd.actData.has_value()) break;
+			const ActData& act = *cmd.actData;
+			ev.kind = TurnEventKind::Act;
+			int heal = 0;
+			if (!target->onAct(act)) {
+				if (act.damage > 0) ev.amount = damageEnemy(*target, act.damage);
+				if (act.mercyAdd > 0.f) target->addMercy(act.mercyAdd);
+				if (act.heal > 0) heal = healHero(actor, act.heal);
+			}
+			out.push_back(ev);
+			if (heal > 0) {
+				TurnEvent healEv = ev;
+				healEv.kind = TurnEventKind::Heal;
+				healEv.target = ev.actor;
+				healEv.amount = heal;
+				out.push_back(healEv);
+			}
+			break; }
+		case ActionType::Item: {
+			// 物品目标为我方角色，越界时夹到合法范围
+			const int heroIdx = std::clamp(cmd.targetIndex, 0, partyCount - 1);
+			ev.target = static_cast<std::int8_t>(heroIdx);
+			const int heal = cmd.itemID.has_value() ? healAmount(*cmd.itemID) : 0;
+			if (heal > 0) {
+				ev.kind = TurnEventKind::ItemUsed;
+				ev.amount = healHero(party[heroIdx], heal);
+			} else {
+				ev.kind = TurnEventKind::ItemNoEffect;
+			}
+			out.push_back(ev);
+			break; }
+		case ActionType::Spare: {
+			if (!target) break;
+			ev.kind = target->trySpare() ? TurnEventKind::Spared : TurnEventKind::SpareFailed;
+			out.push_back(ev);
+			break; }
+		case ActionType::Defend: {
+			actor.defending = true;
+			ev.kind = TurnEventKind::Defend;
+			out.push_back(ev);
+			break; }
+		}
+	}
+}
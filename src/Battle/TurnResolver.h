@@ -0,0 +1,68 @@
+﻿/*
+回合指令结算引擎。
+包含：
+
+每场战斗预解析一次的队伍数值（武器/护甲加成已折算）与治疗物品表
+
+纯函数式的回合结算（只读写传入的队伍与敌人，不访问全局、不含随机）
+
+供 UI 消费的紧凑回合事件列表
+*/
+#pragma once
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Battle/BattleTypes.h"
+#include "Battle/Enemy.h"
+#include "Game/GlobalContext.h"
+
+// 预解析的角色数值：战斗开始时由数据库折算一次，回合内不再查表
+struct ResolvedHeroStats {
+	int attack = 0;  // baseAttack + 武器攻击
+	int defense = 0; // baseDefense + 两件护甲防御
+	int magic = 0;
+};
+
+// 回合事件类型
+enum class TurnEventKind : std::uint8_t {
+	Damage,      // 攻击命中：amount = 敌人实际扣除的 HP
+	Immune,      // 攻击未造成影响（敌人免伤）
+	Act,         // 行动：amount = 通用结算造成的伤害（敌人自定义处理时为 0）
+	Heal,        // 行动附带治疗：target 为我方下标，amount = 实际回复量
+	ItemUsed,    // 使用治疗物品：target 为我方下标，amount = 实际回复量
+	ItemNoEffect,// 物品不在治疗表中：不生效也不消耗
+	Spared,
+	SpareFailed,
+	Defend
+};
+
+// 紧凑回合事件：物品 ID / 行动名等字符串数据通过 command 回查原指令
+struct TurnEvent {
+	TurnEventKind kind = TurnEventKind::Damage;
+	std::uint8_t command = 0; // 来源指令在本回合队列中的下标
+	std::int8_t actor = -1;   // 我方行动者下标
+	std::int8_t target = -1;  // 敌人下标（Heal/ItemUsed 时为我方下标）
+	std::int32_t amount = 0;
+};
+
+class TurnResolver {
+public:
+	// 按队伍当前装备从 Database 折算数值并建立治疗表；每场战斗调用一次
+	void prepare(const std::vector<HeroRuntime>& party);
+
+	const ResolvedHeroStats& heroStats(std::size_t index) const;
+	// 治疗物品的回复量；不在治疗表中返回 0
+	int healAmount(const std::string& itemId) const;
+
+	// 按顺序结算一回合的指令，事件追加到 out。
+	// 纯结算：不访问全局、不消耗背包、不产生随机，相同输入必得相同输出，可供批量模拟复用
+	void resolve(const std::vector<BattleCommand>& commands,
+		std::vector<HeroRuntime>& party,
+		std::vector<Enemy>& enemies,
+		std::vector<TurnEvent>& out) const;
+
+private:
+	std::vector<ResolvedHeroStats> m_heroStats;
+	std::unordered_map<std::string, int> m_healById;
+};
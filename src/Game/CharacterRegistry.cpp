@@ -0,0 +1,59 @@
+﻿#include "CharacterRegistry.h"
+#include <cctype>
+
+std::map<std::string, CharacterSprites> CharacterRegistry::characters;
+
+namespace {
+// 帧序列路径：assets/sprite/<folder>/<name>/<name>_<i>.png，i = 0..count-1
+std::vector<std::string> framePaths(const std::string& folder, const std::string& name, int count) {
+    std::vector<std::string> paths;
+    paths.reserve(static_cast<std::size_t>(count));
+    for (int i = 0; i < count; ++i) {
+        paths.push_back("assets/sprite/" + folder + "/" + name + "/" + name + "_" + std::to_string(i) + ".png");
+    }
+    return paths;
+}
+
+// 行走贴图集：四个方向的资源名依次为 Down/Left/Right/Up，每方向 4 帧
+SpriteSet walkSet(const std::string& folder, const std::array<std::string, 4>& names) {
+    SpriteSet set{};
+    for (std::size_t dir = 0; dir < 4; ++dir) {
+        const auto paths = framePaths(folder, names[dir], 4);
+        for (std::size_t f = 0; f < 4; ++f) set.frames[dir][f] = paths[f];
+    }
+    return set;
+}
+}
+
+void CharacterRegistry::init() {
+    characters["kris"] = {
+        "kris",
+        walkSet("Kris", {"spr_krisd_dark", "spr_krisl_dark", "spr_krisr_dark", "spr_krisu_dark"}),
+        { framePaths("Kris", "spr_krisb_intro", 12), 0.128f },
+        { framePaths("Kris", "spr_krisb_idle", 6), 0.12f },
+        sf::Color(40, 140, 200)
+    };
+    characters["susie"] = {
+        "susie",
+        // 资源名后缀 "_dw" 与美术导出约定一致
+        walkSet("Susie", {"spr_susie_walk_down_dw", "spr_susie_walk_left_dw", "spr_susie_walk_right_dw", "spr_susie_walk_up_dw"}),
+        { framePaths("Susie", "spr_susie_attack", 4), 0.128f },
+        { framePaths("Susie", "spr_susie_idle", 4), 0.14f },
+        sf::Color(200, 60, 160)
+    };
+    characters["ralsei"] = {
+        "ralsei",
+        walkSet("Ralsei", {"spr_ralsei_walk_down", "spr_ralsei_walk_left", "spr_ralsei_walk_right", "spr_ralsei_walk_up"}),
+        { framePaths("Ralsei", "spr_ralsei_battleintro", 11), 0.128f },
+        { framePaths("Ralsei", "spr_ralsei_idle", 5), 0.12f },
+        sf::Color(170, 200, 60)
+    };
+}
+
+const CharacterSprites& CharacterRegistry::get(const std::string& id) {
+    std::string key = id;
+    for (auto& c : key) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    auto it = characters.find(key);
+    if (it != characters.end()) return it->second;
+    return characters.at("kris");
+}
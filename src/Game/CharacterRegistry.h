@@ -0,0 +1,48 @@
+﻿/*
+角色表现数据登记表（按英雄 ID 索引）。
+包含：
+
+探索行走贴图集（四方向 × 4 帧）
+
+战斗入场/待机帧序列
+
+战斗 UI 强调色
+*/
+
+#pragma once
+#include <array>
+#include <map>
+#include <string>
+#include <vector>
+#include <SFML/Graphics/Color.hpp>
+
+// 四个方向各 4 帧的贴图路径（按 Down, Left, Right, Up）
+struct SpriteSet {
+    std::array<std::array<std::string, 4>, 4> frames;
+};
+
+// 一段帧动画：贴图路径序列 + 每帧时长
+struct FrameSequence {
+    std::vector<std::string> paths;
+    float frameTime = 0.12f;
+};
+
+// 单个角色的全部表现资源（与 Database::heroes 使用同一 ID）
+struct CharacterSprites {
+    std::string id;
+    SpriteSet walk;            // 探索行走
+    FrameSequence battleIntro; // 战斗入场（缺失时由 idle 代替）
+    FrameSequence battleIdle;  // 战斗待机
+    sf::Color accent;          // 状态栏边框等强调色
+};
+
+class CharacterRegistry {
+public:
+    static std::map<std::string, CharacterSprites> characters;
+
+    // 登记全部角色（在 Database::init 之后调用）
+    static void init();
+
+    // 按 ID 查询（不区分大小写）；未登记的 ID 回落到 kris，保证新队员至少有可用贴图
+    static const CharacterSprites& get(const std::string& id);
+};
@@ -0,0 +1,136 @@
+﻿#include "Game/Compositor.h"
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+
+//
+// 分层合成器（Compositor）
+// ------------------------
+// 职责：
+// - 每个图层一张常驻 RenderTexture；静态图层内容不变时直接复用上次结果，不再逐个绘制其中的文字与形状
+// - 渐变、淡入淡出、交叉淡化都在合成时以精灵颜色完成，图层本身不重画
+// 关键约定：
+// - 图层清为全透明后按普通 alpha 混合绘制，得到预乘 alpha 的内容；合成时使用 (One, OneMinusSrcAlpha) 叠加，
+//   不透明度以 (a, a, a, a) 的顶点颜色缩放，避免半透明像素被重复乘 alpha 而发暗
+// - RenderTexture 创建失败的图层只输出错误并跳过，其余图层照常合成
+//
+
+namespace {
+const sf::BlendMode kPremultipliedAlpha(sf::BlendMode::Factor::One, sf::BlendMode::Factor::OneMinusSrcAlpha);
+}
+
+Compositor::Compositor(sf::Vector2u size)
+    : m_size(size)
+{
+    for (auto& layer : m_layers) {
+        layer.blend = kPremultipliedAlpha;
+        layer.ready = layer.texture.resize(m_size);
+        if (!layer.ready) {
+            std::cerr << "Compositor: failed to create layer target" << std::endl;
+            continue;
+        }
+        layer.sprite.emplace(layer.texture.getTexture());
+    }
+    m_fadeRect.setSize({ static_cast<float>(m_size.x), static_cast<float>(m_size.y) });
+}
+
+sf::Color Compositor::opacityColor(float opacity)
+{
+    const auto a = static_cast<std::uint8_t>(255.f * std::clamp(opacity, 0.f, 1.f));
+    return sf::Color(a, a, a, a);
+}
+
+void Compositor::setDynamic(Layer layer, bool dynamic)
+{
+    data(layer).dynamic = dynamic;
+}
+
+void Compositor::invalidate(Layer layer)
+{
+    data(layer).dirty = true;
+}
+
+bool Compositor::isDirty(Layer layer) const
+{
+    const LayerData& d = data(layer);
+    return d.dynamic || d.dirty;
+}
+
+void Compositor::render(Layer layer, const DrawFn& fn)
+{
+    LayerData& d = data(layer);
+    if (!d.ready || !fn) return;
+    if (!d.dynamic && !d.dirty) return;
+    d.texture.setView(d.texture.getDefaultView());
+    d.texture.clear(sf::Color::Transparent);
+    fn(d.texture);
+    d.texture.display();
+    d.dirty = false;
+    d.hasContent = true;
+}
+
+void Compositor::setVisible(Layer layer, bool visible)
+{
+    data(layer).visible = visible;
+}
+
+void Compositor::setOpacity(Layer layer, float opacity)
+{
+    LayerData& d = data(layer);
+    d.opacity = std::clamp(opacity, 0.f, 1.f);
+    if (d.sprite) d.sprite->setColor(opacityColor(d.opacity));
+}
+
+void Compositor::setBlendMode(Layer layer, const sf::BlendMode& mode)
+{
+    data(layer).blend = mode;
+}
+
+void Compositor::setBackdrop(std::shared_ptr<const sf::Texture> texture, float opacity)
+{
+    m_backdrop = std::move(texture);
+    m_backdropSprite.reset();
+    if (!m_backdrop) return;
+    m_backdropSprite.emplace(*m_backdrop);
+    setBackdropOpacity(opacity);
+}
+
+void Compositor::setBackdropOpacity(float opacity)
+{
+    if (!m_backdropSprite) return;
+    // 背景贴图是普通（非预乘）内容，按常规 alpha 混合
+    m_backdropSprite->setColor(sf::Color(255, 255, 255, static_cast<std::uint8_t>(255.f * std::clamp(opacity, 0.f, 1.f))));
+}
+
+void Compositor::clearBackdrop()
+{
+    m_backdropSprite.reset();
+    m_backdrop.reset();
+}
+
+void Compositor::setFade(sf::Color color, float amount)
+{
+    m_fadeAmount = std::clamp(amount, 0.f, 1.f);
+    color.a = static_cast<std::uint8_t>(255.f * m_fadeAmount);
+    m_fadeRect.setFillColor(color);
+}
+
+void Compositor::composite(sf::RenderTarget& target)
+{
+    if (m_backdropSprite && m_backdropSprite->getColor().a > 0) {
+        target.draw(*m_backdropSprite);
+    }
+
+    auto drawLayer = [&](Layer layer) {
+        const LayerData& d = data(layer);
+        if (!d.visible || !d.hasContent || !d.sprite || d.opacity <= 0.f) return;
+        target.draw(*d.sprite, sf::RenderStates(d.blend));
+    };
+
+    drawLayer(Layer::World);
+    drawLayer(Layer::UI);
+    if (m_fadeAmount > 0.f) {
+        target.draw(m_fadeRect);
+    }
+    drawLayer(Layer::Overlay);
+}
@@ -0,0 +1,83 @@
+﻿/*
+分层合成器。
+包含：
+
+具名图层（World / UI / Overlay），各自渲染到常驻 RenderTexture
+
+脏标记：静态图层只在内容变化（invalidate）时重画，动态图层每帧重画
+
+合成期效果：图层不透明度 / 混合模式、背景交叉淡化、整屏渐变遮罩（不触发重画）
+*/
+
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <optional>
+
+// 图层按枚举顺序自下而上合成
+enum class Layer : std::size_t {
+    World,   // 地图 / 战斗背景与场景物体
+    UI,      // 对话框、菜单、物品栏
+    Overlay, // 渐变遮罩之上的内容（调试信息等）
+    Count
+};
+
+class Compositor {
+public:
+    using DrawFn = std::function<void(sf::RenderTarget&)>;
+
+    explicit Compositor(sf::Vector2u size = {640u, 480u});
+
+    // 动态图层每帧重画；静态图层（默认）只在 invalidate 后重画
+    void setDynamic(Layer layer, bool dynamic);
+    void invalidate(Layer layer);
+    bool isDirty(Layer layer) const;
+
+    // 需要时（动态或脏）清空图层并调用 fn 重画；fn 使用 640x480 的默认视图
+    void render(Layer layer, const DrawFn& fn);
+
+    // 合成参数（只影响 composite，不重画图层）
+    void setVisible(Layer layer, bool visible);
+    void setOpacity(Layer layer, float opacity);           // 0..1
+    void setBlendMode(Layer layer, const sf::BlendMode& mode); // 默认预乘 alpha 叠加
+
+    // 背景：位于所有图层之下的外部贴图（如上一状态的捕获画面），用于交叉淡化
+    void setBackdrop(std::shared_ptr<const sf::Texture> texture, float opacity = 1.f);
+    void setBackdropOpacity(float opacity);
+    void clearBackdrop();
+
+    // 整屏渐变：在 Overlay 之下、其余图层之上叠加纯色，amount 为 0..1
+    void setFade(sf::Color color, float amount);
+
+    // 按 背景 → World → UI → 渐变 → Overlay 的顺序画到 target（target 需为 640x480 逻辑视图）
+    void composite(sf::RenderTarget& target);
+
+private:
+    struct LayerData {
+        sf::RenderTexture texture;
+        std::optional<sf::Sprite> sprite; // 常驻合成精灵
+        bool ready = false;   // RenderTexture 创建成功
+        bool dynamic = false;
+        bool dirty = true;
+        bool visible = true;
+        bool hasContent = false; // 至少画过一次
+        float opacity = 1.f;
+        sf::BlendMode blend;
+    };
+
+    LayerData& data(Layer layer) { return m_layers[static_cast<std::size_t>(layer)]; }
+    const LayerData& data(Layer layer) const { return m_layers[static_cast<std::size_t>(layer)]; }
+    static sf::Color opacityColor(float opacity);
+
+    sf::Vector2u m_size;
+    std::array<LayerData, static_cast<std::size_t>(Layer::Count)> m_layers;
+
+    std::shared_ptr<const sf::Texture> m_backdrop;
+    std::optional<sf::Sprite> m_backdropSprite;
+
+    sf::RectangleShape m_fadeRect;
+    float m_fadeAmount = 0.f;
+};
@@ -5,6 +5,7 @@ std::map<std::string, Hero> Database::heroes;
 std::map<std::string, Weapon> Database::weapons;
 std::map<std::string, Armor> Database::armors;
 std::map<std::string, HellingItem> Database::hellingItems;
+std::map<std::string, ItemData> Database::items;
 
 
 void Database::init() {
@@ -22,6 +23,11 @@ void Database::init() {
     // 初始化治疗物品数据
     hellingItems["potion"] = {"potion", L"小型治疗药水", 50};
     hellingItems["luojia_drink"] = {"luojia_drink", L"珞珈饮品", 80};
+
+    // 初始化物品展示数据（背包/战斗菜单共用）
+    items["potion"] = {"potion", L"小型治疗药水", L"恢复50点生命值。"};
+    items["luojia_drink"] = {"luojia_drink", L"珞珈饮品", L"恢复80点生命值。"};
+    items["HolyMantle"] = {"HolyMantle", L"神圣斗篷", L"免疫每回合第一次受伤。"};
     
     // 初始化英雄数据
     heroes["kris"] = { 
@@ -62,4 +68,10 @@ void Database::init() {
     };
 }
 
-
+const ItemData& Database::itemData(const std::string& id) {
+    auto it = items.find(id);
+    if (it != items.end()) return it->second;
+    // std::map 节点地址稳定，补登后返回的引用可被背包长期持有
+    ItemData fallback{ id, sf::String::fromUtf8(id.begin(), id.end()), sf::String() };
+    return items.emplace(id, std::move(fallback)).first->second;
+}
@@ -31,6 +31,14 @@ struct HellingItem
     int healAmount;
 };
 
+//定义物品展示数据结构体（名称与说明只在数据库中保存一份，背包按 ID 引用）
+struct ItemData
+{
+    std::string id;
+    sf::String name;
+    sf::String info;
+};
+
 //定义小队成员结构体
 struct Hero
 {
@@ -52,8 +60,12 @@ public:
     static std::map<std::string, Weapon> weapons;
     static std::map<std::string, Armor> armors;
     static std::map<std::string, HellingItem> hellingItems;
+    static std::map<std::string, ItemData> items;
 
     // 初始化数据库（加载数据）
     static void init();
+
+    // 查询物品展示数据：未登记的 ID 以 ID 本身作为名称补登一条（兼容旧存档中的未知物品）
+    static const ItemData& itemData(const std::string& id);
 };
 
@@ -2,7 +2,10 @@
 #include "States/TitleState.h"
 #include "Manager/AudioManager.h"
 #include "Game/Database.h"
+#include "Game/CharacterRegistry.h"
 #include "Game/GlobalContext.h"
+#include "Game/SaveManager.h"
+#include "Utils/JobSystem.h"
 
 Game::Game()
     : m_window(sf::VideoMode({640, 480}), "WHUDR Game Window"),
@@ -18,6 +21,8 @@ Game::Game()
     m_window.setView(m_view);
     // 初始化数据库（武器/护甲/英雄基础数据）
     Database::init();
+    // 初始化角色表现数据（行走/战斗贴图与强调色）
+    CharacterRegistry::init();
 
     // 初始化全局三人实际数据（若尚未由读档覆盖）
     if (Global::partyHeroes.empty()) {
@@ -49,8 +54,7 @@ Game::Game()
 
     // 初始给予两瓶珞珈饮品（仅在新游戏时生效：inventory 为空）
     if (Global::inventory.empty()) {
-        Global::inventory.push_back(InventoryItem{ "luojia_drink", sf::String(L"珞珈饮品"), sf::String(L"恢复80点生命值。") });
-        Global::inventory.push_back(InventoryItem{ "luojia_drink", sf::String(L"珞珈饮品"), sf::String(L"恢复80点生命值。") });
+        Global::inventory.add("luojia_drink", 2);
     }
 
     // 初始状态为标题界面
@@ -68,15 +72,32 @@ Game::Game()
 
 void Game::run() {
     sf::Clock clock;
+    JobSystem& jobs = JobSystem::getInstance();
     while (m_window.isOpen()) {
+        // 执行已就绪的主线程任务（例如预加载房间的贴图上传）
+        jobs.pumpMainThread();
+
+        // 帧边界：过渡完成则入栈新状态，再执行本帧之前提交的切换请求
+        TransitionMode mode = TransitionMode::Push;
+        if (auto next = m_transition.poll(mode)) {
+            switch (mode) {
+                case TransitionMode::Push:   pushState(std::move(next)); break;
+                case TransitionMode::Change: changeState(std::move(next)); break;
+                case TransitionMode::Reset:  resetStates(std::move(next)); break;
+            }
+        }
+        if (!m_pendingOps.empty()) {
+            applyPendingStates();
+            clock.restart(); // 构造新状态的耗时不计入下一帧 dt
+        }
         sf::Time dt = clock.restart();
         
         if (!m_states.empty()) {
             // 永远只操作栈顶的那个状态
-            // m_states.top()->handleEvent();
+            BaseState& top = *m_states.back();
             while (const std::optional<sf::Event> event = m_window.pollEvent()) {
                 // 这里可以把事件传给当前状态处理输入
-                m_states.top()->handleEvent();
+                top.handleEvent();
                 
                 if (event->is<sf::Event::Closed>()) {
                     m_window.close();
@@ -87,19 +108,21 @@ void Game::run() {
                     m_window.setView(m_view);
                 }
             }
-            m_states.top()->update(dt.asSeconds());
+            top.update(dt.asSeconds());
             
             // 先清屏为黑色，露出上下/左右黑边
             m_window.clear(sf::Color::Black);
             // 确保使用 letterbox 视图进行绘制
             m_window.setView(m_view);
-            m_states.top()->draw(m_window);
+            top.draw(m_window);
             m_window.display();
         }
     }
 
     // 清理播放完的音效
     AudioManager::getInstance().update();
+    // 退出前确保存档已写入磁盘
+    SaveManager::flush();
 }
 
 // 计算 letterbox 视口：把 640x480 的内容画进窗口居中的 4:3 区域
@@ -128,27 +151,77 @@ void Game::updateViewViewport(unsigned int winW, unsigned int winH) {
     m_view.setViewport(viewport);
 }
 
-// ... pushState 等函数的实现 ...
-void Game::pushState(std::unique_ptr<BaseState> state) { m_states.push(std::move(state)); }
+// 状态切换请求：先排队，帧边界由 applyPendingStates 执行
+void Game::pushState(std::unique_ptr<BaseState> state) {
+    m_pendingOps.push_back({ PendingStateOp::Kind::Push, std::move(state) });
+}
 
 void Game::popState() {
-    if (!m_states.empty()) {
-        m_states.pop();
-    }
+    m_pendingOps.push_back({ PendingStateOp::Kind::Pop, nullptr });
 }
 
 void Game::changeState(std::unique_ptr<BaseState> state) {
-    if (!m_states.empty()) {
-        m_states.pop();
+    m_pendingOps.push_back({ PendingStateOp::Kind::Change, std::move(state) });
+}
+
+void Game::resetStates(std::unique_ptr<BaseState> state) {
+    m_pendingOps.push_back({ PendingStateOp::Kind::Reset, std::move(state) });
+}
+
+bool Game::transitionTo(StateTransition::Factory factory, std::vector<std::string> preloadPaths, TransitionMode mode) {
+    return m_transition.begin(std::move(factory), std::move(preloadPaths), mode);
+}
+
+// 按提交顺序执行切换，并调用生命周期钩子：
+// - Push：栈顶 onSuspend → 新状态 onEnter
+// - Pop：栈顶 onExit 后销毁 → 新栈顶 onResume
+// - Change：栈顶 onExit 后销毁 → 新状态 onEnter（下层挂起的状态不受影响）
+// - Reset：自顶向下逐个 onExit 并销毁 → 新状态 onEnter
+void Game::applyPendingStates() {
+    // 钩子中可能再次提交请求，先取出本批
+    std::vector<PendingStateOp> ops = std::move(m_pendingOps);
+    m_pendingOps.clear();
+
+    for (auto& op : ops) {
+        if (op.kind != PendingStateOp::Kind::Pop && !op.state) continue;
+        switch (op.kind) {
+            case PendingStateOp::Kind::Push:
+                if (!m_states.empty()) m_states.back()->onSuspend();
+                m_states.push_back(std::move(op.state));
+                m_states.back()->onEnter();
+                break;
+            case PendingStateOp::Kind::Pop:
+                if (m_states.empty()) break;
+                m_states.back()->onExit();
+                m_states.pop_back();
+                if (!m_states.empty()) m_states.back()->onResume();
+                break;
+            case PendingStateOp::Kind::Change:
+                if (!m_states.empty()) {
+                    m_states.back()->onExit();
+                    m_states.pop_back();
+                }
+                m_states.push_back(std::move(op.state));
+                m_states.back()->onEnter();
+                break;
+            case PendingStateOp::Kind::Reset:
+                while (!m_states.empty()) {
+                    m_states.back()->onExit();
+                    m_states.pop_back();
+                }
+                m_states.push_back(std::move(op.state));
+                m_states.back()->onEnter();
+                break;
+        }
     }
-    m_states.push(std::move(state));
 }
 
 sf::RenderWindow& Game::getWindow() { return m_window; }
 
 Game::~Game() {
     // 自动清理栈中的状态
+    m_pendingOps.clear();
     while (!m_states.empty()) {
-        m_states.pop();
+        m_states.pop_back();
     }
 }
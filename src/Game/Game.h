@@ -1,16 +1,27 @@
 ﻿#pragma once
 #include <SFML/Graphics.hpp>
 #include <SFML/Audio.hpp>
-#include <stack>
 #include <memory> // 用于 std::unique_ptr
+#include <vector>
 #include "States/BaseState.h"
+#include "Game/StateTransition.h"
 
 class Game {
 private:
     sf::RenderWindow m_window;
     sf::View m_view; // 固定 640x480 的游戏视图（用于 Letterboxing）
-    // 使用栈来管理状态：栈顶就是当前显示的画面
-    std::stack<std::unique_ptr<BaseState>> m_states;
+    // 使用栈来管理状态：栈顶就是当前显示的画面，下层状态挂起（不更新、不绘制，资源保留）
+    std::vector<std::unique_ptr<BaseState>> m_states;
+
+    // 状态切换请求在帧边界统一执行，避免状态在自身 update/handleEvent 中被销毁
+    struct PendingStateOp {
+        enum class Kind { Push, Pop, Change, Reset } kind;
+        std::unique_ptr<BaseState> state;
+    };
+    std::vector<PendingStateOp> m_pendingOps;
+    StateTransition m_transition; // 后台预解码下一状态的资源
+
+    void applyPendingStates();
 
     // 根据窗口大小更新视口以实现 4:3 信箱黑边
     void updateViewViewport(unsigned int winW, unsigned int winH);
@@ -21,10 +32,16 @@ public:
 
     void run();  // 主循环
 
-    // 状态管理函数
-    void pushState(std::unique_ptr<BaseState> state);
-    void popState();
+    // 状态管理函数（均延迟到本帧结束后执行）
+    void pushState(std::unique_ptr<BaseState> state);    // 压栈，当前状态挂起
+    void popState();                                     // 出栈，下层状态恢复
     void changeState(std::unique_ptr<BaseState> state);  // 替换当前状态
+    void resetStates(std::unique_ptr<BaseState> state);  // 清空整个栈后压入
+    // 过渡：后台解码 preloadPaths 中的图片，完成后在主线程调用 factory 构造新状态并按 mode 入栈
+    // 期间当前状态照常运行；已有过渡进行中时返回 false
+    bool transitionTo(StateTransition::Factory factory, std::vector<std::string> preloadPaths,
+                      TransitionMode mode = TransitionMode::Push);
+    bool isTransitioning() const { return m_transition.active(); }
 
     sf::RenderWindow& getWindow();  // 让 State 能获取窗口来画图
     sf::Texture ralseiFaceTexture; // 预加载的 Ralsei 头像纹理
@@ -17,12 +17,7 @@
 #include <array>
 #include <SFML/System/String.hpp>
 #include "Database.h"
-
-struct InventoryItem {
-    std::string id;
-    sf::String name;
-    sf::String info;
-};
+#include "Inventory.h"
 
 // 运行时英雄数据（会参与存档）
 struct HeroRuntime {
@@ -45,7 +40,7 @@ struct Global
     static inline std::string playerName = "player";      //玩家名称
     static inline std::string currentMRoomName = "Title"; //当前地图名称    
     static inline int money = 0;                          //钱
-    static inline std::vector<InventoryItem> inventory;   //物品（含描述）
+    static inline Inventory inventory;                    //物品（按 ID 堆叠，描述见 Database::items）
     static inline bool hasHolyMantle = false;           // 是否已获得 HolyMantle
     static inline std::vector<HeroRuntime> partyHeroes; // 三人实际数据（会存档）
 };
@@ -0,0 +1,111 @@
+﻿#include "Inventory.h"
+#include <algorithm>
+
+//
+// 背包（Inventory）
+// ----------------
+// 职责：
+// - 以堆叠形式保存物品：同 ID 只占一个条目，名称/说明由 Database::items 提供
+// - 为 BattleMenu 与 OverworldState 提供统一的增减与占用接口
+// 关键约定：
+// - m_index 始终与 m_stacks 下标同步；只有堆叠被移除时才需要整体重建
+// - 占用数不会超过持有数（remove 时会同步裁剪）
+//
+
+Inventory::Stack* Inventory::find(const std::string& id)
+{
+    auto it = m_index.find(id);
+    return it == m_index.end() ? nullptr : &m_stacks[it->second];
+}
+
+const Inventory::Stack* Inventory::find(const std::string& id) const
+{
+    auto it = m_index.find(id);
+    return it == m_index.end() ? nullptr : &m_stacks[it->second];
+}
+
+void Inventory::eraseStack(std::size_t index)
+{
+    m_stacks.erase(m_stacks.begin() + static_cast<std::ptrdiff_t>(index));
+    // 保持显示顺序不变，后续堆叠下标整体前移
+    m_index.clear();
+    for (std::size_t i = 0; i < m_stacks.size(); ++i) {
+        m_index.emplace(m_stacks[i].id(), i);
+    }
+}
+
+void Inventory::add(const std::string& id, int amount)
+{
+    if (id.empty() || amount <= 0) return;
+    if (Stack* s = find(id)) {
+        s->count += amount;
+        return;
+    }
+    m_index.emplace(id, m_stacks.size());
+    m_stacks.push_back(Stack{ &Database::itemData(id), amount, 0 });
+}
+
+bool Inventory::remove(const std::string& id, int amount)
+{
+    auto it = m_index.find(id);
+    if (it == m_index.end() || amount <= 0) return false;
+    Stack& s = m_stacks[it->second];
+    if (s.count < amount) return false;
+    s.count -= amount;
+    s.reserved = std::min(s.reserved, s.count);
+    if (s.count == 0) eraseStack(it->second);
+    return true;
+}
+
+bool Inventory::consume(const std::string& id)
+{
+    Stack* s = find(id);
+    if (!s) return false;
+    if (s->reserved > 0) s->reserved -= 1;
+    return remove(id, 1);
+}
+
+void Inventory::clear()
+{
+    m_stacks.clear();
+    m_index.clear();
+}
+
+bool Inventory::reserve(const std::string& id)
+{
+    Stack* s = find(id);
+    if (!s || s->available() <= 0) return false;
+    s->reserved += 1;
+    return true;
+}
+
+void Inventory::release(const std::string& id)
+{
+    if (Stack* s = find(id)) {
+        s->reserved = std::max(0, s->reserved - 1);
+    }
+}
+
+void Inventory::clearReservations()
+{
+    for (auto& s : m_stacks) s.reserved = 0;
+}
+
+int Inventory::count(const std::string& id) const
+{
+    const Stack* s = find(id);
+    return s ? s->count : 0;
+}
+
+int Inventory::available(const std::string& id) const
+{
+    const Stack* s = find(id);
+    return s ? s->available() : 0;
+}
+
+int Inventory::totalCount() const
+{
+    int total = 0;
+    for (const auto& s : m_stacks) total += s.count;
+    return total;
+}
@@ -0,0 +1,62 @@
+﻿/*
+背包容器。
+包含：
+
+按 (物品ID, 数量) 堆叠存储
+
+战斗菜单的物品占用（reserve）
+
+显示数据引用自 Database::items
+*/
+
+#pragma once
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include "Database.h"
+
+class Inventory {
+public:
+    // 一种物品的堆叠：展示数据只存指针，数量与占用数各一个整数
+    struct Stack {
+        const ItemData* item = nullptr; // 指向 Database::items 中的条目
+        int count = 0;                  // 持有数量
+        int reserved = 0;               // 战斗菜单本回合已占用的数量
+
+        const std::string& id() const { return item->id; }
+        int available() const { return count - reserved; }
+    };
+
+    // 增减：按 ID 定位堆叠，均为 O(1)；堆叠清空时才会移除并重建索引
+    void add(const std::string& id, int amount = 1);
+    bool remove(const std::string& id, int amount = 1);
+    // 消耗一件已占用的物品（战斗结算用）：数量与占用数同时减一
+    bool consume(const std::string& id);
+    void clear();
+
+    // 战斗菜单占用：选择物品时 reserve，撤销/取消时 release，新回合与退出战斗时 clearReservations
+    bool reserve(const std::string& id);
+    void release(const std::string& id);
+    void clearReservations();
+
+    // 查询
+    int count(const std::string& id) const;
+    int available(const std::string& id) const;
+    bool contains(const std::string& id) const { return count(id) > 0; }
+    int totalCount() const;
+
+    // 按获得顺序遍历堆叠（UI 列表）
+    std::size_t size() const { return m_stacks.size(); }
+    bool empty() const { return m_stacks.empty(); }
+    const Stack& operator[](std::size_t index) const { return m_stacks[index]; }
+    std::vector<Stack>::const_iterator begin() const { return m_stacks.begin(); }
+    std::vector<Stack>::const_iterator end() const { return m_stacks.end(); }
+
+private:
+    Stack* find(const std::string& id);
+    const Stack* find(const std::string& id) const;
+    void eraseStack(std::size_t index);
+
+    std::vector<Stack> m_stacks;                          // 显示顺序
+    std::unordered_map<std::string, std::size_t> m_index; // ID -> m_stacks 下标
+};
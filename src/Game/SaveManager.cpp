@@ -2,6 +2,7 @@
 #include "GlobalContext.h"
 #include "Database.h"
 #include "Manager/AudioManager.h"
+#include "Utils/JobSystem.h"
 #include <algorithm>
 #include <fstream>
 #include <filesystem>
@@ -15,24 +16,8 @@ using json = nlohmann::json; //以此简化代码，不用每次都写很长
 namespace fs = std::filesystem;
 
 namespace {
-InventoryItem makeInventoryItemFromId(const std::string& id) {
-    InventoryItem item;
-    item.id = id;
-    if (id == "HolyMantle") {
-        item.name = sf::String(L"神圣斗篷");
-        item.info = sf::String(L"免疫每回合第一次受伤。");
-    } else if (id == "luojia_drink") {
-        item.name = sf::String(L"珞珈饮品");
-        item.info = sf::String(L"恢复80点生命值。");
-    } else if (id == "potion") {
-        item.name = sf::String(L"小型治疗药水");
-        item.info = sf::String(L"恢复50点生命值。");
-    } else {
-        item.name = sf::String::fromUtf8(id.begin(), id.end());
-        item.info = sf::String();
-    }
-    return item;
-}
+// 最近一次提交的写盘任务；新的写盘任务依赖它，连续保存按提交顺序落盘（只在主线程读写）
+JobSystem::CounterPtr s_pendingWrite;
 }
 
 // 获取存档文件路径的辅助函数
@@ -53,10 +38,12 @@ void SaveManager::saveGame(int slotId) {
     j["player_name"] = Global::playerName;
     j["current_room"] = Global::currentMRoomName;
     j["money"] = Global::money;
-    // 序列化物品（仅存 id）
+    // 序列化物品（仅存 id，堆叠按数量展开，保持与旧存档格式一致）
     json invArr = json::array();
-    for (const auto& it : Global::inventory) {
-        invArr.push_back(it.id);
+    for (const auto& stack : Global::inventory) {
+        for (int i = 0; i < stack.count; ++i) {
+            invArr.push_back(stack.id());
+        }
     }
     j["inventory"] = invArr;
     j["has_holy_mantle"] = Global::hasHolyMantle;
@@ -81,19 +68,28 @@ void SaveManager::saveGame(int slotId) {
     }
     j["party"] = std::move(partyArr);
 
-    // -----------------------------3. 写入文件-----------------------------
-    std::ofstream file(getFilePath(slotId));
-    if (file.is_open()) {
-        // dump(4) 的意思是缩进 4 个空格，这样生成的 JSON 很好看，方便人眼阅读
-        file << j.dump(4); 
-        file.close();
-        std::cout << "Saved JSON to slot " << slotId << std::endl;
-    }
+    // -----------------------------3. 写入文件（工作线程）-----------------------------
+    auto write = [path = getFilePath(slotId), j = std::move(j), slotId] {
+        std::ofstream file(path);
+        if (file.is_open()) {
+            // dump(4) 的意思是缩进 4 个空格，这样生成的 JSON 很好看，方便人眼阅读
+            file << j.dump(4);
+            file.close();
+            std::cout << "Saved JSON to slot " << slotId << std::endl;
+        }
+    };
+    s_pendingWrite = JobSystem::getInstance().schedule(std::move(write), s_pendingWrite);
+}
+
+void SaveManager::flush() {
+    JobSystem::getInstance().wait(s_pendingWrite);
+    s_pendingWrite.reset();
 }
 
 //########################################### 加载游戏 ##########################################
 bool SaveManager::loadGame(int slotId) {
     AudioManager::getInstance().playSound("save");
+    flush();
 
     std::ifstream file(getFilePath(slotId));
     if (!file.is_open()) return false;
@@ -117,7 +113,7 @@ bool SaveManager::loadGame(int slotId) {
                 if (!el.is_string()) continue;
                 std::string id = el.get<std::string>();
                 if (id.empty()) continue;
-                Global::inventory.push_back(makeInventoryItemFromId(id));
+                Global::inventory.add(id);
             }
         }
 
@@ -165,6 +161,7 @@ bool SaveManager::loadGame(int slotId) {
 // 获取预览信息
 SavePreview SaveManager::getSavePreview(int slotId) {
     SavePreview info;
+    flush();
     std::ifstream file(getFilePath(slotId));
     if (file.is_open()) {
         try {
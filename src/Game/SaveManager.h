@@ -2,7 +2,7 @@
 管理存档系统。
 包含：
 
-保存队伍数据
+保存队伍数据（主线程序列化，任务系统写盘）
 
 读取游戏进度
 */
@@ -22,8 +22,12 @@ class SaveManager {
 public:
 
     // 保存游戏 (传入存档槽位，比如 0, 1, 2)
+    // 立即在主线程取好数据快照，写文件交给工作线程，不阻塞当前帧
     static void saveGame(int slotId);
 
+    // 等待已提交的存档全部写完（读档、读预览与退出前调用）
+    static void flush();
+
     // 加载游戏
     static bool loadGame(int slotId);
 
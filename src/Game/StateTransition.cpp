@@ -0,0 +1,82 @@
+﻿#include "Game/StateTransition.h"
+#include <iostream>
+#include <unordered_set>
+
+//
+// 状态过渡（StateTransition）
+// ---------------------------
+// 职责：
+// - begin 为下一个状态的每张图片提交一个解码任务，当前状态照常更新与绘制
+// - poll 在解码完成后于主线程调用 factory 构造状态；构造中的 loadTexture 命中预解码图片，免去磁盘读取与解码
+// 关键约定：
+// - 与 RoomCache 一致：工作线程只接触文件与 sf::Image，sf::Texture 全部在主线程创建
+// - 预解码图片只在本次构造期间有效，构造结束即释放
+//
+
+const StateTransition::ImageMap* StateTransition::s_images = nullptr;
+
+bool StateTransition::begin(Factory factory, std::vector<std::string> preloadPaths, TransitionMode mode)
+{
+    if (active() || !factory) return false;
+    m_factory = std::move(factory);
+    m_mode = mode;
+
+    auto decoding = std::make_shared<Decoding>();
+    std::unordered_set<std::string> seen;
+    for (auto& path : preloadPaths) {
+        if (seen.insert(path).second) decoding->paths.push_back(std::move(path));
+    }
+    decoding->images.resize(decoding->paths.size());
+
+    // 工作线程：各解码一张图片，失败的路径留空（构造时回落到直接读文件）
+    JobSystem& jobs = JobSystem::getInstance();
+    JobSystem::CounterPtr decoded;
+    for (std::size_t i = 0; i < decoding->paths.size(); ++i) {
+        decoded = jobs.schedule([decoding, i] {
+            sf::Image image;
+            if (!image.loadFromFile(decoding->paths[i])) {
+                std::cerr << "StateTransition: failed to decode " << decoding->paths[i] << std::endl;
+                return;
+            }
+            decoding->images[i] = std::move(image);
+        }, nullptr, JobSystem::Affinity::Any, decoded);
+    }
+    m_decoding = std::move(decoding);
+    m_decoded = std::move(decoded);
+    return true;
+}
+
+std::unique_ptr<BaseState> StateTransition::poll(TransitionMode& outMode)
+{
+    if (!active()) return nullptr;
+    if (m_decoded && !m_decoded->done()) return nullptr;
+
+    ImageMap images;
+    if (m_decoding) {
+        images.reserve(m_decoding->paths.size());
+        for (std::size_t i = 0; i < m_decoding->paths.size(); ++i) {
+            if (m_decoding->images[i]) images.emplace(std::move(m_decoding->paths[i]), std::move(*m_decoding->images[i]));
+        }
+    }
+    m_decoding.reset();
+    m_decoded.reset();
+    Factory factory = std::move(m_factory);
+    m_factory = nullptr;
+
+    s_images = &images;
+    std::unique_ptr<BaseState> state = factory();
+    s_images = nullptr;
+
+    outMode = m_mode;
+    return state;
+}
+
+bool StateTransition::loadTexture(sf::Texture& texture, const std::string& path)
+{
+    if (s_images) {
+        if (auto it = s_images->find(path); it != s_images->end()) {
+            return texture.loadFromImage(it->second);
+        }
+    }
+    return texture.loadFromFile(path);
+}
@@ -0,0 +1,63 @@
+﻿/*
+状态切换过渡。
+包含：
+
+在任务系统上并行预解码下一个状态用到的图片（每张一个任务，只生成 sf::Image，不接触 OpenGL）
+
+解码完成后在主线程构造状态，构造期间贴图优先从预解码图片上传
+
+切换方式（压栈 / 替换栈顶 / 清空重建）
+*/
+
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "States/BaseState.h"
+#include "Utils/JobSystem.h"
+
+// 新状态进入栈的方式
+enum class TransitionMode {
+    Push,   // 压在当前状态之上，当前状态挂起（保留资源）
+    Change, // 替换栈顶
+    Reset   // 清空整个栈后压入
+};
+
+class StateTransition {
+public:
+    using Factory = std::function<std::unique_ptr<BaseState>()>;
+
+    StateTransition() = default;
+    StateTransition(const StateTransition&) = delete;
+    StateTransition& operator=(const StateTransition&) = delete;
+
+    // 开始过渡：在任务系统上解码 preloadPaths；已有过渡进行中时返回 false
+    bool begin(Factory factory, std::vector<std::string> preloadPaths, TransitionMode mode);
+    bool active() const { return static_cast<bool>(m_factory); }
+
+    // 主线程每帧调用：解码完成时构造新状态并返回（outMode 为切换方式），否则返回 nullptr
+    std::unique_ptr<BaseState> poll(TransitionMode& outMode);
+
+    // 加载贴图：处于过渡构造期间且图片已预解码时直接上传，否则从文件读取
+    static bool loadTexture(sf::Texture& texture, const std::string& path);
+
+private:
+    using ImageMap = std::unordered_map<std::string, sf::Image>;
+
+    // 解码结果：每条路径一个槽位，只由对应的任务写入；由任务共同持有，过渡对象先析构也不会悬空
+    struct Decoding {
+        std::vector<std::string> paths;
+        std::vector<std::optional<sf::Image>> images;
+    };
+
+    Factory m_factory;
+    TransitionMode m_mode = TransitionMode::Push;
+    std::shared_ptr<Decoding> m_decoding;
+    JobSystem::CounterPtr m_decoded; // 全部解码任务计入同一个计数器；为空表示无需解码
+
+    static const ImageMap* s_images; // 仅在 poll 调用 factory 期间指向已解码图片
+};
@@ -1,5 +0,0 @@
-﻿#pragma once
-#include "Overworld/Map.h"
-
-// 构建第一个房间：AlphysClass
-void buildAlphysClass(GameMap& map);
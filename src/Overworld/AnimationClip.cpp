@@ -0,0 +1,107 @@
+﻿#include "Overworld/AnimationClip.h"
+#include "Game/CharacterRegistry.h"
+#include <algorithm>
+#include <iostream>
+
+//
+// 动画片段库（AnimationLibrary）
+// ------------------------------
+// 职责：
+// - 把一组帧图片打包为一张图集：每个片段占一行，帧之间留 1 像素间隙防止采样串色
+// - 预计算每帧的图集矩形、尺寸与底边中心原点，播放时只需 setTextureRect + setOrigin
+// - 按 key 缓存片段集（shared_ptr），同一角色的所有实例共享同一张 GPU 贴图
+// 关键约定：
+// - 加载失败的帧使用 19x40 的兜底尺寸与空矩形，保证碰撞箱/排序等逻辑仍有合理数值
+// - 图集在主线程创建（涉及贴图上传）
+//
+
+std::map<std::string, std::shared_ptr<const ClipSet>> AnimationLibrary::s_sets;
+
+namespace {
+constexpr unsigned kPadding = 1;
+const sf::Vector2u kFallbackSize{19u, 40u};
+}
+
+const ClipFrame& ClipSet::frame(int clip, int index) const
+{
+    static const ClipFrame kEmpty{ {}, { static_cast<float>(kFallbackSize.x), static_cast<float>(kFallbackSize.y) },
+                                   { static_cast<float>(kFallbackSize.x) * 0.5f, static_cast<float>(kFallbackSize.y) } };
+    if (clips.empty()) return kEmpty;
+    const auto& c = clips[static_cast<std::size_t>(std::clamp(clip, 0, static_cast<int>(clips.size()) - 1))];
+    if (c.frames.empty()) return kEmpty;
+    return c.frames[static_cast<std::size_t>(std::clamp(index, 0, static_cast<int>(c.frames.size()) - 1))];
+}
+
+std::shared_ptr<const ClipSet> AnimationLibrary::walk(const std::string& characterId)
+{
+    const CharacterSprites& sprites = CharacterRegistry::get(characterId);
+    const std::string key = "walk:" + sprites.id;
+    if (auto it = s_sets.find(key); it != s_sets.end()) return it->second;
+
+    std::vector<std::vector<std::string>> clipPaths;
+    for (const auto& dir : sprites.walk.frames) {
+        clipPaths.emplace_back(dir.begin(), dir.end());
+    }
+    return load(key, clipPaths);
+}
+
+std::shared_ptr<const ClipSet> AnimationLibrary::load(const std::string& key,
+                                                      const std::vector<std::vector<std::string>>& clipPaths)
+{
+    if (auto it = s_sets.find(key); it != s_sets.end()) return it->second;
+
+    // 1. 解码全部帧并计算图集尺寸（每个片段一行）
+    std::vector<std::vector<sf::Image>> images(clipPaths.size());
+    sf::Vector2u atlasSize{0u, 0u};
+    for (std::size_t c = 0; c < clipPaths.size(); ++c) {
+        unsigned rowW = 0, rowH = 0;
+        images[c].resize(clipPaths[c].size());
+        for (std::size_t f = 0; f < clipPaths[c].size(); ++f) {
+            if (!images[c][f].loadFromFile(clipPaths[c][f])) {
+                std::cerr << "AnimationLibrary: failed to load " << clipPaths[c][f] << std::endl;
+                continue;
+            }
+            const sf::Vector2u s = images[c][f].getSize();
+            rowW += s.x + kPadding;
+            rowH = std::max(rowH, s.y);
+        }
+        atlasSize.x = std::max(atlasSize.x, rowW);
+        atlasSize.y += rowH + kPadding;
+    }
+
+    // 2. 拷贝到图集并记录每帧矩形
+    auto set = std::make_shared<ClipSet>();
+    set->clips.resize(clipPaths.size());
+    sf::Image atlas({ std::max(1u, atlasSize.x), std::max(1u, atlasSize.y) }, sf::Color::Transparent);
+    unsigned y = 0;
+    for (std::size_t c = 0; c < images.size(); ++c) {
+        unsigned x = 0, rowH = 0;
+        for (const auto& img : images[c]) {
+            const sf::Vector2u s = img.getSize();
+            ClipFrame frame;
+            if (s.x == 0u || s.y == 0u) {
+                frame.size = { static_cast<float>(kFallbackSize.x), static_cast<float>(kFallbackSize.y) };
+            } else {
+                if (!atlas.copy(img, { x, y })) {
+                    std::cerr << "AnimationLibrary: atlas copy failed for " << key << std::endl;
+                }
+                frame.rect = sf::IntRect({ static_cast<int>(x), static_cast<int>(y) }, { static_cast<int>(s.x), static_cast<int>(s.y) });
+                frame.size = { static_cast<float>(s.x), static_cast<float>(s.y) };
+                x += s.x + kPadding;
+                rowH = std::max(rowH, s.y);
+            }
+            frame.origin = { frame.size.x * 0.5f, frame.size.y };
+            set->clips[c].frames.push_back(frame);
+        }
+        y += rowH + kPadding;
+    }
+
+    if (!set->atlas.loadFromImage(atlas)) {
+        std::cerr << "AnimationLibrary: failed to upload atlas " << key << std::endl;
+    }
+    set->atlas.setSmooth(false);
+
+    std::shared_ptr<const ClipSet> shared = std::move(set);
+    s_sets.emplace(key, shared);
+    return shared;
+}
@@ -0,0 +1,53 @@
+﻿/*
+精灵动画片段库。
+包含：
+
+图集（同一角色的全部帧打包进一张贴图）
+
+动画片段（每帧的图集矩形 / 尺寸 / 原点，加载时算好）
+
+按角色 ID 共享的行走片段集（同外观的队员与 NPC 共用一张贴图）
+*/
+
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+// 单帧：图集中的矩形与预计算的尺寸/原点（原点取底边中心）
+struct ClipFrame {
+    sf::IntRect rect;
+    sf::Vector2f size{0.f, 0.f};
+    sf::Vector2f origin{0.f, 0.f};
+};
+
+struct AnimationClip {
+    std::vector<ClipFrame> frames;
+};
+
+// 共用一张图集的一组片段（行走：按 Down/Left/Right/Up 四个片段）
+struct ClipSet {
+    sf::Texture atlas;
+    std::vector<AnimationClip> clips;
+
+    // 越界时钳制到有效范围；没有任何帧时返回空帧
+    const ClipFrame& frame(int clip, int index) const;
+};
+
+class AnimationLibrary {
+public:
+    // 角色行走片段：路径取自 CharacterRegistry，首次请求时打包图集并常驻（需在主线程调用）
+    static std::shared_ptr<const ClipSet> walk(const std::string& characterId);
+
+    // 通用入口：按 key 缓存；每个片段一行帧路径，缺失的帧以兜底尺寸占位
+    static std::shared_ptr<const ClipSet> load(const std::string& key,
+                                               const std::vector<std::vector<std::string>>& clipPaths);
+
+    // 释放全部图集（已被持有的片段集不受影响）
+    static void clear() { s_sets.clear(); }
+
+private:
+    static std::map<std::string, std::shared_ptr<const ClipSet>> s_sets;
+};
@@ -0,0 +1,73 @@
+﻿#include "Overworld/Camera.h"
+#include <algorithm>
+#include <cmath>
+
+//
+// 摄像机（Camera）
+// ----------------
+// 职责：
+// - 跟随队长：目标离开死区时，期望中心只移动到让目标回到死区边缘
+// - 以帧率无关的指数平滑逼近期望中心：alpha = 1 - exp(-rate * dt)
+// - 限制在房间范围内；房间小于视野的方向上固定居中（旧的 640x480 房间即保持不动）
+//
+
+Camera::Camera(const sf::Vector2f& viewSize)
+    : m_viewSize(viewSize),
+      m_center(viewSize * 0.5f),
+      m_goal(viewSize * 0.5f),
+      m_bounds({0.f, 0.f}, viewSize)
+{
+}
+
+void Camera::setBounds(const sf::FloatRect& bounds)
+{
+    m_bounds = bounds;
+    m_goal = clampToBounds(m_goal);
+    m_center = clampToBounds(m_center);
+}
+
+void Camera::snapTo(const sf::Vector2f& target)
+{
+    m_goal = clampToBounds(target);
+    m_center = m_goal;
+}
+
+void Camera::update(const sf::Vector2f& target, float dt)
+{
+    // 死区：仅当目标越过死区边缘时推动期望中心
+    sf::Vector2f d = target - m_goal;
+    if (d.x > m_deadzone.x) m_goal.x = target.x - m_deadzone.x;
+    else if (d.x < -m_deadzone.x) m_goal.x = target.x + m_deadzone.x;
+    if (d.y > m_deadzone.y) m_goal.y = target.y - m_deadzone.y;
+    else if (d.y < -m_deadzone.y) m_goal.y = target.y + m_deadzone.y;
+    m_goal = clampToBounds(m_goal);
+
+    if (m_smoothing <= 0.f) {
+        m_center = m_goal;
+    } else {
+        const float alpha = 1.f - std::exp(-m_smoothing * dt);
+        m_center += (m_goal - m_center) * alpha;
+    }
+    m_center = clampToBounds(m_center);
+}
+
+sf::View Camera::makeView(const sf::View& base) const
+{
+    sf::View view = base;
+    // 取整到像素，避免像素风贴图在滚动时出现接缝/抖动
+    view.setCenter({ std::round(m_center.x), std::round(m_center.y) });
+    view.setSize(m_viewSize);
+    return view;
+}
+
+sf::Vector2f Camera::clampToBounds(sf::Vector2f center) const
+{
+    const sf::Vector2f half = m_viewSize * 0.5f;
+    auto clampAxis = [](float c, float lo, float size, float halfView) {
+        if (size <= halfView * 2.f) return lo + size * 0.5f;
+        return std::clamp(c, lo + halfView, lo + size - halfView);
+    };
+    center.x = clampAxis(center.x, m_bounds.position.x, m_bounds.size.x, half.x);
+    center.y = clampAxis(center.y, m_bounds.position.y, m_bounds.size.y, half.y);
+    return center;
+}
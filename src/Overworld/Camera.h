@@ -0,0 +1,46 @@
+﻿/*
+探索场景摄像机。
+包含：
+
+跟随目标（死区 + 平滑）
+
+限制在房间范围内
+
+可见区域（用于绘制裁剪）
+*/
+
+#pragma once
+#include <SFML/Graphics.hpp>
+
+class Camera {
+public:
+    explicit Camera(const sf::Vector2f& viewSize = {640.f, 480.f});
+
+    // 房间范围：比视野小的方向上摄像机居中，不滚动
+    void setBounds(const sf::FloatRect& bounds);
+    // 死区半宽/半高：目标在死区内移动时摄像机不动
+    void setDeadzone(const sf::Vector2f& halfExtents) { m_deadzone = halfExtents; }
+    // 平滑速率（每秒）：越大越跟手，0 表示直接贴住死区边缘
+    void setSmoothing(float rate) { m_smoothing = rate; }
+
+    // 立即对准目标（切换房间时使用，跳过平滑）
+    void snapTo(const sf::Vector2f& target);
+    // 每帧更新：先按死区求期望中心，再指数平滑逼近并限制在房间内
+    void update(const sf::Vector2f& target, float dt);
+
+    sf::Vector2f getCenter() const { return m_center; }
+    // 当前可见区域（世界坐标）
+    sf::FloatRect getViewRect() const { return sf::FloatRect(m_center - m_viewSize * 0.5f, m_viewSize); }
+    // 基于游戏视图（保留其视口/信箱设置）生成摄像机视图
+    sf::View makeView(const sf::View& base) const;
+
+private:
+    sf::Vector2f clampToBounds(sf::Vector2f center) const;
+
+    sf::Vector2f m_viewSize;
+    sf::Vector2f m_center;
+    sf::Vector2f m_goal;                    // 死区求得的期望中心
+    sf::FloatRect m_bounds;
+    sf::Vector2f m_deadzone{40.f, 30.f};
+    float m_smoothing = 8.f;
+};
@@ -0,0 +1,84 @@
+﻿#include "Overworld/DrawList.h"
+#include <algorithm>
+
+//
+// 深度排序绘制列表（DrawList）
+// ----------------------------
+// 职责：
+// - 静态道具进房间时排好序，之后不再参与排序
+// - 动态项的顺序（m_order）跨帧保留：角色每帧只移动几个像素，插入排序基本只做比较
+// - 绘制时两路归并（静态 / 动态），顺带做视野裁剪
+// 关键约定：
+// - yKey 相同时静态项先画，与原先"地图项先收集、角色后收集"的稳定排序结果一致
+// - 动态项中 yKey 相同的两项保持上一帧的先后顺序（插入排序稳定），避免重叠时闪烁
+//
+
+namespace {
+inline bool visible(const DrawItem& item, const sf::FloatRect& viewRect) {
+    const sf::FloatRect& b = item.bounds;
+    return item.drawable &&
+           b.position.x <= viewRect.position.x + viewRect.size.x && viewRect.position.x <= b.position.x + b.size.x &&
+           b.position.y <= viewRect.position.y + viewRect.size.y && viewRect.position.y <= b.position.y + b.size.y;
+}
+}
+
+void DrawList::clear()
+{
+    m_static.clear();
+    m_dynamic.clear();
+    m_order.clear();
+}
+
+void DrawList::addStatic(const DrawItem& item)
+{
+    m_static.push_back(item);
+}
+
+void DrawList::sortStatic()
+{
+    std::stable_sort(m_static.begin(), m_static.end(), [](const DrawItem& a, const DrawItem& b) {
+        return a.yKey < b.yKey;
+    });
+}
+
+std::size_t DrawList::addDynamic(sf::Drawable* drawable)
+{
+    const std::size_t handle = m_dynamic.size();
+    m_dynamic.push_back(DrawItem{ drawable, 0.f, {} });
+    m_order.push_back(handle);
+    return handle;
+}
+
+void DrawList::update(std::size_t handle, float yKey, const sf::FloatRect& bounds)
+{
+    if (handle >= m_dynamic.size()) return;
+    m_dynamic[handle].yKey = yKey;
+    m_dynamic[handle].bounds = bounds;
+}
+
+void DrawList::draw(sf::RenderTarget& target, const sf::FloatRect& viewRect)
+{
+    // 1. 插入排序：近乎有序时 O(n)
+    for (std::size_t i = 1; i < m_order.size(); ++i) {
+        const std::size_t handle = m_order[i];
+        const float key = m_dynamic[handle].yKey;
+        std::size_t j = i;
+        while (j > 0 && m_dynamic[m_order[j - 1]].yKey > key) {
+            m_order[j] = m_order[j - 1];
+            --j;
+        }
+        m_order[j] = handle;
+    }
+
+    // 2. 归并绘制
+    std::size_t s = 0;
+    std::size_t d = 0;
+    while (s < m_static.size() || d < m_order.size()) {
+        const bool takeStatic = d >= m_order.size() ||
+            (s < m_static.size() && m_static[s].yKey <= m_dynamic[m_order[d]].yKey);
+        const DrawItem& item = takeStatic ? m_static[s++] : m_dynamic[m_order[d++]];
+        if (visible(item, viewRect)) {
+            target.draw(*item.drawable);
+        }
+    }
+}
@@ -0,0 +1,41 @@
+﻿/*
+探索场景深度排序绘制列表。
+包含：
+
+静态项（位置不变的道具，进房间时排序一次）
+
+动态项（角色 / NPC，按句柄每帧更新排序键，插入排序维持顺序）
+
+视野裁剪 + 归并绘制（运行期不分配内存）
+*/
+
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+#include <vector>
+#include "Overworld/MapTypes.h"
+
+class DrawList {
+public:
+    // 清空全部项（切换房间/重建队伍时），保留已分配容量
+    void clear();
+
+    // 静态项：加入后调用 sortStatic 排序一次
+    void addStatic(const DrawItem& item);
+    void sortStatic();
+
+    // 动态项：返回句柄，之后每帧用 update 刷新排序键与包围盒
+    std::size_t addDynamic(sf::Drawable* drawable);
+    void update(std::size_t handle, float yKey, const sf::FloatRect& bounds);
+
+    // 插入排序动态项（上一帧顺序几乎有序，接近线性），与静态项归并后按 yKey 从小到大绘制视野内的项
+    void draw(sf::RenderTarget& target, const sf::FloatRect& viewRect);
+
+    std::size_t staticCount() const { return m_static.size(); }
+    std::size_t dynamicCount() const { return m_dynamic.size(); }
+
+private:
+    std::vector<DrawItem> m_static;     // 按 yKey 升序
+    std::vector<DrawItem> m_dynamic;    // 按句柄索引，位置固定
+    std::vector<std::size_t> m_order;   // 动态项句柄，按 yKey 升序（跨帧保留）
+};
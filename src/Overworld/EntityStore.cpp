@@ -0,0 +1,48 @@
+﻿#include "Overworld/EntityStore.h"
+
+//
+// 实体存储（EntityStore）
+// -----------------------
+// 职责：
+// - 分配实体 ID，并持有各类组件的稠密数组
+// - 系统逻辑（游荡、动画、精灵同步、绘制收集）由 GameMap 在每帧按组件数组顺序遍历
+// 关键约定：
+// - 组件池删除使用"与末尾交换"，遍历顺序不稳定；需要稳定顺序的地方（绘制）统一按 y 排序
+// - 组件中的贴图以 shared_ptr 持有，同一房间内多个实体共享同一份贴图
+//
+
+EntityId EntityStore::create()
+{
+    const EntityId e = static_cast<EntityId>(m_alive.size());
+    m_alive.push_back(true);
+    ++m_count;
+    ++m_revision;
+    return e;
+}
+
+void EntityStore::destroy(EntityId e)
+{
+    if (!alive(e)) return;
+    transforms.remove(e);
+    sprites.remove(e);
+    animations.remove(e);
+    colliders.remove(e);
+    interactions.remove(e);
+    wanderers.remove(e);
+    m_alive[e] = false;
+    --m_count;
+    ++m_revision;
+}
+
+void EntityStore::clear()
+{
+    transforms.clear();
+    sprites.clear();
+    animations.clear();
+    colliders.clear();
+    interactions.clear();
+    wanderers.clear();
+    m_alive.clear();
+    m_count = 0;
+    ++m_revision;
+}
@@ -0,0 +1,157 @@
+﻿/*
+探索场景实体-组件存储。
+包含：
+
+实体 ID 分配与销毁
+
+稠密组件数组（稀疏集：按实体随机访问 O(1)，按数组顺序连续遍历）
+
+组件：位置 / 精灵 / 帧动画 / 碰撞箱 / 交互 / 游荡 AI
+*/
+
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <vector>
+#include "Overworld/MapTypes.h"
+#include "Overworld/AnimationClip.h"
+
+using EntityId = std::uint32_t;
+constexpr EntityId kNullEntity = std::numeric_limits<EntityId>::max();
+
+// ---------------- 组件 ----------------
+
+// 位置：道具为贴图左上角，行走 NPC 为脚底中心（见 SpriteComponent::anchorBottom）
+struct TransformComponent {
+    sf::Vector2f position{0.f, 0.f};
+};
+
+struct SpriteComponent {
+    std::optional<sf::Sprite> sprite;
+    std::size_t drawSlot = static_cast<std::size_t>(-1); // DrawList 动态句柄；静态道具不占句柄
+    bool anchorBottom = false; // 原点取贴图底边中心（独立贴图换帧时按新尺寸重算；图集帧使用预计算原点）
+};
+
+// 帧动画，两种来源：
+// - clips 非空：共享图集的片段集，row 为片段（行走 NPC 按 Down/Left/Right/Up），换帧只改纹理矩形
+// - 否则 frames 为独立贴图序列（房间道具），按 行 × framesPerRow 排列，换帧切换贴图
+struct AnimationComponent {
+    std::shared_ptr<const ClipSet> clips;
+    std::vector<std::shared_ptr<const sf::Texture>> frames;
+    int framesPerRow = 1;
+    int row = 0;
+    int frameIndex = 0;        // 行内帧下标
+    float frameTime = 0.12f;
+    float timeAcc = 0.f;
+    bool playing = true;       // 停止时回到行内第 0 帧
+    bool dirty = true;         // 需要把当前帧写回精灵
+};
+
+// 脚底碰撞箱（相对 position 的偏移）：阻挡角色，也用于 NPC 自身撞墙
+struct ColliderComponent {
+    sf::Vector2f offset{0.f, 0.f};
+    sf::Vector2f size{0.f, 0.f};
+};
+
+// 交互：data.area 为世界坐标，每帧由 offset 跟随 position 更新
+struct InteractionComponent {
+    Interactable data;
+    sf::Vector2f offset{0.f, 0.f};
+};
+
+// 游荡 AI：在 home 周围 radius 内随机选点行走，到达或受阻后停顿
+struct WanderComponent {
+    sf::Vector2f home{0.f, 0.f};
+    float radius = 48.f;
+    float speed = 40.f;
+    float waitTimer = 0.f;
+    sf::Vector2f target{0.f, 0.f};
+    bool moving = false;
+    std::uint32_t rng = 1;     // 每个实体独立的 xorshift 状态，结果与遍历顺序无关
+};
+
+// ---------------- 组件池（稀疏集） ----------------
+// m_sparse[entity] -> 稠密下标；删除时与末尾交换，稠密数组始终连续
+template <typename T>
+class ComponentPool {
+public:
+    T& add(EntityId e, T value) {
+        if (e >= m_sparse.size()) m_sparse.resize(static_cast<std::size_t>(e) + 1, kAbsent);
+        if (m_sparse[e] != kAbsent) {
+            m_data[m_sparse[e]] = std::move(value);
+            return m_data[m_sparse[e]];
+        }
+        m_sparse[e] = static_cast<std::uint32_t>(m_data.size());
+        m_entities.push_back(e);
+        m_data.push_back(std::move(value));
+        return m_data.back();
+    }
+
+    void remove(EntityId e) {
+        if (!has(e)) return;
+        const std::uint32_t idx = m_sparse[e];
+        const std::uint32_t last = static_cast<std::uint32_t>(m_data.size() - 1);
+        if (idx != last) {
+            m_data[idx] = std::move(m_data[last]);
+            m_entities[idx] = m_entities[last];
+            m_sparse[m_entities[idx]] = idx;
+        }
+        m_data.pop_back();
+        m_entities.pop_back();
+        m_sparse[e] = kAbsent;
+    }
+
+    bool has(EntityId e) const { return e < m_sparse.size() && m_sparse[e] != kAbsent; }
+    T* get(EntityId e) { return has(e) ? &m_data[m_sparse[e]] : nullptr; }
+    const T* get(EntityId e) const { return has(e) ? &m_data[m_sparse[e]] : nullptr; }
+
+    // 稠密遍历：下标 i 对应实体 entityAt(i)
+    std::size_t size() const { return m_data.size(); }
+    EntityId entityAt(std::size_t i) const { return m_entities[i]; }
+    T& operator[](std::size_t i) { return m_data[i]; }
+    const T& operator[](std::size_t i) const { return m_data[i]; }
+    typename std::vector<T>::iterator begin() { return m_data.begin(); }
+    typename std::vector<T>::iterator end() { return m_data.end(); }
+    typename std::vector<T>::const_iterator begin() const { return m_data.begin(); }
+    typename std::vector<T>::const_iterator end() const { return m_data.end(); }
+
+    void clear() {
+        m_sparse.clear();
+        m_entities.clear();
+        m_data.clear();
+    }
+
+private:
+    static constexpr std::uint32_t kAbsent = std::numeric_limits<std::uint32_t>::max();
+    std::vector<std::uint32_t> m_sparse;
+    std::vector<EntityId> m_entities;
+    std::vector<T> m_data;
+};
+
+// ---------------- 实体存储 ----------------
+// 实体 ID 在一个房间内单调分配，clear() 时整体重置（切换房间）
+class EntityStore {
+public:
+    EntityId create();
+    void destroy(EntityId e);
+    void clear();
+    bool alive(EntityId e) const { return e < m_alive.size() && m_alive[e]; }
+    std::size_t count() const { return m_count; }
+    // 实体增删计数：变化时依赖组件地址的外部缓存（如 DrawList）需要重建
+    std::uint32_t revision() const { return m_revision; }
+
+    ComponentPool<TransformComponent> transforms;
+    ComponentPool<SpriteComponent> sprites;
+    ComponentPool<AnimationComponent> animations;
+    ComponentPool<ColliderComponent> colliders;
+    ComponentPool<InteractionComponent> interactions;
+    ComponentPool<WanderComponent> wanderers;
+
+private:
+    std::vector<bool> m_alive;
+    std::size_t m_count = 0;
+    std::uint32_t m_revision = 0;
+};
@@ -0,0 +1,82 @@
+﻿#include "Overworld/LeaderTrail.h"
+#include <cmath>
+
+//
+// 队长轨迹（LeaderTrail）
+// -----------------------
+// 职责：
+// - 以固定容量环形缓冲记录队长走过的路径，追加/覆盖均为 O(1)，运行期不分配内存
+// - 每条记录保存累计路径长度（单调递增），采样时二分查找并在相邻记录间插值
+// 关键约定：
+// - 只在位移达到 kMinStep 时新增记录，因此容量只与路径长度相关、与帧率无关
+// - 累计长度超过 kRebaseThreshold 时整体减去最旧记录的值，避免浮点精度随游玩时长下降
+//
+
+namespace {
+constexpr float kRebaseThreshold = 65536.f;
+}
+
+void LeaderTrail::reset(const PositionRecord& rec)
+{
+    m_head = 0;
+    m_size = 1;
+    m_entries[0] = Entry{ rec, 0.f };
+}
+
+void LeaderTrail::push(const PositionRecord& rec)
+{
+    if (m_size == 0) {
+        reset(rec);
+        return;
+    }
+
+    Entry& last = at(m_size - 1);
+    const float dx = rec.position.x - last.rec.position.x;
+    const float dy = rec.position.y - last.rec.position.y;
+    const float stepSq = dx * dx + dy * dy;
+    if (stepSq < kMinStep * kMinStep) {
+        // 位移过小：不新增记录，只刷新状态
+        last.rec.direction = rec.direction;
+        last.rec.isMoving = rec.isMoving;
+        last.rec.isRunning = rec.isRunning;
+        return;
+    }
+
+    const float distance = last.distance + std::sqrt(stepSq);
+    if (m_size < kCapacity) {
+        ++m_size;
+    } else {
+        m_head = (m_head + 1) % kCapacity; // 覆盖最旧记录
+    }
+    at(m_size - 1) = Entry{ rec, distance };
+
+    if (distance > kRebaseThreshold) {
+        const float base = at(0).distance;
+        for (std::size_t i = 0; i < m_size; ++i) at(i).distance -= base;
+    }
+}
+
+PositionRecord LeaderTrail::sampleBehind(float arcDistance) const
+{
+    if (m_size == 0) return PositionRecord{ {0.f, 0.f}, 0, false, false };
+    const float target = at(m_size - 1).distance - arcDistance;
+    if (target <= at(0).distance) return at(0).rec;
+    if (arcDistance <= 0.f) return at(m_size - 1).rec;
+
+    // 二分：找到第一条 distance >= target 的记录 hi，lo = hi - 1
+    std::size_t lo = 0;
+    std::size_t hi = m_size - 1;
+    while (hi - lo > 1) {
+        const std::size_t mid = lo + (hi - lo) / 2;
+        if (at(mid).distance < target) lo = mid; else hi = mid;
+    }
+
+    const Entry& a = at(lo);
+    const Entry& b = at(hi);
+    const float span = b.distance - a.distance;
+    const float t = span > 0.f ? (target - a.distance) / span : 1.f;
+
+    PositionRecord out = (t < 0.5f) ? a.rec : b.rec; // 朝向等离散状态取较近的记录
+    out.position = a.rec.position + (b.rec.position - a.rec.position) * t;
+    return out;
+}
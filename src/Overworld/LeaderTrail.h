@@ -0,0 +1,61 @@
+﻿/*
+队长移动轨迹。
+包含：
+
+固定容量环形缓冲（无动态分配）
+
+每条记录的累计路径长度
+
+按路径距离采样（队员按弧长跟随）
+*/
+
+#pragma once
+#include <SFML/System/Vector2.hpp>
+#include <array>
+#include <cstddef>
+
+// 记录某一时刻的状态，用于"毛毛虫"跟随
+struct PositionRecord {
+    sf::Vector2f position;
+    int direction;   // 0:下, 1:左, 2:右, 3:上
+    bool isMoving;   // 是否在动（用于播放动画）
+    bool isRunning;  // 是否在跑（用于播放快跑动画）
+};
+
+class LeaderTrail {
+public:
+    // 容量 × kMinStep 为最坏情况下可回溯的路径长度（512 像素），足够约十名队员按间距跟随
+    static constexpr std::size_t kCapacity = 1024;
+    // 相邻记录的最小间距（像素）：更短的位移只更新最新记录的朝向/奔跑状态
+    static constexpr float kMinStep = 0.5f;
+
+    // 清空并以一条记录开始（切换房间/传送后）
+    void reset(const PositionRecord& rec);
+    // 追加队长当前状态；缓冲满时覆盖最旧记录
+    void push(const PositionRecord& rec);
+
+    // 沿路径从最新点向后 arcDistance 像素处的状态（位置线性插值）；
+    // 轨迹不够长时返回最旧记录
+    PositionRecord sampleBehind(float arcDistance) const;
+
+    const PositionRecord& newest() const { return at(m_size - 1).rec; }
+    const PositionRecord& oldest() const { return at(0).rec; }
+    // 当前缓冲覆盖的路径总长
+    float length() const { return m_size == 0 ? 0.f : at(m_size - 1).distance - at(0).distance; }
+    std::size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+
+private:
+    struct Entry {
+        PositionRecord rec;
+        float distance = 0.f; // 从缓冲起点累计的路径长度
+    };
+
+    // i = 0 为最旧，i = size-1 为最新
+    const Entry& at(std::size_t i) const { return m_entries[(m_head + i) % kCapacity]; }
+    Entry& at(std::size_t i) { return m_entries[(m_head + i) % kCapacity]; }
+
+    std::array<Entry, kCapacity> m_entries{};
+    std::size_t m_head = 0; // 最旧记录的下标
+    std::size_t m_size = 0;
+};
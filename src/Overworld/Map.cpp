@@ -1,22 +1,33 @@
 ﻿#include "Overworld/Map.h"
+#include "Overworld/RoomLoader.h"
+#include <algorithm>
 #include <iostream>
 #include <cmath>
+#include <limits>
 
 //
 // 地图模块（GameMap）与几何碰撞工具
 // ----------------------------------
 // 职责：
-// - 管理房间背景、墙体碰撞、交互对象、传送触发与动画道具
+// - 管理房间背景（整图或瓦片图层）、墙体碰撞、交互对象、传送触发与动画道具
 // - 提供绘制接口（背景与调试覆盖），以及按 y 深度排序的道具收集
 // - 进行碰撞检测与最小平移向量（MTV）求解，支持旋转矩形（RotRect）
+// - 房间内容由 RoomLoader 从 assets/room/*.json（烘焙缓存）填充
 // 关键约定：
 // - 角色的脚底碰撞箱与墙体/交互碰撞箱使用分离轴定理（SAT）进行检测
+// - 移动使用扫掠 SAT（sweep）求首次接触时刻与法线，大步长也不会穿过 4 像素厚的薄墙
+// - 阻挡几何的顶点与外接 AABB 预先计算（CollisionShape），检测前先做 AABB 排除
 // - 交互区域支持旋转，通过 RotRect 与感应框（AABB）做相交判定
 // - 传送区域使用轴对齐矩形（AABB）并与角色脚底碰撞箱求交
-// - 动画道具以帧序列驱动，外部可将其纳入 y 排序列表与角色一并渲染
+// - 动画道具与行走 NPC 存放在 EntityStore（稠密组件数组），update 中依次运行 游荡 → 动画 → 同步 三个系统
+// - 实体精灵经 gatherDrawItems 纳入 y 排序列表与角色一并渲染；NPC 碰撞箱同样阻挡角色
+// - 寻路网格在房间内容全部加入后按静态阻挡烘焙（bakeNavigation），队员卡住时据此绕路
 //
 
 namespace {
+constexpr float kNavCellSize = 8.f;
+const sf::Vector2f kNavAgentSize{18.f, 15.f};
+
 inline float dot(const sf::Vector2f& a, const sf::Vector2f& b) { return a.x * b.x + a.y * b.y; }
 inline sf::Vector2f rotate(const sf::Vector2f& v, float rad) {
     float c = std::cos(rad), s = std::sin(rad);
@@ -72,10 +83,21 @@ bool overlapsOnAxis(const std::array<sf::Vector2f, 4>& a, const std::array<sf::V
     return !(aMax < bMin || bMax < aMin);
 }
 
-// 旋转矩形 vs 轴对齐矩形（AABB）相交判定
-// 依据 SAT，在候选轴（旋转矩形两边方向 + X/Y 轴）上投影并检测是否存在分离
-bool intersectsRotAABB(const RotRect& rr, const sf::FloatRect& aabb) {
-    auto rv = getVertices(rr);
+sf::FloatRect viewRectOf(const sf::RenderTarget& target) {
+    const sf::View& view = target.getView();
+    return sf::FloatRect(view.getCenter() - view.getSize() * 0.5f, view.getSize());
+}
+
+inline bool aabbOverlap(const sf::FloatRect& a, const sf::FloatRect& b) {
+    return a.position.x <= b.position.x + b.size.x && b.position.x <= a.position.x + a.size.x &&
+           a.position.y <= b.position.y + b.size.y && b.position.y <= a.position.y + a.size.y;
+}
+
+// 预计算几何 vs 轴对齐矩形（AABB）相交判定
+// 先用外接 AABB 快速排除，再依据 SAT 在候选轴（旋转矩形两边方向 + X/Y 轴）上投影检测分离
+bool intersectsShapeAABB(const CollisionShape& shape, const sf::FloatRect& aabb) {
+    if (!aabbOverlap(shape.bounds, aabb)) return false;
+    const auto& rv = shape.verts;
     auto av = getVertices(aabb);
     // 轴：旋转矩形的两条边方向，以及 AABB 的 X/Y 轴
     sf::Vector2f e0 = rv[1] - rv[0];
@@ -87,10 +109,16 @@ bool intersectsRotAABB(const RotRect& rr, const sf::FloatRect& aabb) {
     return true;
 }
 
-// 计算最小平移向量（MTV）：将 AABB 推出 RotRect 的最短向量
+// 旋转矩形 vs AABB：交互范围等非烘焙几何使用
+bool intersectsRotAABB(const RotRect& rr, const sf::FloatRect& aabb) {
+    return intersectsShapeAABB(makeCollisionShape(rr), aabb);
+}
+
+// 计算最小平移向量（MTV）：将 AABB 推出碰撞几何的最短向量
 // 若不相交返回 false；用于“弹出”角色以避免穿墙
-bool mtvRotAABB(const RotRect& rr, const sf::FloatRect& aabb, sf::Vector2f& outMTV) {
-    auto rv = getVertices(rr);
+bool mtvShapeAABB(const CollisionShape& shape, const sf::FloatRect& aabb, sf::Vector2f& outMTV) {
+    if (!aabbOverlap(shape.bounds, aabb)) return false;
+    const auto& rv = shape.verts;
     auto av = getVertices(aabb);
     sf::Vector2f cA = centerOf(rv);
     sf::Vector2f cB = centerOf(av);
@@ -127,49 +155,135 @@ bool mtvRotAABB(const RotRect& rr, const sf::FloatRect& aabb, sf::Vector2f& outM
 }
 }
 
+CollisionShape makeCollisionShape(const RotRect& rr)
+{
+    CollisionShape shape;
+    shape.verts = getVertices(rr);
+    float minX = shape.verts[0].x, maxX = minX;
+    float minY = shape.verts[0].y, maxY = minY;
+    for (const auto& v : shape.verts) {
+        minX = std::min(minX, v.x); maxX = std::max(maxX, v.x);
+        minY = std::min(minY, v.y); maxY = std::max(maxY, v.y);
+    }
+    shape.bounds = sf::FloatRect({minX, minY}, {maxX - minX, maxY - minY});
+    return shape;
+}
+
 void GameMap::clear()
 {
     m_bgSprite.reset();
     m_bgTexture.reset();
+    m_tileLayers.clear();
+    m_cameraBounds.reset();
     m_walls.clear();
+    m_solids.clear();
     m_interactables.clear();
+    m_wallSolids.clear();
+    m_interactableSolids.clear();
+    m_interactableAreaBounds.clear();
     m_warps.clear();
-    m_props.clear(); // 清除上次房间的动画道具，防止重复叠加
+    m_entities.clear(); // 清除上次房间的道具与 NPC，防止重复叠加
+    m_navGrid.clear();
+}
+
+void GameMap::bakeNavigation()
+{
+    // 队员脚底碰撞箱约 17x14（2 倍缩放），略放大留出余量；NPC 会移动，不参与烘焙
+    m_navGrid.build(getCameraBounds(), kNavCellSize, kNavAgentSize,
+                    [this](const sf::FloatRect& box) { return collidesStatic(box); });
 }
 
 void GameMap::setBackground(const std::string& path, const sf::Vector2f& scale, const sf::Vector2f& position)
 {
-    m_bgTexture.emplace();
-    if (!m_bgTexture->loadFromFile(path)) {
+    auto texture = std::make_shared<sf::Texture>();
+    if (!texture->loadFromFile(path)) {
         std::cerr << "GameMap::setBackground failed: " << path << std::endl;
     }
-    m_bgTexture->setSmooth(false);
+    texture->setSmooth(false);
+    setBackground(std::shared_ptr<const sf::Texture>(std::move(texture)), scale, position);
+}
+
+void GameMap::setBackground(std::shared_ptr<const sf::Texture> texture, const sf::Vector2f& scale, const sf::Vector2f& position)
+{
+    m_bgTexture = std::move(texture);
+    m_bgSprite.reset();
+    if (!m_bgTexture) return;
 
     m_bgSprite.emplace(*m_bgTexture);
     m_bgSprite->setPosition(position);
     m_bgSprite->setScale(scale);
 }
 
-void GameMap::drawBackground(sf::RenderWindow& window)
+sf::FloatRect GameMap::getCameraBounds() const
+{
+    if (m_cameraBounds.has_value()) return *m_cameraBounds;
+    sf::Vector2f lo{0.f, 0.f};
+    sf::Vector2f hi{640.f, 480.f};
+    for (const auto& layer : m_tileLayers) {
+        const sf::FloatRect& b = layer.getBounds();
+        lo.x = std::min(lo.x, b.position.x);
+        lo.y = std::min(lo.y, b.position.y);
+        hi.x = std::max(hi.x, b.position.x + b.size.x);
+        hi.y = std::max(hi.y, b.position.y + b.size.y);
+    }
+    return sf::FloatRect(lo, hi - lo);
+}
+
+void GameMap::addTileLayer(TileLayer layer)
+{
+    m_tileLayers.push_back(std::move(layer));
+}
+
+void GameMap::drawBackground(sf::RenderTarget& target)
 {
     if (m_bgSprite.has_value()) {
-        window.draw(*m_bgSprite);
+        target.draw(*m_bgSprite);
+    }
+    if (!m_tileLayers.empty()) {
+        const sf::FloatRect viewRect = viewRectOf(target);
+        for (const auto& layer : m_tileLayers) {
+            layer.draw(target, viewRect);
+        }
     }
 }
 
 void GameMap::addWall(const sf::FloatRect& wall)
 {
-    m_walls.push_back(RotRect{ wall.position, wall.size, 0.f });
+    addWall(RotRect{ wall.position, wall.size, 0.f });
 }
 
 void GameMap::addWall(const RotRect& wall)
+{
+    addWall(wall, makeCollisionShape(wall));
+}
+
+void GameMap::addWall(const RotRect& wall, const CollisionShape& shape)
 {
     m_walls.push_back(wall);
+    m_wallSolids.push_back(m_solids.size());
+    m_solids.push_back(shape);
 }
 
 void GameMap::addInteractable(const Interactable& interactable)
+{
+    if (interactable.collider.has_value()) {
+        addInteractable(interactable, makeCollisionShape(*interactable.collider));
+    } else {
+        addInteractable(interactable, CollisionShape{});
+    }
+}
+
+void GameMap::addInteractable(const Interactable& interactable, const CollisionShape& colliderShape)
 {
     m_interactables.push_back(interactable);
+    const RotRect areaRR{ interactable.area.position, interactable.area.size, interactable.areaAngleDeg };
+    m_interactableAreaBounds.push_back(makeCollisionShape(areaRR).bounds);
+    if (interactable.collider.has_value()) {
+        m_interactableSolids.push_back(m_solids.size());
+        m_solids.push_back(colliderShape);
+    } else {
+        m_interactableSolids.push_back(std::numeric_limits<std::size_t>::max());
+    }
 }
 
 void GameMap::addWarp(const WarpTrigger& warp)
@@ -177,77 +291,384 @@ void GameMap::addWarp(const WarpTrigger& warp)
     m_warps.push_back(warp);
 }
 
-// 兼容旧接口：仅执行 clear + setBackground；房间细节应由专用构建器填充
-void GameMap::load(const std::string& mapName)
+// 按房间名加载：读取（或烘焙）房间数据后实例化到本地图
+bool GameMap::load(const std::string& roomName)
 {
-    clear();
-    const std::string path = "assets/sprite/Room/" + mapName + ".png";
-    setBackground(path, {1.f, 1.f});
+    RoomData room;
+    if (!RoomLoader::load(roomName, room)) {
+        clear();
+        return false;
+    }
+    RoomLoader::apply(room, *this);
+    return true;
 }
 
-int GameMap::addAnimatedProp(const std::vector<std::string>& framePaths,
-                             const sf::Vector2f& position,
-                             const sf::Vector2f& scale,
-                             float frameTime)
+EntityId GameMap::addAnimatedProp(const std::vector<std::string>& framePaths,
+                                  const sf::Vector2f& position,
+                                  const sf::Vector2f& scale,
+                                  float frameTime)
 {
-    AnimatedProp prop;
-    prop.position = position;
-    prop.scale = scale;
-    prop.frameTime = frameTime;
-    prop.frames.resize(framePaths.size());
-    for (std::size_t i = 0; i < framePaths.size(); ++i) {
-        if (!prop.frames[i].loadFromFile(framePaths[i])) {
-            std::cerr << "GameMap::addAnimatedProp failed: " << framePaths[i] << std::endl;
+    std::vector<std::shared_ptr<const sf::Texture>> frames;
+    frames.reserve(framePaths.size());
+    for (const auto& path : framePaths) {
+        auto texture = std::make_shared<sf::Texture>();
+        if (!texture->loadFromFile(path)) {
+            std::cerr << "GameMap::addAnimatedProp failed: " << path << std::endl;
         }
-        prop.frames[i].setSmooth(false);
+        texture->setSmooth(false);
+        frames.push_back(std::move(texture));
     }
-    if (!prop.frames.empty()) {
-        prop.sprite.emplace(prop.frames[0]);
-        prop.sprite->setPosition(prop.position);
-        prop.sprite->setScale(prop.scale);
+    return addAnimatedProp(std::move(frames), position, scale, frameTime);
+}
+
+EntityId GameMap::addAnimatedProp(std::vector<std::shared_ptr<const sf::Texture>> frames,
+                                  const sf::Vector2f& position,
+                                  const sf::Vector2f& scale,
+                                  float frameTime)
+{
+    const EntityId e = m_entities.create();
+    m_entities.transforms.add(e, TransformComponent{ position });
+    SpriteComponent sprite;
+    if (!frames.empty() && frames[0]) {
+        sprite.sprite.emplace(*frames[0]);
+        sprite.sprite->setPosition(position);
+        sprite.sprite->setScale(scale);
     }
-    m_props.push_back(std::move(prop));
-    return static_cast<int>(m_props.size() - 1);
+    m_entities.sprites.add(e, std::move(sprite));
+    AnimationComponent anim;
+    anim.frames = std::move(frames);
+    anim.framesPerRow = std::max(1, static_cast<int>(anim.frames.size()));
+    anim.frameTime = frameTime;
+    anim.dirty = false; // 首帧已在构造精灵时设置
+    m_entities.animations.add(e, std::move(anim));
+    return e;
+}
+
+EntityId GameMap::addNpc(const NpcSpawn& npc)
+{
+    const EntityId e = m_entities.create();
+    m_entities.transforms.add(e, TransformComponent{ npc.position });
+
+    SpriteComponent sprite;
+    sprite.anchorBottom = true;
+    if (npc.walk) {
+        const ClipFrame& first = npc.walk->frame(0, 0);
+        sprite.sprite.emplace(npc.walk->atlas, first.rect);
+        sprite.sprite->setOrigin(first.origin);
+        sprite.sprite->setScale(npc.scale);
+    }
+    m_entities.sprites.add(e, std::move(sprite));
+
+    AnimationComponent anim;
+    anim.clips = npc.walk;
+    anim.frameTime = 0.15f;
+    anim.playing = false;
+    m_entities.animations.add(e, std::move(anim));
+
+    if (npc.colliderSize.x > 0.f && npc.colliderSize.y > 0.f) {
+        m_entities.colliders.add(e, ColliderComponent{ { -npc.colliderSize.x * 0.5f, -npc.colliderSize.y }, npc.colliderSize });
+    }
+    if (!npc.textID.empty()) {
+        InteractionComponent interaction;
+        interaction.data.textID = npc.textID;
+        interaction.data.area.size = npc.interactSize;
+        interaction.offset = { -npc.interactSize.x * 0.5f, -npc.interactSize.y };
+        interaction.data.area.position = npc.position + interaction.offset;
+        m_entities.interactions.add(e, std::move(interaction));
+    }
+    if (npc.wanderRadius > 0.f) {
+        WanderComponent wander;
+        wander.home = npc.position;
+        wander.radius = npc.wanderRadius;
+        wander.speed = npc.speed;
+        wander.target = npc.position;
+        // 种子取自实体 ID 与出生点，同一房间每次加载行为一致
+        wander.rng = 2654435761u * (e + 1u) ^ static_cast<std::uint32_t>(npc.position.x * 31.f + npc.position.y);
+        if (wander.rng == 0) wander.rng = 1;
+        wander.waitTimer = static_cast<float>(wander.rng % 1000u) / 1000.f;
+        m_entities.wanderers.add(e, wander);
+    }
+    syncTransforms();
+    return e;
 }
 
 void GameMap::gatherDrawItems(std::vector<DrawItem>& outItems)
 {
-    for (auto& p : m_props) {
-        if (!p.sprite.has_value()) continue;
-        auto bounds = p.sprite->getGlobalBounds();
+    auto& sprites = m_entities.sprites;
+    for (std::size_t i = 0; i < sprites.size(); ++i) {
+        auto& sprite = sprites[i].sprite;
+        if (!sprite.has_value()) continue;
+        auto bounds = sprite->getGlobalBounds();
         float yKey = bounds.position.y + bounds.size.y; // 使用底部 y 做深度排序键
-        outItems.push_back(DrawItem{ &(*p.sprite), yKey });
+        outItems.push_back(DrawItem{ &(*sprite), yKey, bounds });
+    }
+}
+
+void GameMap::buildDrawList(DrawList& list)
+{
+    auto& sprites = m_entities.sprites;
+    for (std::size_t i = 0; i < sprites.size(); ++i) {
+        SpriteComponent& s = sprites[i];
+        s.drawSlot = static_cast<std::size_t>(-1);
+        if (!s.sprite.has_value()) continue;
+        if (m_entities.wanderers.has(sprites.entityAt(i))) {
+            s.drawSlot = list.addDynamic(&(*s.sprite));
+        } else {
+            const auto bounds = s.sprite->getGlobalBounds();
+            list.addStatic(DrawItem{ &(*s.sprite), bounds.position.y + bounds.size.y, bounds });
+        }
+    }
+}
+
+void GameMap::refreshDrawList(DrawList& list)
+{
+    for (const auto& s : m_entities.sprites) {
+        if (s.drawSlot == static_cast<std::size_t>(-1) || !s.sprite.has_value()) continue;
+        const auto bounds = s.sprite->getGlobalBounds();
+        list.update(s.drawSlot, bounds.position.y + bounds.size.y, bounds);
     }
 }
 
 void GameMap::update(float dt)
 {
-    for (auto& p : m_props) {
-        if (p.frames.empty()) continue;
-        p.timeAcc += dt;
-        while (p.timeAcc >= p.frameTime) {
-            p.timeAcc -= p.frameTime;
-            p.frameIndex = (p.frameIndex + 1) % static_cast<int>(p.frames.size());
-            if (p.sprite.has_value()) {
-                p.sprite->setTexture(p.frames[p.frameIndex]);
-                // 保持位置与缩放
-                p.sprite->setPosition(p.position);
-                p.sprite->setScale(p.scale);
+    updateWanderers(dt);
+    updateAnimations(dt);
+    syncTransforms();
+}
+
+namespace {
+// xorshift32：返回 [0, 1) 的浮点数
+float nextRandom(std::uint32_t& state) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return static_cast<float>(state >> 8) / 16777216.f;
+}
+
+// 方向编号与 OverworldCharacter 一致：0:下, 1:左, 2:右, 3:上
+int directionOf(const sf::Vector2f& d) {
+    if (std::abs(d.x) > std::abs(d.y)) return d.x < 0.f ? 1 : 2;
+    return d.y < 0.f ? 3 : 0;
+}
+}
+
+// 游荡系统：停顿计时结束后在 home 周围随机选点，沿直线行走；到达或撞到静态阻挡时停下
+void GameMap::updateWanderers(float dt)
+{
+    auto& wanderers = m_entities.wanderers;
+    for (std::size_t i = 0; i < wanderers.size(); ++i) {
+        WanderComponent& w = wanderers[i];
+        const EntityId e = wanderers.entityAt(i);
+        TransformComponent* t = m_entities.transforms.get(e);
+        if (!t) continue;
+        AnimationComponent* anim = m_entities.animations.get(e);
+
+        if (!w.moving) {
+            w.waitTimer -= dt;
+            if (w.waitTimer <= 0.f) {
+                const float angle = nextRandom(w.rng) * 6.2831853f;
+                const float dist = w.radius * std::sqrt(nextRandom(w.rng)); // 半径开方：圆内均匀分布
+                w.target = w.home + sf::Vector2f{ std::cos(angle) * dist, std::sin(angle) * dist };
+                w.moving = true;
+            }
+        }
+
+        bool stepped = false;
+        if (w.moving) {
+            const sf::Vector2f d = w.target - t->position;
+            const float distSq = d.x * d.x + d.y * d.y;
+            const float step = w.speed * dt;
+            if (distSq <= step * step) {
+                w.moving = false;
+            } else {
+                const sf::Vector2f next = t->position + d * (step / std::sqrt(distSq));
+                const ColliderComponent* c = m_entities.colliders.get(e);
+                if (c && collidesStatic(colliderBounds(TransformComponent{ next }, *c))) {
+                    w.moving = false;
+                } else {
+                    t->position = next;
+                    stepped = true;
+                }
+            }
+            if (!w.moving) {
+                w.waitTimer = 1.f + 2.f * nextRandom(w.rng);
+            }
+            if (anim) {
+                const int row = directionOf(d);
+                if (row != anim->row) { anim->row = row; anim->dirty = true; }
             }
         }
+        if (anim) anim->playing = stepped;
     }
 }
 
-bool GameMap::checkCollision(const sf::FloatRect& bounds)
+// 动画系统：推进帧计时；停止播放的实体回到行内第 0 帧；只在帧变化时写回精灵（图集帧改矩形，独立贴图换贴图）
+void GameMap::updateAnimations(float dt)
 {
-    for (const auto& wall : m_walls) {
-        if (intersectsRotAABB(wall, bounds)) return true;
+    auto& animations = m_entities.animations;
+    for (std::size_t i = 0; i < animations.size(); ++i) {
+        AnimationComponent& a = animations[i];
+        if (a.frameTime <= 0.f) continue;
+        int frameCount = a.framesPerRow;
+        if (a.clips) {
+            if (a.clips->clips.empty()) continue;
+            const int clip = std::clamp(a.row, 0, static_cast<int>(a.clips->clips.size()) - 1);
+            frameCount = static_cast<int>(a.clips->clips[static_cast<std::size_t>(clip)].frames.size());
+        } else if (a.frames.empty()) {
+            continue;
+        }
+        if (frameCount <= 0) continue;
+        if (a.playing) {
+            a.timeAcc += dt;
+            while (a.timeAcc >= a.frameTime) {
+                a.timeAcc -= a.frameTime;
+                a.frameIndex = (a.frameIndex + 1) % frameCount;
+                a.dirty = true;
+            }
+        } else if (a.frameIndex != 0) {
+            a.frameIndex = 0;
+            a.timeAcc = 0.f;
+            a.dirty = true;
+        }
+        if (!a.dirty) continue;
+        a.dirty = false;
+
+        SpriteComponent* s = m_entities.sprites.get(animations.entityAt(i));
+        if (!s || !s->sprite.has_value()) continue;
+        if (a.clips) {
+            // 图集帧：只更新纹理矩形与预计算原点
+            const ClipFrame& frame = a.clips->frame(a.row, a.frameIndex);
+            s->sprite->setTextureRect(frame.rect);
+            if (s->anchorBottom) s->sprite->setOrigin(frame.origin);
+            continue;
+        }
+        const std::size_t idx = static_cast<std::size_t>(a.row * a.framesPerRow + a.frameIndex);
+        if (idx >= a.frames.size() || !a.frames[idx]) continue;
+        const sf::Texture& tex = *a.frames[idx];
+        s->sprite->setTexture(tex, s->anchorBottom);
+        if (s->anchorBottom) {
+            const sf::Vector2u size = tex.getSize();
+            s->sprite->setOrigin({ static_cast<float>(size.x) * 0.5f, static_cast<float>(size.y) });
+        }
+    }
+}
+
+// 同步系统：位置写回精灵与交互范围
+void GameMap::syncTransforms()
+{
+    auto& sprites = m_entities.sprites;
+    for (std::size_t i = 0; i < sprites.size(); ++i) {
+        const TransformComponent* t = m_entities.transforms.get(sprites.entityAt(i));
+        if (t && sprites[i].sprite.has_value()) sprites[i].sprite->setPosition(t->position);
+    }
+    auto& interactions = m_entities.interactions;
+    for (std::size_t i = 0; i < interactions.size(); ++i) {
+        const TransformComponent* t = m_entities.transforms.get(interactions.entityAt(i));
+        if (t) interactions[i].data.area.position = t->position + interactions[i].offset;
+    }
+}
+
+sf::FloatRect GameMap::colliderBounds(const TransformComponent& t, const ColliderComponent& c)
+{
+    return sf::FloatRect(t.position + c.offset, c.size);
+}
+
+bool GameMap::collidesStatic(const sf::FloatRect& bounds) const
+{
+    for (const auto& solid : m_solids) {
+        if (intersectsShapeAABB(solid, bounds)) return true;
+    }
+    return false;
+}
+
+namespace {
+// 扫掠 SAT：AABB 以 delta 平移，与静止凸四边形在每条分离轴上求进入/离开时刻，
+// 取进入时刻的最大值与离开时刻的最小值；进入早于离开且落在 [0,1] 内即为命中
+// startOverlap 表示 t=0 时已相交（调用方决定是否忽略）
+bool sweepShapeAABB(const CollisionShape& shape, const sf::FloatRect& box, const sf::Vector2f& delta,
+                    float& outTime, sf::Vector2f& outNormal, bool& startOverlap) {
+    const auto& rv = shape.verts;
+    const auto av = getVertices(box);
+    const std::array<sf::Vector2f, 4> axes{ rv[1] - rv[0], rv[3] - rv[0], sf::Vector2f{1.f, 0.f}, sf::Vector2f{0.f, 1.f} };
+
+    float tEnter = -std::numeric_limits<float>::max();
+    float tExit = std::numeric_limits<float>::max();
+    sf::Vector2f enterNormal{0.f, 0.f};
+    for (auto axis : axes) {
+        const float len = std::sqrt(axis.x * axis.x + axis.y * axis.y);
+        if (len <= 1e-6f) continue;
+        axis = { axis.x / len, axis.y / len };
+        float aMin, aMax, bMin, bMax;
+        projectOnAxis(av, axis, aMin, aMax);
+        projectOnAxis(rv, axis, bMin, bMax);
+        const float v = dot(delta, axis);
+        if (std::abs(v) <= 1e-8f) {
+            if (aMax <= bMin || bMax <= aMin) return false; // 该轴上始终分离
+            continue;
+        }
+        float t0 = (bMin - aMax) / v;
+        float t1 = (bMax - aMin) / v;
+        if (t0 > t1) std::swap(t0, t1);
+        if (t0 > tEnter) {
+            tEnter = t0;
+            enterNormal = (v > 0.f) ? -axis : axis; // 法线与移动方向相反
+        }
+        tExit = std::min(tExit, t1);
+        if (tEnter > tExit) return false;
     }
-    // 交互物体的碰撞箱（若设置）也参与阻挡
-    for (const auto& it : m_interactables) {
-        if (it.collider.has_value()) {
-            if (intersectsRotAABB(*it.collider, bounds)) return true;
+    if (tExit <= 0.f || tEnter > 1.f) return false;
+    startOverlap = tEnter < 0.f;
+    outTime = std::max(0.f, tEnter);
+    outNormal = enterNormal;
+    return true;
+}
+}
+
+bool GameMap::sweep(const sf::FloatRect& box, const sf::Vector2f& delta, SweepHit& outHit) const
+{
+    // 粗筛：起点与终点包围盒的并集
+    const sf::Vector2f lo{ std::min(box.position.x, box.position.x + delta.x), std::min(box.position.y, box.position.y + delta.y) };
+    const sf::Vector2f hi{ std::max(box.position.x, box.position.x + delta.x) + box.size.x,
+                           std::max(box.position.y, box.position.y + delta.y) + box.size.y };
+    const sf::FloatRect swept(lo, hi - lo);
+
+    bool hit = false;
+    SweepHit best;
+    auto consider = [&](const CollisionShape& shape) {
+        if (!aabbOverlap(shape.bounds, swept)) return;
+        float t = 1.f;
+        sf::Vector2f n;
+        bool startOverlap = false;
+        if (!sweepShapeAABB(shape, box, delta, t, n, startOverlap) || startOverlap) return;
+        if (!hit || t < best.time) {
+            best.time = t;
+            best.normal = n;
+            hit = true;
         }
+    };
+
+    for (const auto& solid : m_solids) consider(solid);
+    const auto& colliders = m_entities.colliders;
+    for (std::size_t i = 0; i < colliders.size(); ++i) {
+        const TransformComponent* t = m_entities.transforms.get(colliders.entityAt(i));
+        if (!t) continue;
+        const sf::FloatRect b = colliderBounds(*t, colliders[i]);
+        // NPC 碰撞箱轴对齐：先按 AABB 排除，只为可能命中的构造形状
+        if (aabbOverlap(b, swept)) consider(makeCollisionShape(RotRect{ b.position, b.size, 0.f }));
+    }
+
+    if (hit) outHit = best;
+    return hit;
+}
+
+bool GameMap::checkCollision(const sf::FloatRect& bounds)
+{
+    // 墙体与交互物体的碰撞箱统一存放在 m_solids；NPC 碰撞箱随位置变化，逐帧取实体数据
+    if (collidesStatic(bounds)) return true;
+    const auto& colliders = m_entities.colliders;
+    for (std::size_t i = 0; i < colliders.size(); ++i) {
+        const TransformComponent* t = m_entities.transforms.get(colliders.entityAt(i));
+        if (t && aabbOverlap(colliderBounds(*t, colliders[i]), bounds)) return true;
     }
     return false;
 }
@@ -258,9 +679,9 @@ bool GameMap::resolveCollision(const sf::FloatRect& bounds, sf::Vector2f& outMTV
     float bestLen = std::numeric_limits<float>::max();
     sf::Vector2f best{0.f, 0.f};
 
-    auto consider = [&](const RotRect& rr) {
+    auto consider = [&](const CollisionShape& shape) {
         sf::Vector2f mtv;
-        if (mtvRotAABB(rr, bounds, mtv)) {
+        if (mtvShapeAABB(shape, bounds, mtv)) {
             float len = std::sqrt(mtv.x * mtv.x + mtv.y * mtv.y);
             if (len < bestLen) {
                 bestLen = len;
@@ -270,11 +691,13 @@ bool GameMap::resolveCollision(const sf::FloatRect& bounds, sf::Vector2f& outMTV
         }
     };
 
-    for (const auto& wall : m_walls) consider(wall);
-    for (const auto& it : m_interactables) {
-        if (it.collider.has_value()) {
-            consider(*it.collider);
-        }
+    for (const auto& solid : m_solids) consider(solid);
+    const auto& colliders = m_entities.colliders;
+    for (std::size_t i = 0; i < colliders.size(); ++i) {
+        const TransformComponent* t = m_entities.transforms.get(colliders.entityAt(i));
+        if (!t) continue;
+        const sf::FloatRect box = colliderBounds(*t, colliders[i]);
+        if (aabbOverlap(box, bounds)) consider(makeCollisionShape(RotRect{ box.position, box.size, 0.f }));
     }
 
     if (collided) outMTV = best;
@@ -290,6 +713,12 @@ Interactable* GameMap::checkInteraction(const sf::FloatRect& sensor)
             return &it;
         }
     }
+    // NPC 的交互范围为轴对齐矩形，随实体移动
+    for (auto& ic : m_entities.interactions) {
+        if (ic.data.area.findIntersection(sensor)) {
+            return &ic.data;
+        }
+    }
     return nullptr;
 }
 
@@ -303,61 +732,92 @@ WarpTrigger* GameMap::checkWarp(const sf::FloatRect& bounds)
     return nullptr;
 }
 
-void GameMap::draw(sf::RenderWindow& window)
+void GameMap::draw(sf::RenderTarget& target)
 {
-    drawBackground(window);
+    drawBackground(target);
 
     // 默认绘制：先背景、再道具（未排序），主要保留兼容性；深度排序请使用 gatherDrawItems + 外部排序
-    for (auto& p : m_props) {
-        if (p.sprite.has_value()) {
-            window.draw(*p.sprite);
+    for (const auto& s : m_entities.sprites) {
+        if (s.sprite.has_value()) {
+            target.draw(*s.sprite);
         }
     }
 
     if (m_debugDraw) {
-        drawDebugOverlays(window);
+        drawDebugOverlays(target);
     }
 }
 
-void GameMap::drawDebugOverlays(sf::RenderWindow& window)
+void GameMap::drawDebugOverlays(sf::RenderTarget& target)
 {
     if (!m_debugDraw) return;
+    const sf::FloatRect viewRect = viewRectOf(target);
     // 可视化：墙体（绿色半透明）、交互（蓝色半透明）、交互碰撞（红色半透明）、传送（黄色半透明）
     sf::RectangleShape rect;
     rect.setFillColor(sf::Color(0, 255, 0, 60));
     rect.setOutlineColor(sf::Color(0, 180, 0));
     rect.setOutlineThickness(1.f);
-    for (const auto& w : m_walls) {
+    for (std::size_t i = 0; i < m_walls.size(); ++i) {
+        const RotRect& w = m_walls[i];
+        if (!aabbOverlap(m_solids[m_wallSolids[i]].bounds, viewRect)) continue;
         rect.setPosition(w.position);
         rect.setSize(w.size);
         rect.setRotation(sf::degrees(w.angleDeg));
-        window.draw(rect);
+        target.draw(rect);
     }
 
     // Interactables area - blue
-    for (const auto& it : m_interactables) {
-        rect.setFillColor(sf::Color(0, 0, 255, 60));
-        rect.setOutlineColor(sf::Color(0, 0, 180));
-        rect.setPosition(it.area.position);
-        rect.setSize(it.area.size);
-        rect.setRotation(sf::degrees(it.areaAngleDeg));
-        window.draw(rect);
-        if (it.collider.has_value()) {
+    for (std::size_t i = 0; i < m_interactables.size(); ++i) {
+        const Interactable& it = m_interactables[i];
+        if (aabbOverlap(m_interactableAreaBounds[i], viewRect)) {
+            rect.setFillColor(sf::Color(0, 0, 255, 60));
+            rect.setOutlineColor(sf::Color(0, 0, 180));
+            rect.setPosition(it.area.position);
+            rect.setSize(it.area.size);
+            rect.setRotation(sf::degrees(it.areaAngleDeg));
+            target.draw(rect);
+        }
+        if (it.collider.has_value() && aabbOverlap(m_solids[m_interactableSolids[i]].bounds, viewRect)) {
             rect.setFillColor(sf::Color(255, 0, 0, 60));
             rect.setOutlineColor(sf::Color(180, 0, 0));
             rect.setPosition(it.collider->position);
             rect.setSize(it.collider->size);
             rect.setRotation(sf::degrees(it.collider->angleDeg));
-            window.draw(rect);
+            target.draw(rect);
         }
     }
 
+    // NPC 交互范围（蓝色）与碰撞箱（红色）
+    rect.setRotation(sf::degrees(0.f));
+    for (const auto& ic : m_entities.interactions) {
+        if (!aabbOverlap(ic.data.area, viewRect)) continue;
+        rect.setFillColor(sf::Color(0, 0, 255, 60));
+        rect.setOutlineColor(sf::Color(0, 0, 180));
+        rect.setPosition(ic.data.area.position);
+        rect.setSize(ic.data.area.size);
+        target.draw(rect);
+    }
+    const auto& colliders = m_entities.colliders;
+    for (std::size_t i = 0; i < colliders.size(); ++i) {
+        const TransformComponent* t = m_entities.transforms.get(colliders.entityAt(i));
+        if (!t) continue;
+        const sf::FloatRect box = colliderBounds(*t, colliders[i]);
+        if (!aabbOverlap(box, viewRect)) continue;
+        rect.setFillColor(sf::Color(255, 0, 0, 60));
+        rect.setOutlineColor(sf::Color(180, 0, 0));
+        rect.setPosition(box.position);
+        rect.setSize(box.size);
+        target.draw(rect);
+    }
+
     // Warps - yellow
     rect.setFillColor(sf::Color(255, 255, 0, 60));
     rect.setOutlineColor(sf::Color(180, 180, 0));
+    rect.setRotation(sf::degrees(0.f));
     for (const auto& wp : m_warps) {
+        if (!aabbOverlap(wp.area, viewRect)) continue;
         rect.setPosition(wp.area.position);
         rect.setSize(wp.area.size);
-        window.draw(rect);
+        target.draw(rect);
     }
 }
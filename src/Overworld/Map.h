@@ -2,44 +2,42 @@
 地图数据结构。
 包含：
 
-地图
+地图（背景图 / 瓦片图层）
 
 传送点
 
-物体列表（NPC, Interactable）
+物体列表（NPC, Interactable）：动画道具与行走 NPC 以实体-组件形式存放在 EntityStore
 */
 
 #pragma once
 #include <SFML/Graphics.hpp>
+#include <array>
+#include <memory>
 #include <vector>
 #include <string>
 #include <optional>
-
-// 旋转矩形：以 position 为左上角，绕该点按角度旋转
-struct RotRect {
-    sf::Vector2f position;
-    sf::Vector2f size;
-    float angleDeg = 0.f;
-};
-
-struct WarpTrigger {
-    sf::FloatRect area;      // 踩到哪里触发
-    std::string targetMap;   // 去哪个地图
-    sf::Vector2f targetPos;  // 去地图的哪个坐标
-};
-
-struct Interactable {
-    sf::FloatRect area;      // 交互范围
-    std::string textID;      // 对话ID
-    // 也可以加回调函数
-    float areaAngleDeg = 0.f;              // 交互范围的旋转角度（度）
-    std::optional<RotRect> collider;       // 可选：用于阻挡移动的碰撞箱（可旋转）
+#include "Overworld/TileLayer.h"
+#include "Overworld/MapTypes.h"
+#include "Overworld/EntityStore.h"
+#include "Overworld/DrawList.h"
+#include "Overworld/NavGrid.h"
+
+// 行走 NPC 的生成参数（RoomLoader 按房间文件构造）
+struct NpcSpawn {
+    std::shared_ptr<const ClipSet> walk;  // 行走片段（Down/Left/Right/Up），同外观的 NPC 共享图集
+    sf::Vector2f position{0.f, 0.f};      // 脚底中心
+    sf::Vector2f scale{1.f, 1.f};
+    sf::Vector2f colliderSize{16.f, 8.f}; // 脚底碰撞箱；任一边为 0 表示不阻挡
+    std::string textID;                   // 为空表示不可交互
+    sf::Vector2f interactSize{32.f, 32.f};// 交互范围（以脚底中心为底边中点）
+    float wanderRadius = 0.f;             // 游荡半径；0 表示原地站立
+    float speed = 40.f;
 };
 
-// 深度排序绘制项：yKey 越大越后画（通常取贴图底部的 y）
-struct DrawItem {
-    sf::Drawable* drawable = nullptr;
-    float yKey = 0.f;
+// 扫掠查询结果：time 为沿位移的首次接触比例 [0,1]，normal 为接触面法线（单位向量，指向移动体）
+struct SweepHit {
+    float time = 1.f;
+    sf::Vector2f normal{0.f, 0.f};
 };
 
 class GameMap {
@@ -49,39 +47,73 @@ public:
     // 工具：清空并按房间数据构建
     void clear();
     void setBackground(const std::string& path, const sf::Vector2f& scale = {1.f, 1.f}, const sf::Vector2f& position = {0.f, 0.f});
+    // 使用已加载的共享贴图（RoomCache 常驻），不重复解码
+    void setBackground(std::shared_ptr<const sf::Texture> texture, const sf::Vector2f& scale = {1.f, 1.f}, const sf::Vector2f& position = {0.f, 0.f});
+    // 瓦片图层：按添加顺序绘制在背景图之上、道具之下
+    void addTileLayer(TileLayer layer);
     // 轴对齐墙（无旋转）
     void addWall(const sf::FloatRect& wall);
     // 旋转墙：以 position 为左上角，绕该点旋转 angleDeg
     void addWall(const RotRect& wall);
+    // 已烘焙几何的墙（RoomLoader 使用，免去运行时重算顶点）
+    void addWall(const RotRect& wall, const CollisionShape& shape);
     void addInteractable(const Interactable& interactable);
+    void addInteractable(const Interactable& interactable, const CollisionShape& colliderShape);
     void addWarp(const WarpTrigger& warp);
+    const std::vector<WarpTrigger>& getWarps() const { return m_warps; }
     void setDebugDraw(bool enabled) { m_debugDraw = enabled; }
-    // 兼容旧接口（若仍需按名称加载可扩展为调用外部房间构建器）
-    void load(const std::string& mapName);
+    // 摄像机活动范围：未显式设置时取 640x480 与全部瓦片图层范围的并集
+    void setCameraBounds(const sf::FloatRect& bounds) { m_cameraBounds = bounds; }
+    sf::FloatRect getCameraBounds() const;
+    // 按房间名加载 assets/room/<name>.json（经 RoomLoader 烘焙缓存），失败时地图为空
+    bool load(const std::string& roomName);
 
-    // 绘制背景（不含道具/调试）
-    void drawBackground(sf::RenderWindow& window);
+    // 绘制背景图与瓦片图层（不含道具/调试）；瓦片按当前视野裁剪
+    void drawBackground(sf::RenderTarget& target);
 
     // 收集需要按 y 排序的绘制项（道具等）
     void gatherDrawItems(std::vector<DrawItem>& outItems);
-
-    // 绘制调试辅助（墙/交互/传送/碰撞框）
-    void drawDebugOverlays(sf::RenderWindow& window);
+    // 把实体精灵登记到持久绘制列表：不移动的道具作为静态项，带游荡 AI 的 NPC 作为动态项
+    // 实体增删后（entities().revision() 变化）需重新登记
+    void buildDrawList(DrawList& list);
+    // 每帧刷新动态项的排序键与包围盒
+    void refreshDrawList(DrawList& list);
+
+    // 绘制调试辅助（墙/交互/传送/碰撞框），只画与当前视野相交的部分
+    void drawDebugOverlays(sf::RenderTarget& target);
     
     // 动画道具：在地图上循环播放的简单精灵（如存档点）
-    int addAnimatedProp(const std::vector<std::string>& framePaths,
-                        const sf::Vector2f& position,
-                        const sf::Vector2f& scale = {1.f, 1.f},
-                        float frameTime = 0.12f);
+    EntityId addAnimatedProp(const std::vector<std::string>& framePaths,
+                             const sf::Vector2f& position,
+                             const sf::Vector2f& scale = {1.f, 1.f},
+                             float frameTime = 0.12f);
+    EntityId addAnimatedProp(std::vector<std::shared_ptr<const sf::Texture>> frames,
+                             const sf::Vector2f& position,
+                             const sf::Vector2f& scale = {1.f, 1.f},
+                             float frameTime = 0.12f);
+    // 行走 NPC：位置 + 精灵 + 四方向动画，按参数附加碰撞箱/交互/游荡组件
+    EntityId addNpc(const NpcSpawn& npc);
+    EntityStore& entities() { return m_entities; }
+    const EntityStore& entities() const { return m_entities; }
     
-    // 每帧更新（驱动动画等）
+    // 每帧更新：游荡 AI → 帧动画 → 精灵/交互范围同步位置
     void update(float dt);
     
     // 核心：检查某个人会不会撞墙
     // 返回 true 表示撞了
     bool checkCollision(const sf::FloatRect& bounds);
-    // 计算最小平移向量（MTV）将 AABB 推出障碍，返回是否相交
+    // 计算最小平移向量（MTV）将 AABB 推出障碍（含 NPC 碰撞箱），返回是否相交
     bool resolveCollision(const sf::FloatRect& bounds, sf::Vector2f& outMTV) const;
+    // 连续碰撞：AABB 沿 delta 平移时最早碰到的阻挡几何（墙、交互碰撞箱、NPC），返回是否命中
+    // 起始时已重叠的几何被忽略（由 resolveCollision 先推出），保证角色能离开重叠状态
+    bool sweep(const sf::FloatRect& box, const sf::Vector2f& delta, SweepHit& outHit) const;
+    // 仅与静态阻挡几何（墙 + 交互物碰撞箱）判定，NPC 移动与寻路烘焙使用
+    bool collidesStatic(const sf::FloatRect& bounds) const;
+
+    // 寻路网格：房间构建完成后按静态阻挡几何烘焙一次（RoomLoader::apply 末尾调用）
+    void bakeNavigation();
+    NavGrid& navGrid() { return m_navGrid; }
+    const NavGrid& navGrid() const { return m_navGrid; }
 
     // 核心：检查交互
     // sensor: 玩家面前的一小块区域
@@ -91,26 +123,32 @@ public:
     WarpTrigger* checkWarp(const sf::FloatRect& bounds);
 
     // 旧接口：仅供兼容，不再用于深度排序；保留便于未来调用
-    void draw(sf::RenderWindow& window);
+    void draw(sf::RenderTarget& target);
 
 private:
     std::optional<sf::Sprite> m_bgSprite;
-    std::optional<sf::Texture> m_bgTexture;
+    std::shared_ptr<const sf::Texture> m_bgTexture; // 可能与 RoomCache 共享
+    std::vector<TileLayer> m_tileLayers;
+    std::optional<sf::FloatRect> m_cameraBounds;
     
-    std::vector<RotRect> m_walls;             // 所有的墙（支持旋转）
+    std::vector<RotRect> m_walls;             // 所有的墙（支持旋转，仅调试绘制使用）
+    std::vector<CollisionShape> m_solids;     // 阻挡几何：墙 + 交互物碰撞箱（预计算顶点/AABB）
     std::vector<Interactable> m_interactables;
+    // 调试绘制的视口裁剪：与 m_walls / m_interactables 一一对应，加入时记录，绘制时不再重建形状
+    std::vector<std::size_t> m_wallSolids;              // 墙在 m_solids 中的下标
+    std::vector<std::size_t> m_interactableSolids;      // 交互物碰撞箱在 m_solids 中的下标（无碰撞箱为 npos）
+    std::vector<sf::FloatRect> m_interactableAreaBounds; // 交互范围（可旋转）的外接 AABB
     std::vector<WarpTrigger> m_warps;
     bool m_debugDraw = true; // 调试绘制可视化
 
-    struct AnimatedProp {
-        std::vector<sf::Texture> frames;
-        std::optional<sf::Sprite> sprite;
-        sf::Vector2f position{0.f, 0.f};
-        sf::Vector2f scale{1.f, 1.f};
-        float frameTime = 0.12f; // 每帧时长
-        float timeAcc = 0.f;
-        int frameIndex = 0;
-    };
-    std::vector<AnimatedProp> m_props;
+    EntityStore m_entities; // 动画道具与 NPC
+    NavGrid m_navGrid;      // 覆盖摄像机活动范围，按队员脚底尺寸烘焙
+    // 实体脚底碰撞箱（世界坐标）
+    static sf::FloatRect colliderBounds(const TransformComponent& t, const ColliderComponent& c);
+
+    // 系统：按组件数组顺序遍历
+    void updateWanderers(float dt);
+    void updateAnimations(float dt);
+    void syncTransforms();
 };
 
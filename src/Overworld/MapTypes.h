@@ -0,0 +1,51 @@
+﻿/*
+地图基础几何与数据类型。
+包含：
+
+旋转矩形与预计算碰撞几何
+
+传送点 / 交互物
+
+深度排序绘制项
+*/
+
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <array>
+#include <optional>
+#include <string>
+
+// 旋转矩形：以 position 为左上角，绕该点按角度旋转
+struct RotRect {
+    sf::Vector2f position;
+    sf::Vector2f size;
+    float angleDeg = 0.f;
+};
+
+// 预计算的碰撞几何：四个顶点与外接 AABB（烘焙房间时算好，运行时直接用）
+struct CollisionShape {
+    std::array<sf::Vector2f, 4> verts; // 按 position 左上角起顺时针
+    sf::FloatRect bounds;              // 外接 AABB，用于快速排除
+};
+CollisionShape makeCollisionShape(const RotRect& rr);
+
+struct WarpTrigger {
+    sf::FloatRect area;      // 踩到哪里触发
+    std::string targetMap;   // 去哪个地图
+    sf::Vector2f targetPos;  // 去地图的哪个坐标
+};
+
+struct Interactable {
+    sf::FloatRect area;      // 交互范围
+    std::string textID;      // 对话ID
+    // 也可以加回调函数
+    float areaAngleDeg = 0.f;              // 交互范围的旋转角度（度）
+    std::optional<RotRect> collider;       // 可选：用于阻挡移动的碰撞箱（可旋转）
+};
+
+// 深度排序绘制项：yKey 越大越后画（通常取贴图底部的 y）
+struct DrawItem {
+    sf::Drawable* drawable = nullptr;
+    float yKey = 0.f;
+    sf::FloatRect bounds; // 世界坐标包围盒，用于视野裁剪
+};
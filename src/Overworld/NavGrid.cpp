@@ -0,0 +1,238 @@
+﻿#include "Overworld/NavGrid.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+//
+// 寻路网格（NavGrid）
+// -------------------
+// 职责：
+// - 房间加载后按阻挡几何烘焙可通行格（以格子中心为脚底中心放置单位碰撞箱，不碰撞即视为可通行）
+// - A* 查询：8 邻接、对角移动要求两侧正交格均可通行（禁止切角），八方向距离作启发
+// - 路径平滑：沿原始格路径做视线检测，只保留拐点，减少折线抖动
+// 关键约定：
+// - 工作缓冲（g 值/父节点/开放表）在查询间复用，以查询序号（stamp）判定数据是否属于本次查询
+// - 路径缓存在重新烘焙时清空
+//
+
+namespace {
+constexpr float kInf = std::numeric_limits<float>::max();
+constexpr float kDiagonal = 1.41421356f;
+constexpr int kDx[8] = { 1, -1, 0, 0, 1, 1, -1, -1 };
+constexpr int kDy[8] = { 0, 0, 1, -1, 1, -1, 1, -1 };
+
+// 八方向距离（octile）：允许对角移动时的一致启发
+float octile(int ax, int ay, int bx, int by) {
+    const float dx = static_cast<float>(std::abs(ax - bx));
+    const float dy = static_cast<float>(std::abs(ay - by));
+    return (dx + dy) + (kDiagonal - 2.f) * std::min(dx, dy);
+}
+
+struct HeapGreater {
+    bool operator()(const std::pair<float, int>& a, const std::pair<float, int>& b) const { return a.first > b.first; }
+};
+}
+
+void NavGrid::clear()
+{
+    m_cols = 0;
+    m_rows = 0;
+    m_walkable.clear();
+    m_pathCache.clear();
+    m_pathCacheNext = 0;
+}
+
+void NavGrid::build(const sf::FloatRect& bounds, float cellSize, const sf::Vector2f& agentSize, const BlockedQuery& blocked)
+{
+    clear();
+    if (cellSize <= 0.f || bounds.size.x <= 0.f || bounds.size.y <= 0.f) return;
+    m_origin = bounds.position;
+    m_cellSize = cellSize;
+    m_cols = static_cast<int>(std::ceil(bounds.size.x / cellSize));
+    m_rows = static_cast<int>(std::ceil(bounds.size.y / cellSize));
+    const std::size_t count = static_cast<std::size_t>(m_cols) * static_cast<std::size_t>(m_rows);
+
+    m_walkable.assign(count, 1);
+    for (int i = 0; i < static_cast<int>(count); ++i) {
+        const sf::Vector2f c = cellCenter(i);
+        const sf::FloatRect box({ c.x - agentSize.x * 0.5f, c.y - agentSize.y }, agentSize);
+        if (blocked && blocked(box)) m_walkable[static_cast<std::size_t>(i)] = 0;
+    }
+
+    m_g.assign(count, kInf);
+    m_parent.assign(count, -1);
+    m_stamp.assign(count, 0);
+    m_closedStamp.assign(count, 0);
+    m_query = 0;
+    m_open.reserve(count);
+}
+
+int NavGrid::cellIndex(const sf::Vector2f& p) const
+{
+    const int cx = static_cast<int>(std::floor((p.x - m_origin.x) / m_cellSize));
+    const int cy = static_cast<int>(std::floor((p.y - m_origin.y) / m_cellSize));
+    if (cx < 0 || cy < 0 || cx >= m_cols || cy >= m_rows) return -1;
+    return cy * m_cols + cx;
+}
+
+sf::Vector2f NavGrid::cellCenter(int index) const
+{
+    const int cx = index % m_cols;
+    const int cy = index / m_cols;
+    return { m_origin.x + (static_cast<float>(cx) + 0.5f) * m_cellSize,
+             m_origin.y + (static_cast<float>(cy) + 0.5f) * m_cellSize };
+}
+
+bool NavGrid::walkable(int cx, int cy) const
+{
+    if (cx < 0 || cy < 0 || cx >= m_cols || cy >= m_rows) return false;
+    return m_walkable[static_cast<std::size_t>(cy * m_cols + cx)] != 0;
+}
+
+bool NavGrid::isWalkable(const sf::Vector2f& position) const
+{
+    const int idx = cellIndex(position);
+    return idx >= 0 && m_walkable[static_cast<std::size_t>(idx)] != 0;
+}
+
+// 从 index 向外逐圈搜索最近的可通行格（最多 8 圈）
+int NavGrid::nearestWalkable(int index) const
+{
+    if (index < 0) return -1;
+    if (m_walkable[static_cast<std::size_t>(index)]) return index;
+    const int cx = index % m_cols;
+    const int cy = index / m_cols;
+    for (int r = 1; r <= 8; ++r) {
+        int best = -1;
+        float bestDist = kInf;
+        for (int dy = -r; dy <= r; ++dy) {
+            for (int dx = -r; dx <= r; ++dx) {
+                if (std::max(std::abs(dx), std::abs(dy)) != r) continue;
+                if (!walkable(cx + dx, cy + dy)) continue;
+                const float d = static_cast<float>(dx * dx + dy * dy);
+                if (d < bestDist) { bestDist = d; best = (cy + dy) * m_cols + (cx + dx); }
+            }
+        }
+        if (best >= 0) return best;
+    }
+    return -1;
+}
+
+// 格间视线：沿直线以半格步长采样，途经格均可通行（含对角相邻的两侧格，与禁止切角一致）
+bool NavGrid::lineOfSight(int a, int b) const
+{
+    const sf::Vector2f pa = cellCenter(a);
+    const sf::Vector2f pb = cellCenter(b);
+    const sf::Vector2f d = pb - pa;
+    const float len = std::sqrt(d.x * d.x + d.y * d.y);
+    const int steps = std::max(1, static_cast<int>(std::ceil(len / (m_cellSize * 0.5f))));
+    int prevX = a % m_cols;
+    int prevY = a / m_cols;
+    for (int i = 1; i <= steps; ++i) {
+        const sf::Vector2f p = pa + d * (static_cast<float>(i) / static_cast<float>(steps));
+        const int idx = cellIndex(p);
+        if (idx < 0 || !m_walkable[static_cast<std::size_t>(idx)]) return false;
+        const int x = idx % m_cols;
+        const int y = idx / m_cols;
+        if (x != prevX && y != prevY && (!walkable(prevX, y) || !walkable(x, prevY))) return false;
+        prevX = x;
+        prevY = y;
+    }
+    return true;
+}
+
+bool NavGrid::findPath(const sf::Vector2f& from, const sf::Vector2f& to, std::vector<sf::Vector2f>& outPath)
+{
+    outPath.clear();
+    if (empty()) return false;
+    const int start = nearestWalkable(cellIndex(from));
+    const int goal = nearestWalkable(cellIndex(to));
+    if (start < 0 || goal < 0) return false;
+
+    // 缓存命中：同一起终点格直接复用（末点替换为精确目标）
+    for (const auto& entry : m_pathCache) {
+        if (entry.start == start && entry.goal == goal) {
+            if (!entry.found) return false;
+            outPath = entry.path;
+            if (!outPath.empty()) outPath.back() = to;
+            return true;
+        }
+    }
+
+    // 新的查询序号：stamp 不等于序号的格视为未访问（序号回绕时整体清零）
+    if (++m_query == 0) {
+        std::fill(m_stamp.begin(), m_stamp.end(), 0);
+        std::fill(m_closedStamp.begin(), m_closedStamp.end(), 0);
+        m_query = 1;
+    }
+    const int gx = goal % m_cols;
+    const int gy = goal / m_cols;
+    m_open.clear();
+    m_g[static_cast<std::size_t>(start)] = 0.f;
+    m_parent[static_cast<std::size_t>(start)] = -1;
+    m_stamp[static_cast<std::size_t>(start)] = m_query;
+    m_open.emplace_back(octile(start % m_cols, start / m_cols, gx, gy), start);
+
+    bool found = false;
+    while (!m_open.empty()) {
+        std::pop_heap(m_open.begin(), m_open.end(), HeapGreater{});
+        const int cur = m_open.back().second;
+        m_open.pop_back();
+        if (m_closedStamp[static_cast<std::size_t>(cur)] == m_query) continue; // 旧的重复项
+        m_closedStamp[static_cast<std::size_t>(cur)] = m_query;
+        if (cur == goal) { found = true; break; }
+
+        const int cx = cur % m_cols;
+        const int cy = cur / m_cols;
+        const float gCur = m_g[static_cast<std::size_t>(cur)];
+        for (int k = 0; k < 8; ++k) {
+            const int nx = cx + kDx[k];
+            const int ny = cy + kDy[k];
+            if (!walkable(nx, ny)) continue;
+            const bool diagonal = k >= 4;
+            if (diagonal && (!walkable(cx + kDx[k], cy) || !walkable(cx, cy + kDy[k]))) continue; // 禁止切角
+            const int n = ny * m_cols + nx;
+            if (m_closedStamp[static_cast<std::size_t>(n)] == m_query) continue;
+            const float g = gCur + (diagonal ? kDiagonal : 1.f);
+            if (m_stamp[static_cast<std::size_t>(n)] == m_query && g >= m_g[static_cast<std::size_t>(n)]) continue;
+            m_stamp[static_cast<std::size_t>(n)] = m_query;
+            m_g[static_cast<std::size_t>(n)] = g;
+            m_parent[static_cast<std::size_t>(n)] = cur;
+            m_open.emplace_back(g + octile(nx, ny, gx, gy), n);
+            std::push_heap(m_open.begin(), m_open.end(), HeapGreater{});
+        }
+    }
+
+    PathCacheEntry entry;
+    entry.start = start;
+    entry.goal = goal;
+    entry.found = found;
+    if (found) {
+        // 回溯得到原始格路径（起点 → 终点）
+        m_rawPath.clear();
+        for (int c = goal; c >= 0; c = m_parent[static_cast<std::size_t>(c)]) m_rawPath.push_back(c);
+        std::reverse(m_rawPath.begin(), m_rawPath.end());
+
+        // 视线平滑：从当前锚点出发，尽量连到最远的可见格
+        std::size_t anchor = 0;
+        while (anchor + 1 < m_rawPath.size()) {
+            std::size_t next = anchor + 1;
+            for (std::size_t j = m_rawPath.size() - 1; j > anchor + 1; --j) {
+                if (lineOfSight(m_rawPath[anchor], m_rawPath[j])) { next = j; break; }
+            }
+            entry.path.push_back(cellCenter(m_rawPath[next]));
+            anchor = next;
+        }
+        if (entry.path.empty()) entry.path.push_back(cellCenter(goal));
+        outPath = entry.path;
+        outPath.back() = to;
+    }
+
+    if (m_pathCache.size() < kPathCacheSize) {
+        m_pathCache.push_back(std::move(entry));
+    } else {
+        m_pathCache[m_pathCacheNext] = std::move(entry);
+        m_pathCacheNext = (m_pathCacheNext + 1) % kPathCacheSize;
+    }
+    return found;
+}
@@ -0,0 +1,67 @@
+﻿/*
+探索场景寻路网格。
+包含：
+
+进房间时按阻挡几何烘焙的通行网格（按角色脚底碰撞箱尺寸膨胀）
+
+A* 寻路（8 邻接、禁止切角、视线平滑），缓冲区复用 + 结果缓存
+*/
+
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+class NavGrid {
+public:
+    // 阻挡判定：给定世界坐标 AABB 是否与静态阻挡几何相交
+    using BlockedQuery = std::function<bool(const sf::FloatRect&)>;
+
+    // 烘焙：bounds 为网格覆盖范围，agentSize 为单位脚底碰撞箱尺寸
+    // 以格子中心为脚底中心（箱体底边中点）放置该箱体，无碰撞即可通行；路点即脚底位置
+    void build(const sf::FloatRect& bounds, float cellSize, const sf::Vector2f& agentSize, const BlockedQuery& blocked);
+    void clear();
+    bool empty() const { return m_cols == 0 || m_rows == 0; }
+
+    // A*：outPath 为平滑后的世界坐标路点（不含起点，末点为 to）；失败返回 false
+    // 起点/终点落在阻挡格时就近取可通行格
+    bool findPath(const sf::Vector2f& from, const sf::Vector2f& to, std::vector<sf::Vector2f>& outPath);
+
+    bool isWalkable(const sf::Vector2f& position) const;
+    float cellSize() const { return m_cellSize; }
+
+private:
+    int cellIndex(const sf::Vector2f& p) const;
+    sf::Vector2f cellCenter(int index) const;
+    bool walkable(int cx, int cy) const;
+    int nearestWalkable(int index) const;
+    bool lineOfSight(int a, int b) const;
+
+    struct PathCacheEntry {
+        int start = -1;
+        int goal = -1;
+        bool found = false;
+        std::vector<sf::Vector2f> path;
+    };
+
+    sf::Vector2f m_origin{0.f, 0.f};
+    float m_cellSize = 8.f;
+    int m_cols = 0;
+    int m_rows = 0;
+    std::vector<std::uint8_t> m_walkable;
+
+    // A* 工作缓冲：以查询序号标记有效数据，避免每次清零
+    std::vector<float> m_g;
+    std::vector<int> m_parent;
+    std::vector<std::uint32_t> m_stamp;
+    std::vector<std::uint32_t> m_closedStamp;
+    std::uint32_t m_query = 0;
+    std::vector<std::pair<float, int>> m_open;  // (f, index) 最小堆
+    std::vector<int> m_rawPath;
+
+    // 按 (起点格, 终点格) 缓存最近的查询结果，轮换覆盖
+    static constexpr std::size_t kPathCacheSize = 16;
+    std::vector<PathCacheEntry> m_pathCache;
+    std::size_t m_pathCacheNext = 0;
+};
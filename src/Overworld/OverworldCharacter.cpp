@@ -8,13 +8,14 @@
 // ------------------------------
 // 职责：
 // - 队长（玩家）输入驱动的移动、朝向与动画
-// - 队员（跟随者）基于队长历史记录的延迟跟随与追赶机制
-// - 移动碰撞：与地图墙体/交互碰撞箱做检测，简单分离轴移动（先 X 后 Y）
+// - 队员（跟随者）沿队长轨迹按路径距离跟随（与帧率无关）与追赶机制
+// - 移动碰撞：扫掠求首次接触并沿接触面滑动（多次迭代），与帧长无关，不会穿过薄墙
 // - 绘制与深度排序键收集（底边 y）
 // 关键约定：
 // - 角色原点在贴图底边中心；脚底碰撞箱为底部较小矩形，随缩放而变化
-// - 动画序列为 4 方向 × 4 帧，索引映射为 Down/Left/Right/Up × frame
-// - 跟随延迟按队员序号线性增加，拉长时启用追赶倍率上限
+// - 动画序列为 4 方向 × 4 帧，索引映射为 Down/Left/Right/Up × frame；帧来自共享图集，换帧只改纹理矩形
+// - 跟随间距按队员序号线性增加，拉长时启用追赶倍率上限；距离比较尽量使用平方
+// - 队员直线追赶被墙挡住（持续位移不足）时向地图寻路网格请求路径，沿路点绕行，接近目标后恢复直线追赶
 //
 
 namespace {
@@ -23,8 +24,8 @@ constexpr float kMinFootH = 6.f;
 // 碰撞箱尺寸（相对缩放后贴图），集中在下半身并比整图小
 constexpr float kColliderWidthRatio = 0.45f;
 constexpr float kColliderHeightRatio = 0.18f;
-// 跟随延迟（以帧为单位），值越大成员越远
-constexpr int kFollowDelayPerMemberFrames = 10;
+// 跟随间距（沿队长路径的像素距离），每多一个成员线性增加
+constexpr float kFollowSpacingPerMember = 48.f;
 // 贴近目标时停止移动的阈值，避免抖动
 constexpr float kArriveEpsilon = 0.5f;
 // 追赶加速触发距离与倍率
@@ -34,30 +35,32 @@ constexpr float kCatchUpMultiplier = 1.15f; // 追赶时的速度倍率
 constexpr float kCatchUpMaxMultiplier = 1.6f;
 constexpr float kStretchRatioThreshold = 1.1f; // 距离超过期望 10% 时开启增强追赶
 constexpr float kMoveEpsilonSq = 0.001f;       // 判定“未移动”的平方距离阈值
+// 连续碰撞：接触后与阻挡面保持的间隙（像素）与单次移动的最大滑动迭代次数
+constexpr float kContactSkin = 0.01f;
+constexpr int kMaxSlideIterations = 4;
+// 寻路绕行：位移不足期望步长 30% 持续 0.25 秒视为卡住；目标偏离路径终点超过 32 像素时重规划（最多每 0.3 秒一次）
+constexpr float kStuckProgressRatio = 0.3f;
+constexpr float kStuckTime = 0.25f;
+constexpr float kNavReplanDistance = 32.f;
+constexpr float kNavReplanInterval = 0.3f;
+constexpr float kNavExitDistance = 12.f;       // 距目标点小于该值时退出寻路模式
+
+inline float lengthSq(const sf::Vector2f& v) { return v.x * v.x + v.y * v.y; }
+
+// 按位移主轴取朝向（0:Down, 1:Left, 2:Right, 3:Up）
+int directionOf(const sf::Vector2f& v) {
+    if (std::abs(v.x) > std::abs(v.y)) return v.x < 0.f ? 1 : 2;
+    return v.y < 0.f ? 3 : 0;
+}
 }
 
-OverworldCharacter::OverworldCharacter(Game& game, const SpriteSet& spriteSet)
-    : m_game(game) {
-    // 预加载 4 方向 × 4 帧的贴图；按传入 SpriteSet 的资源路径加载
-    // Down: frames[0], Left: frames[1], Right: frames[2], Up: frames[3]
-    size_t idx = 0;
-    for (int dir = 0; dir < 4; ++dir) {
-        for (int f = 0; f < 4; ++f, ++idx) {
-            const std::string& path = spriteSet.frames[dir][f];
-            if (!m_frames[idx].loadFromFile(path)) {
-                // 如果加载失败，可记录日志；先保留空纹理
-            }
-            m_frameSizes[idx] = m_frames[idx].getSize();
-            if (m_frameSizes[idx].x == 0u || m_frameSizes[idx].y == 0u) {
-                m_frameSizes[idx] = {19u, 40u}; // 兜底尺寸
-            }
-        }
-    }
-
-    m_sprite.emplace(m_frames[0]);
-    m_frameSize = sf::Vector2f(static_cast<float>(m_frameSizes[0].x), static_cast<float>(m_frameSizes[0].y));
-    m_centerOffset = m_frameSize.y * 0.5f;
-    m_sprite->setOrigin({m_frameSize.x * 0.5f, m_frameSize.y});
+OverworldCharacter::OverworldCharacter(Game& game, std::shared_ptr<const ClipSet> walk)
+    : m_game(game), m_walk(std::move(walk)) {
+    // 图集与各帧矩形/原点已由 AnimationLibrary 预先算好
+    // Down: clips[0], Left: clips[1], Right: clips[2], Up: clips[3]
+    if (!m_walk) return;
+    m_sprite.emplace(m_walk->atlas);
+    applyFrame(0, 0);
     // 放大角色贴图为原来的两倍
     m_sprite->setScale({2.f, 2.f});
 }
@@ -108,25 +111,41 @@ void OverworldCharacter::updateLeader(float dt, GameMap& map) {
 }
 
 // ==========================================
-// 碰撞与移动 (核心算法: 分离轴移动)
+// 碰撞与移动 (核心算法: 扫掠 + 沿接触面滑动)
 // ==========================================
 bool OverworldCharacter::moveAndSlide(sf::Vector2f velocity, float dt, GameMap& map) {
-    // 简单分离轴：先 X 后 Y，分别尝试；若某轴上碰撞则回退该轴位移
-    sf::Vector2f offset = velocity * dt;
-    if (offset.x == 0.f && offset.y == 0.f) return false;
+    // 连续碰撞：沿剩余位移扫掠求首次接触，停在接触点前 kContactSkin 处，
+    // 去掉剩余位移中沿法线的分量后继续，最多迭代 kMaxSlideIterations 次（墙角等多面接触）
+    sf::Vector2f remaining = velocity * dt;
+    if (remaining.x == 0.f && remaining.y == 0.f) return false;
 
     const sf::Vector2f startPos = getPosition();
 
-    // 尝试 X
-    m_sprite->move({offset.x, 0.f});
-    if (map.checkCollision(getBounds())) {
-        m_sprite->move({-offset.x, 0.f});
+    // 起始已重叠（例如被 NPC 挤入）：先按最小平移向量推出，扫掠会忽略起始重叠的几何
+    sf::Vector2f mtv;
+    if (map.resolveCollision(getBounds(), mtv)) {
+        m_sprite->move(mtv);
     }
 
-    // 尝试 Y
-    m_sprite->move({0.f, offset.y});
-    if (map.checkCollision(getBounds())) {
-        m_sprite->move({0.f, -offset.y});
+    for (int iter = 0; iter < kMaxSlideIterations; ++iter) {
+        const float lenSq = remaining.x * remaining.x + remaining.y * remaining.y;
+        if (lenSq <= kMoveEpsilonSq) break;
+
+        SweepHit hit;
+        if (!map.sweep(getBounds(), remaining, hit)) {
+            m_sprite->move(remaining);
+            break;
+        }
+
+        // 前进到接触点（留出皮肤间隙，避免下一次扫掠从贴合状态开始）
+        const float len = std::sqrt(lenSq);
+        const float travel = std::max(0.f, hit.time * len - kContactSkin);
+        m_sprite->move(remaining * (travel / len));
+        remaining *= (1.f - hit.time);
+
+        // 滑动：去掉指向阻挡面的分量
+        const float into = remaining.x * hit.normal.x + remaining.y * hit.normal.y;
+        if (into < 0.f) remaining -= hit.normal * into;
     }
 
     const sf::Vector2f endPos = getPosition();
@@ -138,115 +157,90 @@ bool OverworldCharacter::moveAndSlide(sf::Vector2f velocity, float dt, GameMap&
 // ==========================================
 // 队员跟随逻辑 (Susie / Ralsei)
 // ==========================================
-void OverworldCharacter::updateFollower(const std::deque<PositionRecord>& history, int followerIndex, float dt, bool leaderMoving, GameMap& map) {
-    // 根据队长历史记录延迟追随；历史不足时直接追赶最近记录点
+void OverworldCharacter::updateFollower(const LeaderTrail& trail, int followerIndex, float dt, bool leaderMoving, GameMap& map) {
+    // 沿队长轨迹向后取固定路径距离处的点作为目标；轨迹不够长时取最旧记录点
     // 如果队长停下，队员立即停下
-    if (!leaderMoving) {
+    if (!leaderMoving || trail.empty()) {
         m_isMoving = false;
         m_isRunning = false;
         updateAnimation(dt);
         return;
     }
 
-    // 延迟帧数：每多一个队员，延迟线性增加
-    int delay = kFollowDelayPerMemberFrames * (followerIndex + 1);
-
-    if (history.size() <= static_cast<size_t>(delay)) {
-        // 历史不足：立即追赶到最新的记录点（不再同步移动）
-        const auto& targetNow = history.back();
-
-        // 朝向用历史方向，避免抽搐
-        m_direction = targetNow.direction;
-        m_isRunning = targetNow.isRunning;
-
-        sf::Vector2f cur = getPosition();
-        sf::Vector2f diff = { targetNow.position.x - cur.x, targetNow.position.y - cur.y };
-        float dx = diff.x;
-        float dy = diff.y;
-        float dist = std::sqrt(dx * dx + dy * dy);
-        // 估算理想间距：最新点到目标点的距离作为基准，防止直线奔跑时拉长
-        float desiredSpacing = std::max(8.f, std::sqrt(std::pow(history.front().position.x - targetNow.position.x, 2.f) +
-                                                      std::pow(history.front().position.y - targetNow.position.y, 2.f)));
-        float distToLeader = std::sqrt(std::pow(history.front().position.x - cur.x, 2.f) +
-                                       std::pow(history.front().position.y - cur.y, 2.f));
-
-        if (dist > kArriveEpsilon) {
-            float speed = m_isRunning ? m_runSpeed : m_walkSpeed;
-            if (dist > kCatchUpDistance) speed *= kCatchUpMultiplier;
-            // 若整体距离被拉长（相对理想间距），按比例增强追赶但有上限
-            float stretchRatio = (desiredSpacing > 0.01f) ? (distToLeader / desiredSpacing) : 1.f;
-            if (stretchRatio > kStretchRatioThreshold) {
-                float extra = 1.f + (stretchRatio - 1.f) * 0.5f; // 拉长越大，倍率越高
-                speed *= std::min(kCatchUpMaxMultiplier, extra);
-            }
-
-            float step = speed * dt;
-            bool moved = false;
-            if (dist <= step) {
-                if (getPosition() != targetNow.position) {
-                    m_sprite->setPosition(targetNow.position);
-                    moved = true;
-                }
-            } else {
-                sf::Vector2f v(dx / dist * speed, dy / dist * speed);
-                moved = moveAndSlide(v, dt, map);
-            }
-            m_isMoving = moved;
-        } else {
-            m_isMoving = false;
-        }
+    const float spacing = kFollowSpacingPerMember * static_cast<float>(followerIndex + 1);
+    const PositionRecord target = trail.sampleBehind(spacing);
+    const sf::Vector2f leaderPos = trail.newest().position;
 
-        updateAnimation(dt);
-        return;
-    }
-
-    // 获取对应的“过去时刻”的状态
-    const auto& target = history[delay];
-
-    // 使用历史方向，避免基于微小位移造成的朝向抽搐
+    // 使用轨迹方向，避免基于微小位移造成的朝向抽搐
     m_direction = target.direction;
     m_isRunning = target.isRunning;
 
-    sf::Vector2f cur = getPosition();
-    sf::Vector2f diff = { target.position.x - cur.x, target.position.y - cur.y };
-    float dx = diff.x;
-    float dy = diff.y;
-    float dist = std::sqrt(dx * dx + dy * dy);
-    // 估算理想间距：最新点到目标点的距离作为基准，防止直线奔跑时整体拉长
-    float desiredSpacing = std::max(8.f, std::sqrt(std::pow(history.front().position.x - target.position.x, 2.f) +
-                                                  std::pow(history.front().position.y - target.position.y, 2.f)));
-    float distToLeader = std::sqrt(std::pow(history.front().position.x - cur.x, 2.f) +
-                                   std::pow(history.front().position.y - cur.y, 2.f));
-
-    if (dist > kArriveEpsilon) {
+    const sf::Vector2f cur = getPosition();
+    const sf::Vector2f diff = target.position - cur;
+    const float distSq = diff.x * diff.x + diff.y * diff.y;
 
+    if (distSq > kArriveEpsilon * kArriveEpsilon) {
+        const float dist = std::sqrt(distSq);
         float speed = m_isRunning ? m_runSpeed : m_walkSpeed;
         // 轻微追赶：距离过大时小幅提速，减少掉队感
-        if (dist > kCatchUpDistance) {
+        if (distSq > kCatchUpDistance * kCatchUpDistance) {
             speed *= kCatchUpMultiplier;
         }
-        // 若整体距离被拉长（相对理想间距），按比例增强追赶但有上限
-        float stretchRatio = (desiredSpacing > 0.01f) ? (distToLeader / desiredSpacing) : 1.f;
-        if (stretchRatio > kStretchRatioThreshold) {
-            float extra = 1.f + (stretchRatio - 1.f) * 0.5f;
+
+        // 理想间距：队长到目标点的直线距离；队员离队长明显更远时按比例增强追赶（有上限）
+        const sf::Vector2f toTarget = leaderPos - target.position;
+        const float desiredSq = std::max(64.f, toTarget.x * toTarget.x + toTarget.y * toTarget.y);
+        const sf::Vector2f toLeader = leaderPos - cur;
+        const float distToLeaderSq = toLeader.x * toLeader.x + toLeader.y * toLeader.y;
+        if (distToLeaderSq > desiredSq * kStretchRatioThreshold * kStretchRatioThreshold) {
+            const float stretchRatio = std::sqrt(distToLeaderSq / desiredSq);
+            const float extra = 1.f + (stretchRatio - 1.f) * 0.5f; // 拉长越大，倍率越高
             speed *= std::min(kCatchUpMaxMultiplier, extra);
         }
 
-        // 当前帧最大可移动距离（到达则直接贴合历史点）
-        float step = speed * dt;
+        // 寻路模式：目标点已在附近则恢复直接追赶；目标明显偏离路径终点时限频重规划
+        if (m_navIndex < m_navPath.size()) {
+            m_replanTimer -= dt;
+            if (distSq <= kNavExitDistance * kNavExitDistance) {
+                clearNavPath();
+            } else if (m_replanTimer <= 0.f && lengthSq(target.position - m_navPath.back()) > kNavReplanDistance * kNavReplanDistance) {
+                planNavPath(target.position, map);
+            }
+        }
+
+        // 当前帧最大可移动距离（到达则直接贴合轨迹点）
+        const float step = speed * dt;
         bool moved = false;
-        if (dist <= step) {
-            // 足以到达目标：直接贴合到历史点，避免“绕过”
-            if (getPosition() != target.position) {
-                m_sprite->setPosition(target.position);
+        if (m_navIndex < m_navPath.size()) {
+            // 沿路点移动：路点为可通行格中心，足以到达时直接贴合并切换下一个
+            const sf::Vector2f toWaypoint = m_navPath[m_navIndex] - cur;
+            const float wpDistSq = lengthSq(toWaypoint);
+            if (wpDistSq > kMoveEpsilonSq) m_direction = directionOf(toWaypoint);
+            if (wpDistSq <= step * step) {
+                m_sprite->setPosition(m_navPath[m_navIndex]);
                 moved = true;
+                if (++m_navIndex >= m_navPath.size()) clearNavPath();
+            } else {
+                moved = moveAndSlide(toWaypoint * (speed / std::sqrt(wpDistSq)), dt, map);
             }
+        } else if (dist <= step) {
+            // 足以到达目标：直接贴合，避免“绕过”
+            m_sprite->setPosition(target.position);
+            moved = true;
+            m_stuckTimer = 0.f;
         } else {
             // 归一化方向并按速度移动，使用与队长一致的碰撞处理
-            sf::Vector2f v = { dx / dist * speed, dy / dist * speed };
-            moved = moveAndSlide(v, dt, map);
-        }
+            moved = moveAndSlide(diff * (speed / dist), dt, map);
 
+            // 卡住检测：实际位移持续远小于期望步长（被墙挡住、滑动也走不通）时改为寻路绕行
+            const float progress = step * kStuckProgressRatio;
+            if (lengthSq(getPosition() - cur) < progress * progress) {
+                m_stuckTimer += dt;
+                if (m_stuckTimer >= kStuckTime) planNavPath(target.position, map);
+            } else {
+                m_stuckTimer = 0.f;
+            }
+        }
         m_isMoving = moved;
     } else {
         m_isMoving = false;
@@ -256,6 +250,17 @@ void OverworldCharacter::updateFollower(const std::deque<PositionRecord>& histor
     updateAnimation(dt);
 }
 
+void OverworldCharacter::planNavPath(const sf::Vector2f& goal, GameMap& map) {
+    m_stuckTimer = 0.f;
+    m_replanTimer = kNavReplanInterval;
+    if (map.navGrid().findPath(getPosition(), goal, m_navPath)) {
+        m_navIndex = 0;
+    } else {
+        m_navPath.clear();
+        m_navIndex = 0;
+    }
+}
+
 // ==========================================
 // 动画与辅助函数
 // ==========================================
@@ -296,9 +301,14 @@ sf::FloatRect OverworldCharacter::getBounds() const {
 
 void OverworldCharacter::collectDrawItem(std::vector<DrawItem>& outItems) const {
     if (!m_sprite.has_value()) return;
+    outItems.push_back(getDrawItem());
+}
+
+DrawItem OverworldCharacter::getDrawItem() const {
+    if (!m_sprite.has_value()) return DrawItem{};
     auto bounds = m_sprite->getGlobalBounds();
     float yKey = bounds.position.y + bounds.size.y; // 以底部 y 作为排序键（越低越后画）
-    outItems.push_back(DrawItem{ const_cast<sf::Sprite*>(&(*m_sprite)), yKey });
+    return DrawItem{ const_cast<sf::Sprite*>(&(*m_sprite)), yKey, bounds };
 }
 
 sf::Vector2f OverworldCharacter::getCenter() const {
@@ -310,20 +320,18 @@ PositionRecord OverworldCharacter::getRecord() const {
     return { getPosition(), m_direction, m_isMoving, m_isRunning };
 }
 
-void OverworldCharacter::draw(sf::RenderWindow& window) {
+void OverworldCharacter::draw(sf::RenderTarget& target) {
     if (m_sprite.has_value()) {
-        window.draw(*m_sprite);
+        target.draw(*m_sprite);
     }
 }
 
 void OverworldCharacter::applyFrame(int direction, int frameIndex) {
-    // 根据方向与帧索引设置纹理，并重新计算尺寸与原点
-    if (!m_sprite.has_value()) return;
-    int dir = std::clamp(direction, 0, 3);
-    int frame = std::clamp(frameIndex, 0, 3);
-    int idx = dir * 4 + frame;
-    m_sprite->setTexture(m_frames[idx], true);
-    m_frameSize = sf::Vector2f(static_cast<float>(m_frameSizes[idx].x), static_cast<float>(m_frameSizes[idx].y));
+    // 根据方向与帧索引取图集中的帧：只改纹理矩形，尺寸与原点为预计算值
+    if (!m_sprite.has_value() || !m_walk) return;
+    const ClipFrame& frame = m_walk->frame(direction, frameIndex);
+    m_sprite->setTextureRect(frame.rect);
+    m_sprite->setOrigin(frame.origin);
+    m_frameSize = frame.size;
     m_centerOffset = m_frameSize.y * 0.5f;
-    m_sprite->setOrigin({m_frameSize.x * 0.5f, m_frameSize.y});
 }
\ No newline at end of file
@@ -1,56 +1,47 @@
 ﻿#pragma once
 #include <SFML/Graphics.hpp>
-#include <array>
-#include <deque>
+#include <memory>
 #include <optional>
 #include <string>
+#include <vector>
 #include "Manager/InputManager.h"
 #include "Map.h"
+#include "LeaderTrail.h"
 #include "Game/Game.h"
+#include "Overworld/AnimationClip.h"
 
-// 记录每一帧的状态，用于"毛毛虫"跟随
-struct PositionRecord {
-    sf::Vector2f position;
-    int direction;   // 0:下, 1:左, 2:右, 3:上
-    bool isMoving;   // 是否在动（用于播放动画）
-    bool isRunning;  // 是否在跑（用于播放快跑动画）
-};
-
-// 四个方向各 4 帧的贴图路径（按 Down, Left, Right, Up）
-struct SpriteSet {
-    std::array<std::array<std::string, 4>, 4> frames;
-};
 
 class OverworldCharacter {
 public:
-    OverworldCharacter(Game& game, const SpriteSet& spriteSet);
+    // walk：四个方向的行走片段（AnimationLibrary::walk），同一角色的所有实例共享图集
+    OverworldCharacter(Game& game, std::shared_ptr<const ClipSet> walk);
 
     // 队长逻辑：读取输入 -> 移动 -> 碰撞检测
     void updateLeader(float dt, GameMap& map);
 
-    // 队员逻辑：读取历史 -> 设置位置（需要地图用于同步期的碰撞处理）
-    void updateFollower(const std::deque<PositionRecord>& history, int followerIndex, float dt, bool leaderMoving, GameMap& map);
+    // 队员逻辑：沿队长轨迹按路径距离采样目标点 -> 追赶（需要地图用于碰撞处理）
+    void updateFollower(const LeaderTrail& trail, int followerIndex, float dt, bool leaderMoving, GameMap& map);
 
-    void draw(sf::RenderWindow& window);
+    void draw(sf::RenderTarget& target);
     
     // 访问器
     sf::Vector2f getPosition() const { return m_sprite ? m_sprite->getPosition() : sf::Vector2f{}; }
     sf::Vector2f getCenter() const; // 获取中心点（用于交互判定）
     sf::FloatRect getBounds() const; // 获取碰撞箱（脚底）
     void collectDrawItem(std::vector<DrawItem>& outItems) const; // 提供绘制排序所需数据
+    DrawItem getDrawItem() const; // 当前帧的绘制项（精灵 + 底边 y + 包围盒）
     int getDirection() const { return m_direction; }
     bool isMoving() const { return m_isMoving; }
     PositionRecord getRecord() const; // 获取当前帧状态存入历史
 
-    // 允许外部设置位置
-    void setPosition(sf::Vector2f pos) { if (m_sprite) m_sprite->setPosition(pos); }
+    // 允许外部设置位置（瞬移时丢弃寻路状态）
+    void setPosition(sf::Vector2f pos) { if (m_sprite) m_sprite->setPosition(pos); clearNavPath(); }
 
 private:
     Game& m_game; // 引用游戏主程序，获取输入等
 
     std::optional<sf::Sprite> m_sprite;
-    std::array<sf::Texture, 16> m_frames; // 4方向 * 4帧
-    std::array<sf::Vector2u, 16> m_frameSizes{};
+    std::shared_ptr<const ClipSet> m_walk; // 4方向 * 4帧，共享图集
 
     // 动画相关
     int m_direction = 0; // 0:Down, 1:Left, 2:Right, 3:Up
@@ -68,12 +59,22 @@ private:
     sf::Vector2f m_frameSize{19.f, 40.f};
     float m_centerOffset = 20.f; // 根据帧高度动态更新
 
-    // 物理：尝试移动并处理碰撞，返回是否发生位移
+    // 寻路绕行（队员被墙卡住时启用）：平滑后的路点与当前路点下标
+    std::vector<sf::Vector2f> m_navPath;
+    std::size_t m_navIndex = 0;
+    float m_stuckTimer = 0.f;   // 实际位移持续远小于期望步长的累计时长
+    float m_replanTimer = 0.f;  // 重新规划的冷却
+
+    // 寻路：成功则进入路点跟随模式，失败则保持直接追赶
+    void planNavPath(const sf::Vector2f& goal, GameMap& map);
+    void clearNavPath() { m_navPath.clear(); m_navIndex = 0; m_stuckTimer = 0.f; }
+
+    // 物理：扫掠移动并沿接触面滑动，返回是否发生位移
     bool moveAndSlide(sf::Vector2f velocity, float dt, GameMap& map);
     
     // 动画：更新Sprite的纹理区域
     void updateAnimation(float dt);
 
-    // 将 sprite 切换到指定方向/帧，自动根据贴图尺寸调整原点
+    // 将 sprite 切换到指定方向/帧：只更新图集矩形与预计算的原点
     void applyFrame(int direction, int frameIndex);
 };
\ No newline at end of file
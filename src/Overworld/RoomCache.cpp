@@ -0,0 +1,173 @@
+﻿#include "Overworld/RoomCache.h"
+#include <algorithm>
+#include <iostream>
+
+//
+// 房间缓存（RoomCache）
+// ---------------------
+// 职责：
+// - 以 LRU 方式常驻最近访问的房间：烘焙数据与贴图都保留，回到该房间（或原地重载）不再解码
+// - prefetch 提交解码任务（读取房间文件并把图片解码为 sf::Image），再提交依赖它的主线程任务上传为 sf::Texture
+// - 贴图按路径以 weak_ptr 跨房间共享，同一图片在任意时刻只上传一份
+// 关键约定：
+// - 工作线程只接触文件与 sf::Image，不接触 OpenGL 资源；所有 sf::Texture 都在主线程任务中创建
+// - 上传任务捕获 this：析构时等待全部上传任务完成（主线程等待期间会执行它们）
+// - 被淘汰的房间若仍被 GameMap 引用，其贴图由 shared_ptr 延续生命周期，淘汰总是安全的
+//
+
+std::shared_ptr<const sf::Texture> RoomCache::Room::texture(const std::string& path) const {
+    auto it = textures.find(path);
+    return it == textures.end() ? nullptr : it->second;
+}
+
+RoomCache::RoomCache(std::size_t capacity)
+    : m_capacity(capacity == 0 ? 1 : capacity)
+{
+}
+
+RoomCache::~RoomCache() {
+    // 上传任务完成时会从 m_pending 移除自身，先取出计数器再等待
+    std::vector<JobSystem::CounterPtr> uploads;
+    for (const auto& [name, pending] : m_pending) uploads.push_back(pending.uploaded);
+    for (const auto& counter : uploads) JobSystem::getInstance().wait(counter);
+}
+
+// 工作线程：读取（或烘焙）房间数据，并解码尚未常驻的图片
+RoomCache::Decoded RoomCache::decode(std::string roomName, std::vector<std::string> skipPaths) {
+    Decoded result;
+    result.ok = RoomLoader::load(roomName, result.data);
+    if (!result.ok) return result;
+
+    for (const auto& path : RoomLoader::texturePaths(result.data)) {
+        if (std::find(skipPaths.begin(), skipPaths.end(), path) != skipPaths.end()) continue;
+        sf::Image image;
+        if (!image.loadFromFile(path)) {
+            std::cerr << "RoomCache: failed to decode " << path << std::endl;
+            continue;
+        }
+        result.images.emplace_back(path, std::move(image));
+    }
+    return result;
+}
+
+void RoomCache::prefetch(const std::string& roomName) {
+    if (roomName.empty()) return;
+    if (m_index.count(roomName) || m_pending.count(roomName)) return;
+
+    // 已常驻的贴图无需再次解码；快照在主线程取好后交给解码任务
+    std::vector<std::string> skip;
+    for (const auto& [path, weak] : m_textures) {
+        if (!weak.expired()) skip.push_back(path);
+    }
+
+    JobSystem& jobs = JobSystem::getInstance();
+    auto decoded = std::make_shared<Decoded>();
+    Pending pending;
+    pending.decoded = jobs.schedule([decoded, roomName, skip = std::move(skip)] {
+        *decoded = decode(roomName, skip);
+    });
+    pending.uploaded = jobs.schedule([this, decoded, roomName] {
+        m_pending.erase(roomName);
+        if (decoded->ok) insert(roomName, finalize(std::move(*decoded)));
+    }, pending.decoded, JobSystem::Affinity::MainThread);
+    m_pending.emplace(roomName, std::move(pending));
+}
+
+bool RoomCache::isReady(const std::string& roomName) const {
+    auto it = m_pending.find(roomName);
+    return it == m_pending.end() || it->second.decoded->done();
+}
+
+std::shared_ptr<const RoomCache::Room> RoomCache::acquire(const std::string& roomName) {
+    // 1. 常驻命中
+    if (auto it = m_index.find(roomName); it != m_index.end()) {
+        touch(roomName);
+        return it->second->second;
+    }
+
+    // 2. 预加载中：等待上传任务完成（通常渐变期间已解码，这里只在主线程执行上传）
+    if (auto it = m_pending.find(roomName); it != m_pending.end()) {
+        const JobSystem::CounterPtr uploaded = it->second.uploaded;
+        JobSystem::getInstance().wait(uploaded);
+        if (auto found = m_index.find(roomName); found != m_index.end()) {
+            touch(roomName);
+            return found->second->second;
+        }
+        return nullptr;
+    }
+
+    // 3. 未预加载：同步加载
+    Decoded decoded = decode(roomName, {});
+    if (!decoded.ok) return nullptr;
+    auto room = finalize(std::move(decoded));
+    insert(roomName, room);
+    return room;
+}
+
+std::shared_ptr<const sf::Texture> RoomCache::findTexture(const std::string& path) const {
+    auto it = m_textures.find(path);
+    return it == m_textures.end() ? nullptr : it->second.lock();
+}
+
+// 主线程：上传解码好的图片，并为房间收集全部贴图（复用已常驻的共享贴图）
+std::shared_ptr<RoomCache::Room> RoomCache::finalize(Decoded&& decoded) {
+    auto room = std::make_shared<Room>();
+    room->data = std::move(decoded.data);
+
+    for (auto& [path, image] : decoded.images) {
+        if (findTexture(path)) continue; // 解码期间已被其他房间上传
+        auto texture = std::make_shared<sf::Texture>();
+        if (!texture->loadFromImage(image)) {
+            std::cerr << "RoomCache: failed to upload " << path << std::endl;
+            continue;
+        }
+        texture->setSmooth(false);
+        std::shared_ptr<const sf::Texture> shared = std::move(texture);
+        m_textures[path] = shared;
+        room->textures.emplace(path, std::move(shared));
+    }
+
+    for (const auto& path : RoomLoader::texturePaths(room->data)) {
+        if (room->textures.count(path)) continue;
+        if (auto shared = findTexture(path)) {
+            room->textures.emplace(path, std::move(shared));
+            continue;
+        }
+        // 跳过列表中的贴图在解码后被释放：同步补读
+        auto texture = std::make_shared<sf::Texture>();
+        if (!texture->loadFromFile(path)) {
+            std::cerr << "RoomCache: failed to load " << path << std::endl;
+            continue; // 不缓存空贴图，下次进入房间时重试
+        }
+        texture->setSmooth(false);
+        std::shared_ptr<const sf::Texture> loaded = std::move(texture);
+        m_textures[path] = loaded;
+        room->textures.emplace(path, std::move(loaded));
+    }
+    return room;
+}
+
+void RoomCache::insert(const std::string& roomName, std::shared_ptr<Room> room) {
+    if (auto it = m_index.find(roomName); it != m_index.end()) {
+        it->second->second = std::move(room);
+        touch(roomName);
+        return;
+    }
+    m_lru.emplace_front(roomName, std::move(room));
+    m_index[roomName] = m_lru.begin();
+
+    while (m_lru.size() > m_capacity) {
+        m_index.erase(m_lru.back().first);
+        m_lru.pop_back();
+    }
+    // 清理已无人引用的贴图索引
+    for (auto it = m_textures.begin(); it != m_textures.end();) {
+        it = it->second.expired() ? m_textures.erase(it) : std::next(it);
+    }
+}
+
+void RoomCache::touch(const std::string& roomName) {
+    auto it = m_index.find(roomName);
+    if (it == m_index.end()) return;
+    m_lru.splice(m_lru.begin(), m_lru, it->second);
+}
@@ -0,0 +1,77 @@
+﻿/*
+房间缓存与预加载。
+包含：
+
+最近访问房间的 LRU 常驻（房间数据 + 贴图）
+
+工作线程预读房间文件与解码图片
+
+依赖解码任务的主线程任务上传贴图
+*/
+
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "Overworld/RoomLoader.h"
+#include "Utils/JobSystem.h"
+
+class RoomCache {
+public:
+    // 常驻房间：烘焙数据 + 该房间用到的全部贴图（按路径索引）
+    struct Room {
+        RoomData data;
+        std::unordered_map<std::string, std::shared_ptr<const sf::Texture>> textures;
+
+        // 供 RoomLoader::apply 使用的贴图查找
+        std::shared_ptr<const sf::Texture> texture(const std::string& path) const;
+    };
+
+    explicit RoomCache(std::size_t capacity = 4);
+    ~RoomCache();
+    RoomCache(const RoomCache&) = delete;
+    RoomCache& operator=(const RoomCache&) = delete;
+
+    // 异步预加载：工作线程读取房间数据并解码图片，完成后由主线程任务上传贴图并放入常驻
+    // 已常驻或已在加载中时直接返回
+    void prefetch(const std::string& roomName);
+
+    // 该房间是否没有未完成的解码任务（为 true 时 acquire 不会等待工作线程）
+    bool isReady(const std::string& roomName) const;
+
+    // 取得房间：优先命中常驻；预加载未完成时等待；都没有则同步加载。失败返回 nullptr
+    std::shared_ptr<const Room> acquire(const std::string& roomName);
+
+private:
+    // 解码任务产物：房间数据与解码好的图片（尚未上传 GPU）
+    struct Decoded {
+        bool ok = false;
+        RoomData data;
+        std::vector<std::pair<std::string, sf::Image>> images;
+    };
+
+    static Decoded decode(std::string roomName, std::vector<std::string> skipPaths);
+    std::shared_ptr<Room> finalize(Decoded&& decoded);
+    std::shared_ptr<const sf::Texture> findTexture(const std::string& path) const;
+    void insert(const std::string& roomName, std::shared_ptr<Room> room);
+    void touch(const std::string& roomName);
+
+    std::size_t m_capacity;
+
+    // LRU：链表头为最近使用；索引指向链表节点
+    using LruList = std::list<std::pair<std::string, std::shared_ptr<Room>>>;
+    LruList m_lru;
+    std::unordered_map<std::string, LruList::iterator> m_index;
+
+    // 正在加载的房间：解码任务与依赖它的上传任务各自的计数器（上传任务完成时移除）
+    struct Pending {
+        JobSystem::CounterPtr decoded;
+        JobSystem::CounterPtr uploaded;
+    };
+    std::unordered_map<std::string, Pending> m_pending;
+    std::unordered_map<std::string, std::weak_ptr<const sf::Texture>> m_textures; // 跨房间共享（如存档点帧）
+};
@@ -0,0 +1,518 @@
+﻿#include "Overworld/RoomLoader.h"
+#include "Game/GlobalContext.h"
+#include "Overworld/AnimationClip.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <json.hpp>
+
+//
+// 房间加载器（RoomLoader）
+// ------------------------
+// 职责：
+// - 解析 assets/room/<房间名>.json：背景、瓦片图层、墙（可旋转）、交互物、传送点、动画道具、NPC、默认出生点
+// - 预计算墙体与交互碰撞箱的顶点/外接 AABB，烘焙为紧凑二进制写入 cache/rooms/<房间名>.bin
+// - 再次加载时校验缓存头（魔数、版本、源文件修改时间），命中则一次读取完成
+// 关键约定：
+// - 矩形统一写作 [x, y, w, h]，向量写作 [x, y]；角度单位为度，绕左上角旋转
+// - 瓦片图层 "tiles" 为行优先的整数数组（columns × rows），-1 表示空
+// - "camera_bounds" 可选；省略时摄像机范围为 640x480 与瓦片图层范围的并集
+// - NPC 的 "sprite_set" 为 CharacterRegistry 中的角色 ID；"wander_radius" 为 0 时原地站立
+// - 条件字段 "condition" 在实例化时求值，烘焙数据与全局状态无关，可被多次复用
+// - 缓存失效或损坏时静默回落到解析 JSON，缓存写入失败不影响加载
+//
+
+using json = nlohmann::json;
+namespace fs = std::filesystem;
+
+namespace {
+constexpr std::uint32_t kRoomCacheMagic = 0x4D525257; // "WRRM"
+constexpr std::uint32_t kRoomCacheVersion = 4; // 2: 瓦片图层；3: 摄像机范围；4: NPC
+
+// ---------------- JSON 辅助 ----------------
+sf::Vector2f readVec2(const json& j, const sf::Vector2f& fallback) {
+    if (!j.is_array() || j.size() < 2) return fallback;
+    return { j[0].get<float>(), j[1].get<float>() };
+}
+
+sf::FloatRect readRect(const json& j) {
+    if (!j.is_array() || j.size() < 4) return {};
+    return sf::FloatRect({ j[0].get<float>(), j[1].get<float>() }, { j[2].get<float>(), j[3].get<float>() });
+}
+
+RotRect readRotRect(const json& j) {
+    sf::FloatRect r = readRect(j.value("rect", json::array()));
+    return RotRect{ r.position, r.size, j.value("angle", 0.f) };
+}
+
+// ---------------- 二进制读写 ----------------
+class BlobWriter {
+public:
+    explicit BlobWriter(std::ofstream& out) : m_out(out) {}
+    template <typename T>
+    void pod(const T& v) { m_out.write(reinterpret_cast<const char*>(&v), sizeof(T)); }
+    void str(const std::string& s) {
+        pod(static_cast<std::uint32_t>(s.size()));
+        m_out.write(s.data(), static_cast<std::streamsize>(s.size()));
+    }
+    void vec2(const sf::Vector2f& v) { pod(v.x); pod(v.y); }
+    void rect(const sf::FloatRect& r) { vec2(r.position); vec2(r.size); }
+    void rotRect(const RotRect& r) { vec2(r.position); vec2(r.size); pod(r.angleDeg); }
+    void shape(const CollisionShape& s) { for (const auto& v : s.verts) vec2(v); rect(s.bounds); }
+
+private:
+    std::ofstream& m_out;
+};
+
+class BlobReader {
+public:
+    BlobReader(const char* data, std::size_t size) : m_data(data), m_size(size) {}
+    bool ok() const { return m_ok; }
+    template <typename T>
+    T pod() {
+        T v{};
+        if (m_pos + sizeof(T) > m_size) { m_ok = false; return v; }
+        std::memcpy(&v, m_data + m_pos, sizeof(T));
+        m_pos += sizeof(T);
+        return v;
+    }
+    std::string str() {
+        auto len = pod<std::uint32_t>();
+        if (!m_ok || m_pos + len > m_size) { m_ok = false; return {}; }
+        std::string s(m_data + m_pos, len);
+        m_pos += len;
+        return s;
+    }
+    sf::Vector2f vec2() { float x = pod<float>(); float y = pod<float>(); return { x, y }; }
+    sf::FloatRect rect() { auto p = vec2(); auto s = vec2(); return sf::FloatRect(p, s); }
+    RotRect rotRect() { auto p = vec2(); auto s = vec2(); return RotRect{ p, s, pod<float>() }; }
+    CollisionShape shape() {
+        CollisionShape s;
+        for (auto& v : s.verts) v = vec2();
+        s.bounds = rect();
+        return s;
+    }
+    // 数组长度读取：防止损坏文件导致超大分配
+    std::uint32_t count() {
+        auto n = pod<std::uint32_t>();
+        if (n > m_size) { m_ok = false; return 0; }
+        return n;
+    }
+
+private:
+    const char* m_data;
+    std::size_t m_size;
+    std::size_t m_pos = 0;
+    bool m_ok = true;
+};
+
+long long sourceStampOf(const std::string& path) {
+    std::error_code ec;
+    auto t = fs::last_write_time(path, ec);
+    if (ec) return 0;
+    return static_cast<long long>(t.time_since_epoch().count());
+}
+}
+
+std::string RoomLoader::getSourcePath(const std::string& roomName) {
+    return "assets/room/" + roomName + ".json";
+}
+
+std::string RoomLoader::getCachePath(const std::string& roomName) {
+    return "cache/rooms/" + roomName + ".bin";
+}
+
+bool RoomLoader::exists(const std::string& roomName) {
+    std::error_code ec;
+    return fs::exists(getSourcePath(roomName), ec);
+}
+
+bool RoomLoader::evalCondition(const std::string& condition) {
+    if (condition.empty()) return true;
+    bool negate = condition[0] == '!';
+    const std::string flag = negate ? condition.substr(1) : condition;
+    bool value = false;
+    if (flag == "has_holy_mantle") {
+        value = Global::hasHolyMantle;
+    } else {
+        std::cerr << "RoomLoader: unknown condition flag " << flag << std::endl;
+    }
+    return negate ? !value : value;
+}
+
+// ########################################## 加载 ##########################################
+bool RoomLoader::load(const std::string& roomName, RoomData& out) {
+    const std::string src = getSourcePath(roomName);
+    const std::string cache = getCachePath(roomName);
+    const long long stamp = sourceStampOf(src);
+
+    // 1. 缓存命中：源文件未改动（或源文件缺失但缓存仍在，例如发布包只带缓存）
+    if (readCache(cache, stamp, out)) {
+        out.name = roomName;
+        return true;
+    }
+
+    // 2. 解析源文件并写回缓存
+    out = RoomData{};
+    if (!parseSource(src, out)) return false;
+    out.name = roomName;
+    writeCache(cache, stamp, out);
+    return true;
+}
+
+bool RoomLoader::parseSource(const std::string& path, RoomData& out) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "RoomLoader: missing room file " << path << std::endl;
+        return false;
+    }
+
+    try {
+        json j;
+        file >> j;
+
+        if (j.contains("background")) {
+            const auto& bg = j["background"];
+            out.background.path = bg.value("path", "");
+            out.background.scale = readVec2(bg.value("scale", json::array()), {1.f, 1.f});
+            out.background.position = readVec2(bg.value("position", json::array()), {0.f, 0.f});
+        }
+        out.spawn = readVec2(j.value("spawn", json::array()), {320.f, 240.f});
+        if (j.contains("camera_bounds")) {
+            out.cameraBounds = readRect(j["camera_bounds"]);
+        }
+
+        for (const auto& tl : j.value("tile_layers", json::array())) {
+            RoomData::TileLayerDef layer;
+            layer.tileset = tl.value("tileset", "");
+            const sf::Vector2f ts = readVec2(tl.value("tile_size", json::array()), {16.f, 16.f});
+            layer.tileSize = { static_cast<unsigned>(ts.x), static_cast<unsigned>(ts.y) };
+            layer.columns = tl.value("columns", 0);
+            layer.rows = tl.value("rows", 0);
+            layer.scale = tl.value("scale", 1.f);
+            layer.origin = readVec2(tl.value("origin", json::array()), {0.f, 0.f});
+            layer.tiles = tl.value("tiles", std::vector<int>{});
+            layer.condition = tl.value("condition", "");
+            out.tileLayers.push_back(std::move(layer));
+        }
+
+        for (const auto& w : j.value("walls", json::array())) {
+            RoomData::Wall wall;
+            wall.rect = readRotRect(w);
+            wall.shape = makeCollisionShape(wall.rect);
+            wall.condition = w.value("condition", "");
+            out.walls.push_back(std::move(wall));
+        }
+
+        for (const auto& it : j.value("interactables", json::array())) {
+            RoomData::InteractableDef def;
+            def.data.area = readRect(it.value("area", json::array()));
+            def.data.areaAngleDeg = it.value("angle", 0.f);
+            def.data.textID = it.value("id", "");
+            if (it.contains("collider")) {
+                def.data.collider = readRotRect(it["collider"]);
+                def.colliderShape = makeCollisionShape(*def.data.collider);
+            }
+            def.condition = it.value("condition", "");
+            out.interactables.push_back(std::move(def));
+        }
+
+        for (const auto& wp : j.value("warps", json::array())) {
+            RoomData::Warp warp;
+            warp.data.area = readRect(wp.value("area", json::array()));
+            warp.data.targetMap = wp.value("target", "");
+            warp.data.targetPos = readVec2(wp.value("spawn", json::array()), {0.f, 0.f});
+            warp.condition = wp.value("condition", "");
+            out.warps.push_back(std::move(warp));
+        }
+
+        for (const auto& p : j.value("props", json::array())) {
+            RoomData::Prop prop;
+            for (const auto& f : p.value("frames", json::array())) {
+                if (f.is_string()) prop.frames.push_back(f.get<std::string>());
+            }
+            prop.position = readVec2(p.value("position", json::array()), {0.f, 0.f});
+            prop.scale = readVec2(p.value("scale", json::array()), {1.f, 1.f});
+            prop.frameTime = p.value("frame_time", 0.12f);
+            prop.condition = p.value("condition", "");
+            out.props.push_back(std::move(prop));
+        }
+
+        for (const auto& n : j.value("npcs", json::array())) {
+            RoomData::Npc npc;
+            npc.spriteSet = n.value("sprite_set", "");
+            npc.position = readVec2(n.value("position", json::array()), {0.f, 0.f});
+            npc.scale = readVec2(n.value("scale", json::array()), {1.f, 1.f});
+            npc.colliderSize = readVec2(n.value("collider", json::array()), {16.f, 8.f});
+            npc.textID = n.value("id", "");
+            npc.interactSize = readVec2(n.value("interact_size", json::array()), {32.f, 32.f});
+            npc.wanderRadius = n.value("wander_radius", 0.f);
+            npc.speed = n.value("speed", 40.f);
+            npc.condition = n.value("condition", "");
+            out.npcs.push_back(std::move(npc));
+        }
+    } catch (const json::exception& e) {
+        std::cerr << "RoomLoader: failed to parse " << path << ": " << e.what() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// 缓存布局：魔数 | 版本 | 源文件时间戳 | 背景 | 出生点 | 摄像机范围 | 瓦片图层 | 墙 | 交互物 | 传送点 | 道具 | NPC
+bool RoomLoader::readCache(const std::string& path, long long sourceStamp, RoomData& out) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) return false;
+    const std::streamsize size = file.tellg();
+    if (size <= 0) return false;
+    std::vector<char> buffer(static_cast<std::size_t>(size));
+    file.seekg(0);
+    if (!file.read(buffer.data(), size)) return false;
+
+    BlobReader r(buffer.data(), buffer.size());
+    if (r.pod<std::uint32_t>() != kRoomCacheMagic) return false;
+    if (r.pod<std::uint32_t>() != kRoomCacheVersion) return false;
+    const long long stamp = r.pod<long long>();
+    if (sourceStamp != 0 && stamp != sourceStamp) return false; // 源文件已修改
+
+    RoomData room;
+    room.background.path = r.str();
+    room.background.scale = r.vec2();
+    room.background.position = r.vec2();
+    room.spawn = r.vec2();
+    if (r.pod<std::uint8_t>() != 0) {
+        room.cameraBounds = r.rect();
+    }
+
+    room.tileLayers.resize(r.count());
+    for (auto& tl : room.tileLayers) {
+        tl.tileset = r.str();
+        tl.tileSize.x = r.pod<std::uint32_t>();
+        tl.tileSize.y = r.pod<std::uint32_t>();
+        tl.columns = r.pod<std::int32_t>();
+        tl.rows = r.pod<std::int32_t>();
+        tl.scale = r.pod<float>();
+        tl.origin = r.vec2();
+        tl.tiles.resize(r.count());
+        for (auto& t : tl.tiles) t = r.pod<std::int32_t>();
+        tl.condition = r.str();
+    }
+
+    room.walls.resize(r.count());
+    for (auto& w : room.walls) {
+        w.rect = r.rotRect();
+        w.shape = r.shape();
+        w.condition = r.str();
+    }
+    room.interactables.resize(r.count());
+    for (auto& it : room.interactables) {
+        it.data.area = r.rect();
+        it.data.areaAngleDeg = r.pod<float>();
+        it.data.textID = r.str();
+        if (r.pod<std::uint8_t>() != 0) {
+            it.data.collider = r.rotRect();
+            it.colliderShape = r.shape();
+        }
+        it.condition = r.str();
+    }
+    room.warps.resize(r.count());
+    for (auto& wp : room.warps) {
+        wp.data.area = r.rect();
+        wp.data.targetMap = r.str();
+        wp.data.targetPos = r.vec2();
+        wp.condition = r.str();
+    }
+    room.props.resize(r.count());
+    for (auto& p : room.props) {
+        p.frames.resize(r.count());
+        for (auto& f : p.frames) f = r.str();
+        p.position = r.vec2();
+        p.scale = r.vec2();
+        p.frameTime = r.pod<float>();
+        p.condition = r.str();
+    }
+    room.npcs.resize(r.count());
+    for (auto& n : room.npcs) {
+        n.spriteSet = r.str();
+        n.position = r.vec2();
+        n.scale = r.vec2();
+        n.colliderSize = r.vec2();
+        n.textID = r.str();
+        n.interactSize = r.vec2();
+        n.wanderRadius = r.pod<float>();
+        n.speed = r.pod<float>();
+        n.condition = r.str();
+    }
+
+    if (!r.ok()) {
+        std::cerr << "RoomLoader: corrupt cache " << path << ", rebuilding" << std::endl;
+        return false;
+    }
+    out = std::move(room);
+    return true;
+}
+
+void RoomLoader::writeCache(const std::string& path, long long sourceStamp, const RoomData& room) {
+    std::error_code ec;
+    fs::create_directories(fs::path(path).parent_path(), ec);
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) return;
+
+    BlobWriter w(file);
+    w.pod(kRoomCacheMagic);
+    w.pod(kRoomCacheVersion);
+    w.pod(sourceStamp);
+
+    w.str(room.background.path);
+    w.vec2(room.background.scale);
+    w.vec2(room.background.position);
+    w.vec2(room.spawn);
+    w.pod(static_cast<std::uint8_t>(room.cameraBounds.has_value() ? 1 : 0));
+    if (room.cameraBounds.has_value()) {
+        w.rect(*room.cameraBounds);
+    }
+
+    w.pod(static_cast<std::uint32_t>(room.tileLayers.size()));
+    for (const auto& tl : room.tileLayers) {
+        w.str(tl.tileset);
+        w.pod(static_cast<std::uint32_t>(tl.tileSize.x));
+        w.pod(static_cast<std::uint32_t>(tl.tileSize.y));
+        w.pod(static_cast<std::int32_t>(tl.columns));
+        w.pod(static_cast<std::int32_t>(tl.rows));
+        w.pod(tl.scale);
+        w.vec2(tl.origin);
+        w.pod(static_cast<std::uint32_t>(tl.tiles.size()));
+        for (int t : tl.tiles) w.pod(static_cast<std::int32_t>(t));
+        w.str(tl.condition);
+    }
+
+    w.pod(static_cast<std::uint32_t>(room.walls.size()));
+    for (const auto& wall : room.walls) {
+        w.rotRect(wall.rect);
+        w.shape(wall.shape);
+        w.str(wall.condition);
+    }
+    w.pod(static_cast<std::uint32_t>(room.interactables.size()));
+    for (const auto& it : room.interactables) {
+        w.rect(it.data.area);
+        w.pod(it.data.areaAngleDeg);
+        w.str(it.data.textID);
+        w.pod(static_cast<std::uint8_t>(it.data.collider.has_value() ? 1 : 0));
+        if (it.data.collider.has_value()) {
+            w.rotRect(*it.data.collider);
+            w.shape(it.colliderShape);
+        }
+        w.str(it.condition);
+    }
+    w.pod(static_cast<std::uint32_t>(room.warps.size()));
+    for (const auto& wp : room.warps) {
+        w.rect(wp.data.area);
+        w.str(wp.data.targetMap);
+        w.vec2(wp.data.targetPos);
+        w.str(wp.condition);
+    }
+    w.pod(static_cast<std::uint32_t>(room.props.size()));
+    for (const auto& p : room.props) {
+        w.pod(static_cast<std::uint32_t>(p.frames.size()));
+        for (const auto& f : p.frames) w.str(f);
+        w.vec2(p.position);
+        w.vec2(p.scale);
+        w.pod(p.frameTime);
+        w.str(p.condition);
+    }
+    w.pod(static_cast<std::uint32_t>(room.npcs.size()));
+    for (const auto& n : room.npcs) {
+        w.str(n.spriteSet);
+        w.vec2(n.position);
+        w.vec2(n.scale);
+        w.vec2(n.colliderSize);
+        w.str(n.textID);
+        w.vec2(n.interactSize);
+        w.pod(n.wanderRadius);
+        w.pod(n.speed);
+        w.str(n.condition);
+    }
+}
+
+// ########################################## 实例化 ##########################################
+void RoomLoader::apply(const RoomData& room, GameMap& map, const TextureLookup& lookup) {
+    map.clear();
+
+    if (!room.background.path.empty()) {
+        if (lookup) {
+            map.setBackground(lookup(room.background.path), room.background.scale, room.background.position);
+        } else {
+            map.setBackground(room.background.path, room.background.scale, room.background.position);
+        }
+    }
+    if (room.cameraBounds.has_value()) {
+        map.setCameraBounds(*room.cameraBounds);
+    }
+    for (const auto& tl : room.tileLayers) {
+        if (!evalCondition(tl.condition)) continue;
+        std::shared_ptr<const sf::Texture> tileset;
+        if (lookup) {
+            tileset = lookup(tl.tileset);
+        } else {
+            auto texture = std::make_shared<sf::Texture>();
+            if (!texture->loadFromFile(tl.tileset)) {
+                std::cerr << "RoomLoader: failed to load tileset " << tl.tileset << std::endl;
+            }
+            tileset = std::move(texture);
+        }
+        TileLayer layer;
+        layer.build(std::move(tileset), tl.tileSize, tl.columns, tl.rows, tl.tiles, tl.scale, tl.origin);
+        map.addTileLayer(std::move(layer));
+    }
+    for (const auto& wall : room.walls) {
+        if (evalCondition(wall.condition)) map.addWall(wall.rect, wall.shape);
+    }
+    for (const auto& it : room.interactables) {
+        if (evalCondition(it.condition)) map.addInteractable(it.data, it.colliderShape);
+    }
+    for (const auto& wp : room.warps) {
+        if (evalCondition(wp.condition)) map.addWarp(wp.data);
+    }
+    for (const auto& p : room.props) {
+        if (!evalCondition(p.condition)) continue;
+        if (lookup) {
+            std::vector<std::shared_ptr<const sf::Texture>> frames;
+            frames.reserve(p.frames.size());
+            for (const auto& f : p.frames) frames.push_back(lookup(f));
+            map.addAnimatedProp(std::move(frames), p.position, p.scale, p.frameTime);
+        } else {
+            map.addAnimatedProp(p.frames, p.position, p.scale, p.frameTime);
+        }
+    }
+    for (const auto& n : room.npcs) {
+        if (!evalCondition(n.condition)) continue;
+        NpcSpawn spawn;
+        // 行走图集按角色常驻共享，同外观的 NPC 与队员共用一张贴图
+        spawn.walk = AnimationLibrary::walk(n.spriteSet);
+        spawn.position = n.position;
+        spawn.scale = n.scale;
+        spawn.colliderSize = n.colliderSize;
+        spawn.textID = n.textID;
+        spawn.interactSize = n.interactSize;
+        spawn.wanderRadius = n.wanderRadius;
+        spawn.speed = n.speed;
+        map.addNpc(spawn);
+    }
+    map.bakeNavigation();
+}
+
+std::vector<std::string> RoomLoader::texturePaths(const RoomData& room) {
+    std::vector<std::string> paths;
+    auto addUnique = [&](const std::string& path) {
+        if (path.empty()) return;
+        if (std::find(paths.begin(), paths.end(), path) == paths.end()) paths.push_back(path);
+    };
+    addUnique(room.background.path);
+    for (const auto& tl : room.tileLayers) addUnique(tl.tileset);
+    for (const auto& p : room.props) {
+        for (const auto& f : p.frames) addUnique(f);
+    }
+    return paths;
+}
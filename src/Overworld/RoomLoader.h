@@ -0,0 +1,112 @@
+﻿/*
+房间数据加载器。
+包含：
+
+房间文件格式（assets/room/<房间名>.json，背景可为整图或瓦片图层）
+
+烘焙缓存（cache/rooms/<房间名>.bin，按源文件修改时间失效）
+
+把房间数据实例化到 GameMap
+*/
+
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+#include "Overworld/Map.h"
+
+// 烘焙后的房间数据：只含纯数据，碰撞几何已预计算
+// condition 为空表示始终生成；"flag" 表示该全局标记为真时生成，"!flag" 表示为假时生成
+struct RoomData {
+    struct Background {
+        std::string path;                 // 为空表示无背景
+        sf::Vector2f scale{1.f, 1.f};
+        sf::Vector2f position{0.f, 0.f};
+    };
+    // 瓦片图层：tiles 行优先，-1 为空
+    struct TileLayerDef {
+        std::string tileset;
+        sf::Vector2u tileSize{16, 16};
+        int columns = 0;
+        int rows = 0;
+        float scale = 1.f;
+        sf::Vector2f origin{0.f, 0.f};
+        std::vector<int> tiles;
+        std::string condition;
+    };
+    struct Wall {
+        RotRect rect;
+        CollisionShape shape;
+        std::string condition;
+    };
+    struct InteractableDef {
+        Interactable data;
+        CollisionShape colliderShape;     // 仅当 data.collider 有值时有效
+        std::string condition;
+    };
+    struct Warp {
+        WarpTrigger data;
+        std::string condition;
+    };
+    struct Prop {
+        std::vector<std::string> frames;
+        sf::Vector2f position{0.f, 0.f};
+        sf::Vector2f scale{1.f, 1.f};
+        float frameTime = 0.12f;
+        std::string condition;
+    };
+    // 行走 NPC：外观取 CharacterRegistry 中的行走贴图集
+    struct Npc {
+        std::string spriteSet;
+        sf::Vector2f position{0.f, 0.f};  // 脚底中心
+        sf::Vector2f scale{1.f, 1.f};
+        sf::Vector2f colliderSize{16.f, 8.f};
+        std::string textID;
+        sf::Vector2f interactSize{32.f, 32.f};
+        float wanderRadius = 0.f;
+        float speed = 40.f;
+        std::string condition;
+    };
+
+    std::string name;
+    Background background;
+    std::vector<TileLayerDef> tileLayers;
+    sf::Vector2f spawn{0.f, 0.f};         // 默认出生点（读档/首次进入）
+    std::optional<sf::FloatRect> cameraBounds; // 摄像机活动范围；为空时由 GameMap 推断
+    std::vector<Wall> walls;
+    std::vector<InteractableDef> interactables;
+    std::vector<Warp> warps;
+    std::vector<Prop> props;
+    std::vector<Npc> npcs;
+};
+
+class RoomLoader {
+public:
+    // 贴图查找：按路径返回已加载的共享贴图（RoomCache 提供）；为空时按路径直接读取文件
+    using TextureLookup = std::function<std::shared_ptr<const sf::Texture>(const std::string&)>;
+
+    // 读取房间：缓存有效时直接读二进制；否则解析 JSON、预计算几何并写回缓存
+    static bool load(const std::string& roomName, RoomData& out);
+
+    // 按当前全局状态（条件标记）把房间实例化到地图（会先 clear）
+    static void apply(const RoomData& room, GameMap& map, const TextureLookup& lookup = {});
+
+    // 房间引用到的全部贴图路径（背景 + 图块集 + 道具帧，已去重；NPC 行走图集由 AnimationLibrary 管理）
+    static std::vector<std::string> texturePaths(const RoomData& room);
+
+    // 房间源文件是否存在
+    static bool exists(const std::string& roomName);
+
+    // 条件求值："has_holy_mantle" 等全局标记，前缀 '!' 取反
+    static bool evalCondition(const std::string& condition);
+
+private:
+    static std::string getSourcePath(const std::string& roomName);
+    static std::string getCachePath(const std::string& roomName);
+    static bool parseSource(const std::string& path, RoomData& out);
+    static bool readCache(const std::string& path, long long sourceStamp, RoomData& out);
+    static void writeCache(const std::string& path, long long sourceStamp, const RoomData& room);
+};
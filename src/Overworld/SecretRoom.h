@@ -1,5 +0,0 @@
-﻿#pragma once
-#include "Overworld/Map.h"
-
-// 第二个房间：SecretRoom
-void buildSecretRoom(GameMap& map);
@@ -0,0 +1,78 @@
+﻿#include "Overworld/TileLayer.h"
+#include <algorithm>
+
+//
+// 瓦片图层（TileLayer）
+// ---------------------
+// 职责：
+// - 将 图块集 + 索引网格 在加载时一次性转换为每区块一个的顶点数组（静态几何）
+// - 绘制时只提交与视野相交的区块：每个区块一次 draw 调用，开销与房间大小无关
+// 关键约定：
+// - 每个瓦片两个三角形（6 个顶点），纹理坐标取图块集中对应格子
+// - 图块索引按图块集行优先编号，从 0 开始；-1 或超出图块集范围的索引视为空
+//
+
+void TileLayer::build(std::shared_ptr<const sf::Texture> tileset,
+                      const sf::Vector2u& tileSize,
+                      int columns, int rows,
+                      const std::vector<int>& tiles,
+                      float scale,
+                      const sf::Vector2f& origin)
+{
+    m_tileset = std::move(tileset);
+    m_chunks.clear();
+    const sf::Vector2f cell{ static_cast<float>(tileSize.x) * scale, static_cast<float>(tileSize.y) * scale };
+    m_bounds = sf::FloatRect(origin, { cell.x * static_cast<float>(columns), cell.y * static_cast<float>(rows) });
+    if (!m_tileset || tileSize.x == 0 || tileSize.y == 0 || columns <= 0 || rows <= 0) return;
+
+    const int atlasCols = static_cast<int>(m_tileset->getSize().x / tileSize.x);
+    const int atlasRows = static_cast<int>(m_tileset->getSize().y / tileSize.y);
+    const int atlasCount = atlasCols * atlasRows;
+    const sf::Vector2f tex{ static_cast<float>(tileSize.x), static_cast<float>(tileSize.y) };
+
+    for (int cy = 0; cy < rows; cy += kChunkTiles) {
+        for (int cx = 0; cx < columns; cx += kChunkTiles) {
+            Chunk chunk;
+            const int endX = std::min(cx + kChunkTiles, columns);
+            const int endY = std::min(cy + kChunkTiles, rows);
+            for (int ty = cy; ty < endY; ++ty) {
+                for (int tx = cx; tx < endX; ++tx) {
+                    const std::size_t idx = static_cast<std::size_t>(ty) * static_cast<std::size_t>(columns) + static_cast<std::size_t>(tx);
+                    if (idx >= tiles.size()) continue;
+                    const int tile = tiles[idx];
+                    if (tile < 0 || tile >= atlasCount) continue;
+
+                    const sf::Vector2f p{ origin.x + cell.x * static_cast<float>(tx), origin.y + cell.y * static_cast<float>(ty) };
+                    const sf::Vector2f t{ tex.x * static_cast<float>(tile % atlasCols), tex.y * static_cast<float>(tile / atlasCols) };
+                    const sf::Vertex quad[4] = {
+                        { p, sf::Color::White, t },
+                        { { p.x + cell.x, p.y }, sf::Color::White, { t.x + tex.x, t.y } },
+                        { { p.x + cell.x, p.y + cell.y }, sf::Color::White, { t.x + tex.x, t.y + tex.y } },
+                        { { p.x, p.y + cell.y }, sf::Color::White, { t.x, t.y + tex.y } },
+                    };
+                    chunk.vertices.append(quad[0]);
+                    chunk.vertices.append(quad[1]);
+                    chunk.vertices.append(quad[2]);
+                    chunk.vertices.append(quad[0]);
+                    chunk.vertices.append(quad[2]);
+                    chunk.vertices.append(quad[3]);
+                }
+            }
+            if (chunk.vertices.getVertexCount() == 0) continue;
+            chunk.bounds = chunk.vertices.getBounds();
+            m_chunks.push_back(std::move(chunk));
+        }
+    }
+}
+
+void TileLayer::draw(sf::RenderTarget& target, const sf::FloatRect& viewRect) const
+{
+    if (!m_tileset || !m_bounds.findIntersection(viewRect)) return;
+    sf::RenderStates states;
+    states.texture = m_tileset.get();
+    for (const auto& chunk : m_chunks) {
+        if (chunk.bounds.findIntersection(viewRect)) {
+            target.draw(chunk.vertices, states);
+        }
+    }
+}
@@ -0,0 +1,45 @@
+﻿/*
+瓦片图层。
+包含：
+
+图块集（tileset 贴图）+ 索引网格
+
+按区块预构建的顶点数组
+
+按视野裁剪的绘制
+*/
+
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <memory>
+#include <vector>
+
+class TileLayer {
+public:
+    static constexpr int kChunkTiles = 16; // 每个区块的边长（以瓦片计）
+
+    // 构建图层：tiles 按行优先存放 columns × rows 个图块索引，-1 表示空
+    // tileSize 为图块集中单块像素大小；scale/origin 决定世界坐标中的摆放
+    void build(std::shared_ptr<const sf::Texture> tileset,
+               const sf::Vector2u& tileSize,
+               int columns, int rows,
+               const std::vector<int>& tiles,
+               float scale = 1.f,
+               const sf::Vector2f& origin = {0.f, 0.f});
+
+    // 仅绘制与 viewRect 相交的区块
+    void draw(sf::RenderTarget& target, const sf::FloatRect& viewRect) const;
+
+    // 图层在世界坐标中的范围
+    const sf::FloatRect& getBounds() const { return m_bounds; }
+
+private:
+    struct Chunk {
+        sf::VertexArray vertices{ sf::PrimitiveType::Triangles };
+        sf::FloatRect bounds;
+    };
+
+    std::shared_ptr<const sf::Texture> m_tileset;
+    std::vector<Chunk> m_chunks; // 仅保存非空区块
+    sf::FloatRect m_bounds;
+};
@@ -19,5 +19,12 @@ public:
     //virtual void handleEvent(const sf::Event& event) = 0; // 处理输入事件
     virtual void handleEvent() = 0;       // 处理输入
     virtual void update(float dt) = 0;    // 更新逻辑 (dt = delta time)
-    virtual void draw(sf::RenderWindow& window) = 0; // 绘制画面
+    virtual void draw(sf::RenderTarget& target) = 0; // 绘制画面
+
+    // 生命周期钩子（由 Game 在帧边界调用，默认不做事）
+    // 构造只负责加载资源；音乐、入场音效等副作用放在 onEnter
+    virtual void onEnter() {}   // 成为栈顶（首次进入）
+    virtual void onExit() {}    // 出栈，随后被销毁
+    virtual void onSuspend() {} // 有新状态压在其上：停止更新与绘制，资源保留
+    virtual void onResume() {}  // 上层状态出栈，重新成为栈顶
 };
\ No newline at end of file
@@ -7,23 +7,28 @@
 // - 负责底部 UI 菜单、Act 描述的打字机效果、对话框的交互
 // - 绘制并驱动“战斗箱”（弹幕盒）的入场/退出动画与心形（Soul）移动边界
 // - 维护弹幕生成、更新、碰撞以及“圣斗篷”（Holy Mantle）护盾的触发与表现
-// - 处理战斗背景与从 Overworld 捕获的背景的渐隐/渐显效果
-// - 加载与更新队伍角色的入场与待机动画（Kris/Susie/Ralsei）
+// - 擦弹：每步以战斗箱范围重建网格，只检查心形附近的弹幕，首次擦过的弹幕为全队增加 TP
+// - 处理战斗背景与从 Overworld 捕获的背景的渐隐/渐显效果（Compositor 合成时交叉淡化）
+// - 加载与更新队伍角色的入场与待机动画（帧序列由 CharacterRegistry 按英雄 ID 提供）
 // - 播放相关音效与循环 BGM
 //
 // 设计要点：
 // - 所有入场/退出/渐隐等视觉效果按固定计时器驱动，保证帧率无关性
-// - 弹幕与心形碰撞采用矩形相交的简化检测，配合无敌时间（i-frame）避免多次伤害
+// - 弹幕存于结构数组池，碰撞内核只产出命中事件，伤害/音效/护盾在其后单独结算，配合无敌时间（i-frame）避免多次伤害
 // - 圣斗篷为“每回合一次”的共享护盾：当队伍中有佩戴且存活的角色时，本回合第一次命中由护盾吸收
 // - Act 文本采用底部 UI 的打字机呈现，播放完毕后再执行队列中的行动
 // - 战斗箱的显示位置与心形初始位置可微调，以适配具体素材与视觉布局
 //===============================================
 #include "States/BattleState.h"
-#include "States/OverworldState.h"
 #include "States/TitleState.h"
 #include "Battle/Enemy.h"
+#include "Battle/EnemyDefinition.h"
 #include "Manager/InputManager.h"
 #include "Manager/AudioManager.h"
+#include "Game/CharacterRegistry.h"
+#include "Game/Game.h"
+#include "Game/StateTransition.h"
+#include "Utils/JobSystem.h"
 #include <memory>
 #include <optional>
 #include <algorithm>
@@ -31,6 +36,75 @@
 #include <cstdio>
 #include <cstdint>
 
+namespace {
+// 战斗中队员站位：沿左侧纵向均匀分布，x 左右交错避免相邻队员重叠
+// 人数越多间距越小，整体保持在 [100, 265] 的纵向范围内（三人时纵向站位不变）
+sf::Vector2f partySlotPosition(int index, int count) {
+	const float centerY = 182.5f;
+	const float maxStep = 82.5f;
+	const float span = 165.f;
+	const float step = (count > 1) ? std::min(maxStep, span / static_cast<float>(count - 1)) : 0.f;
+	const float y = centerY + (static_cast<float>(index) - static_cast<float>(count - 1) * 0.5f) * step;
+	const float x = (index % 2 == 0) ? 92.f : 50.f;
+	return { x, y };
+}
+
+// 序列帧与单张贴图路径（构造与过渡预解码共用同一份清单）
+constexpr int kBoxFrameCount = 46;        // BBS_0001..0046
+constexpr int kBattleBgFrameCount = 100;  // b0001..b0100
+constexpr int kShieldFrameCount = 21;     // break_0..20
+const char* const kBulletPath1 = BattleRules::bulletSpritePath(BattleRules::kBulletClubs);
+const char* const kBulletPath2 = BattleRules::bulletSpritePath(BattleRules::kBulletDiamond);
+const char* const kHolyGlowPath = "assets/sprite/Heart/holymantle_glow.png";
+const char* const kTpLogoPath = "assets/sprite/UI/spr_tplogo_ch1.png";
+const sf::Vector2f kTpBarPosition{ 16.f, 110.f }; // TP 竖条左上角（标志在其上方，百分比在其下方）
+const sf::Vector2f kTpBarSize{ 20.f, 150.f };
+constexpr float kTpFlashTime = 0.15f;              // 擦弹后 TP 条提亮的时长
+
+std::string boxFramePath(int i) {
+	char path[128];
+	std::snprintf(path, sizeof(path), "assets/sprite/Battle Box Sequence/BBS_%04d.png", i);
+	return path;
+}
+
+std::string battleBgFramePath(int i) {
+	char path[64];
+	std::snprintf(path, sizeof(path), "assets/sprite/Frames/b%04d.png", i);
+	return path;
+}
+
+std::string shieldFramePath(int i) {
+	char path[96];
+	std::snprintf(path, sizeof(path), "assets/sprite/Holyshield/spr_holyshield_break_%d.png", i);
+	return path;
+}
+}
+
+// 过渡预解码清单：战斗箱/背景/护盾序列帧、弹幕与 TP 标志贴图、队员入场/待机帧与敌人各阶段贴图
+std::vector<std::string> BattleState::preloadPaths(const std::vector<HeroRuntime>& party, const std::vector<Enemy>& enemies)
+{
+	std::vector<std::string> paths;
+	paths.reserve(kBoxFrameCount + kBattleBgFrameCount + kShieldFrameCount + 4 + party.size() * 16);
+	for (int i = 1; i <= kBoxFrameCount; ++i) paths.push_back(boxFramePath(i));
+	for (int i = 1; i <= kBattleBgFrameCount; ++i) paths.push_back(battleBgFramePath(i));
+	for (int i = 0; i < kShieldFrameCount; ++i) paths.push_back(shieldFramePath(i));
+	paths.push_back(kBulletPath1);
+	paths.push_back(kBulletPath2);
+	paths.push_back(kHolyGlowPath);
+	paths.push_back(kTpLogoPath);
+	for (const auto& hero : party) {
+		const CharacterSprites& sprites = CharacterRegistry::get(hero.id);
+		paths.insert(paths.end(), sprites.battleIntro.paths.begin(), sprites.battleIntro.paths.end());
+		paths.insert(paths.end(), sprites.battleIdle.paths.begin(), sprites.battleIdle.paths.end());
+	}
+	for (const auto& enemy : enemies) {
+		if (!enemy.definition()) continue;
+		auto stagePaths = EnemyRegistry::spritePaths(enemy.definition()->id);
+		paths.insert(paths.end(), stagePaths.begin(), stagePaths.end());
+	}
+	return paths;
+}
+
 // 构造函数：
 // - 初始化战斗对象、背景素材、战斗箱帧、角色入场动画
 // - 预加载音效与 BGM，设置弹幕/护盾相关资源
@@ -38,12 +112,14 @@
 BattleState::BattleState(Game& game,
 	std::vector<Enemy> enemies,
 	std::vector<sf::Vector2f> partyStarts,
-	std::optional<sf::Texture> overworldBgTex,
-	sf::Vector2f overworldBgScale)
-	: BaseState(game), m_battle(std::move(enemies)), m_partyStarts(std::move(partyStarts)), m_overworldBg(std::move(overworldBgTex)), m_overworldBgScale(overworldBgScale), m_rng(std::random_device{}())
+	std::shared_ptr<const sf::Texture> overworldFrame)
+	: BaseState(game), m_battle(std::move(enemies)), m_partyStarts(std::move(partyStarts)), m_rng(std::random_device{}())
 {
 	// 字体加载（用于敌人信息与底部文字）
 	[[maybe_unused]] bool fontOk = m_font.openFromFile("assets/font/Common.ttf");
+	[[maybe_unused]] bool tpFontOk = m_tpFont.openFromFile("assets/font/TpBar.ttf");
+	m_tpLogoLoaded = StateTransition::loadTexture(m_tpLogoTex, kTpLogoPath);
+	if (m_tpLogoLoaded) m_tpLogoTex.setSmooth(false);
 
 	// 弹幕碰撞盒（逻辑边界）基础设置
 	m_bulletBox.setSize({360.f, 150.f});
@@ -54,12 +130,24 @@ BattleState::BattleState(Game& game,
 	m_soul.setBounds(m_bulletBox.getGlobalBounds());
 	m_prevPhase = m_battle.getPhase();
 
+	// 敌人阶段贴图挂在共享定义上，同种敌人只加载一次；站位按人数一次求解
+	const auto& battleEnemies = m_battle.getEnemies();
+	for (const auto& enemy : battleEnemies) {
+		if (enemy.definition()) EnemyRegistry::loadTextures(enemy.definition()->id);
+	}
+	m_enemySlots = BattleRules::layoutEnemies(battleEnemies.size(), m_game.getWindow().getView().getSize());
+	m_enemyNames.reserve(battleEnemies.size());
+	for (std::size_t i = 0; i < battleEnemies.size(); ++i) {
+		sf::Text name(m_font, battleEnemies[i].getName(), 22);
+		name.setScale({m_enemySlots[i].scale, m_enemySlots[i].scale});
+		name.setPosition(m_enemySlots[i].position + battleEnemies[i].nameOffset() * m_enemySlots[i].scale);
+		m_enemyNames.push_back(std::move(name));
+	}
+
 	// 载入战斗箱入场/退出序列帧，用于显示“盒子”动画
-	for (int i = 1; i <= 46; ++i) {
-		char path[128];
-		std::snprintf(path, sizeof(path), "assets/sprite/Battle Box Sequence/BBS_%04d.png", i);
+	for (int i = 1; i <= kBoxFrameCount; ++i) {
 		sf::Texture tex;
-		if (tex.loadFromFile(path)) {
+		if (StateTransition::loadTexture(tex, boxFramePath(i))) {
 			tex.setSmooth(false);
 			m_boxFrames.push_back(std::move(tex));
 		}
@@ -70,170 +158,92 @@ BattleState::BattleState(Game& game,
 		m_boxSprite->setOrigin({static_cast<float>(sz.x) * 0.5f, static_cast<float>(sz.y) * 0.5f});
 		m_boxSprite->setScale({0.5f, 0.5f});
 		sf::Vector2f viewSize = m_game.getWindow().getView().getSize();
-		m_boxPosition = { viewSize.x * 0.5f - 25.f, viewSize.y * 0.50f + 15.f - 100.f };
+		m_boxPosition = BattleRules::battleBoxPosition(viewSize);
 		updateBattleBoxTransform();
 	}
 
-	// 捕获 overworld 背景用于渐隐
-	if (m_overworldBg) {
-		m_overworldBgSprite.emplace(*m_overworldBg);
-		m_overworldBgSprite->setScale(m_overworldBgScale);
-	}
+	// 分层合成：Overworld 最后一帧（640x480 捕获画面）作为背景，与 World 图层（战斗背景帧）交叉淡化；
+	// World 只在换帧时重画，UI 图层（战斗箱/弹幕/角色/菜单）每帧重画
+	m_compositor.setBackdrop(std::move(overworldFrame));
+	m_compositor.setDynamic(Layer::UI, true);
 
 	// 预加载战斗背景帧
-	char path[64];
-	m_battleBgFrames.reserve(100);
-	for (int i = 1; i <= 100; ++i) {
-		std::snprintf(path, sizeof(path), "assets/sprite/Frames/b%04d.png", i);
+	m_battleBgFrames.reserve(kBattleBgFrameCount);
+	for (int i = 1; i <= kBattleBgFrameCount; ++i) {
 		sf::Texture tex;
-		if (tex.loadFromFile(path)) {
+		if (StateTransition::loadTexture(tex, battleBgFramePath(i))) {
 			tex.setSmooth(false);
 			m_battleBgFrames.push_back(std::move(tex));
 		}
 	}
 	if (!m_battleBgFrames.empty()) {
-		auto& win = m_game.getWindow();
 		m_battleBgSprite.emplace(m_battleBgFrames[0]);
-		auto texSize = m_battleBgFrames[0].getSize();
-		auto winSize = win.getSize();
 	}
+	applyBackgroundFade();
 
-	// 音频：战斗入场音效 & 循环 BGM
+	// 音频：预加载战斗音效（入场音效与 BGM 在 onEnter 播放）
 	auto& audio = AudioManager::getInstance();
 	audio.loadSound("battle_intro", "assets/sound/snd_intro_battle.wav");
-	audio.playSound("battle_intro");
-	audio.playMusic("assets/music/rudebuster_boss.ogg", true);
 	audio.loadSound("hurt", "assets/sound/snd_hurt.wav");
 	audio.loadSound("holyshield", "assets/sound/snd_holyshield.ogg");
 
 	// 弹幕贴图
-	m_bulletTex1Loaded = m_bulletTexture1.loadFromFile("assets/sprite/Bullet/spr_clubsball_a.png");
-	m_bulletTex2Loaded = m_bulletTexture2.loadFromFile("assets/sprite/Bullet/spr_diamondbullet.png");
+	m_bulletTex1Loaded = StateTransition::loadTexture(m_bulletTexture1, kBulletPath1);
+	m_bulletTex2Loaded = StateTransition::loadTexture(m_bulletTexture2, kBulletPath2);
 	if (m_bulletTex1Loaded) m_bulletTexture1.setSmooth(false);
 	if (m_bulletTex2Loaded) m_bulletTexture2.setSmooth(false);
+	// 弹幕碰撞掩码：由同一组贴图的 alpha 生成（进程内缓存，再次进入战斗不重复读取）
+	m_bullets.loadSpriteMasks();
 	// 圣斗篷贴图与破碎动画帧
-	m_holyGlowLoaded = m_holyGlowTex.loadFromFile("assets/sprite/Heart/holymantle_glow.png");
+	m_holyGlowLoaded = StateTransition::loadTexture(m_holyGlowTex, kHolyGlowPath);
 	if (m_holyGlowLoaded) m_holyGlowTex.setSmooth(false);
 	m_holyShieldFrames.reserve(32);
-	for (int i = 0; i <= 20; ++i) {
-		char p[96];
-		std::snprintf(p, sizeof(p), "assets/sprite/Holyshield/spr_holyshield_break_%d.png", i);
+	for (int i = 0; i < kShieldFrameCount; ++i) {
 		sf::Texture tex;
-		if (tex.loadFromFile(p)) {
+		if (StateTransition::loadTexture(tex, shieldFramePath(i))) {
 			tex.setSmooth(false);
 			m_holyShieldFrames.push_back(std::move(tex));
 		}
 	}
 
 	// 初始化队伍圣斗篷状态
-	const auto& partyInit = m_battle.getParty();
-	m_hasHolyMantle.resize(partyInit.size(), false);
-	m_holyShieldReady.resize(partyInit.size(), false);
-	m_sharedShieldReady = false;
-	bool anyMantle = false;
-	for (std::size_t i = 0; i < partyInit.size(); ++i) {
-		bool hasMantle = false;
-		for (const auto& armor : partyInit[i].armorID) {
-			if (armor == "holy_mantle" || armor == "HolyMantle") { hasMantle = true; break; }
-		}
-		m_hasHolyMantle[i] = hasMantle;
-		m_holyShieldReady[i] = hasMantle;
-		anyMantle = anyMantle || hasMantle;
-	}
-	m_sharedShieldReady = anyMantle;
+	m_shield.init(m_battle.getParty());
 
 
-	// 准备队伍可视化（左侧垂直排列）
-	m_partyVisuals.resize(3);
-	const std::array<sf::Vector2f, 3> targets = { sf::Vector2f{95.f, 100.f}, sf::Vector2f{50.f, 185.f}, sf::Vector2f{90.f, 265.f} };
+	// 准备队伍可视化（左侧垂直排列，人数与 partyHeroes 一致）
+	const auto& party = m_battle.getParty();
+	const int partyCount = static_cast<int>(party.size());
+	m_partyVisuals.resize(party.size());
 	const float desiredIntroTime = 1.f; // 目标：入场约 1 秒完成
 	const float minIntroSpeed = 40.f;    // 较低的最小速度，避免瞬移
-	for (int i = 0; i < 3; ++i) {
+	for (int i = 0; i < partyCount; ++i) {
+		const sf::Vector2f target = partySlotPosition(i, partyCount);
 		sf::Vector2f start = (i < static_cast<int>(m_partyStarts.size())) ? m_partyStarts[i] : sf::Vector2f{-80.f, 120.f + 60.f * i};
-		sf::Vector2f toTarget{ targets[i].x - start.x, targets[i].y - start.y };
+		sf::Vector2f toTarget{ target.x - start.x, target.y - start.y };
 		float dist = std::sqrt(toTarget.x * toTarget.x + toTarget.y * toTarget.y);
 		float speed = (dist > 1e-3f) ? std::max(minIntroSpeed, dist / desiredIntroTime) : minIntroSpeed;
 		m_partyVisuals[i].setStartPosition(start);
-		m_partyVisuals[i].setTargetPosition(targets[i]);
+		m_partyVisuals[i].setTargetPosition(target);
 		m_partyVisuals[i].setMoveSpeed(speed);
 		m_partyVisuals[i].setScale({2.0f, 2.0f});
-	}
 
-	// 加载各自的 intro / idle 帧（缺失则使用 idle 代替）
-	auto krisIntro = BattleActorVisual::loadTextures({
-		"assets/sprite/Kris/spr_krisb_intro/spr_krisb_intro_0.png",
-		"assets/sprite/Kris/spr_krisb_intro/spr_krisb_intro_1.png",
-		"assets/sprite/Kris/spr_krisb_intro/spr_krisb_intro_2.png",
-		"assets/sprite/Kris/spr_krisb_intro/spr_krisb_intro_3.png",
-		"assets/sprite/Kris/spr_krisb_intro/spr_krisb_intro_4.png",
-		"assets/sprite/Kris/spr_krisb_intro/spr_krisb_intro_5.png",
-		"assets/sprite/Kris/spr_krisb_intro/spr_krisb_intro_6.png",
-		"assets/sprite/Kris/spr_krisb_intro/spr_krisb_intro_7.png",
-		"assets/sprite/Kris/spr_krisb_intro/spr_krisb_intro_8.png",
-		"assets/sprite/Kris/spr_krisb_intro/spr_krisb_intro_9.png",
-		"assets/sprite/Kris/spr_krisb_intro/spr_krisb_intro_10.png",
-		"assets/sprite/Kris/spr_krisb_intro/spr_krisb_intro_11.png"
-	});
-	auto krisIdle = BattleActorVisual::loadTextures({
-		"assets/sprite/Kris/spr_krisb_idle/spr_krisb_idle_0.png",
-		"assets/sprite/Kris/spr_krisb_idle/spr_krisb_idle_1.png",
-		"assets/sprite/Kris/spr_krisb_idle/spr_krisb_idle_2.png",
-		"assets/sprite/Kris/spr_krisb_idle/spr_krisb_idle_3.png",
-		"assets/sprite/Kris/spr_krisb_idle/spr_krisb_idle_4.png",
-		"assets/sprite/Kris/spr_krisb_idle/spr_krisb_idle_5.png"
-	});
-	m_partyVisuals[0].setIntroFrames(std::move(krisIntro), 0.128f);
-	m_partyVisuals[0].setIdleFrames(std::move(krisIdle), 0.12f);
-
-	auto susieIdle = BattleActorVisual::loadTextures({
-		"assets/sprite/Susie/spr_susie_idle/spr_susie_idle_0.png",
-		"assets/sprite/Susie/spr_susie_idle/spr_susie_idle_1.png",
-		"assets/sprite/Susie/spr_susie_idle/spr_susie_idle_2.png",
-		"assets/sprite/Susie/spr_susie_idle/spr_susie_idle_3.png"
-	});
-	
-	auto susieIntro = BattleActorVisual::loadTextures({
-		"assets/sprite/Susie/spr_susie_attack/spr_susie_attack_0.png",
-		"assets/sprite/Susie/spr_susie_attack/spr_susie_attack_1.png",
-		"assets/sprite/Susie/spr_susie_attack/spr_susie_attack_2.png",
-		"assets/sprite/Susie/spr_susie_attack/spr_susie_attack_3.png"
-	});
-	m_partyVisuals[1].setIntroFrames(std::move(susieIntro), 0.128f);
-	m_partyVisuals[1].setIdleFrames(susieIdle, 0.08f);
-	auto susieIdle2 = BattleActorVisual::loadTextures({
-		"assets/sprite/Susie/spr_susie_idle/spr_susie_idle_0.png",
-		"assets/sprite/Susie/spr_susie_idle/spr_susie_idle_1.png",
-		"assets/sprite/Susie/spr_susie_idle/spr_susie_idle_2.png",
-		"assets/sprite/Susie/spr_susie_idle/spr_susie_idle_3.png"
-	});
-	m_partyVisuals[1].setIdleFrames(std::move(susieIdle2), 0.14f);
-
-	auto ralseiIntro = BattleActorVisual::loadTextures({
-		"assets/sprite/Ralsei/spr_ralsei_battleintro/spr_ralsei_battleintro_0.png",
-		"assets/sprite/Ralsei/spr_ralsei_battleintro/spr_ralsei_battleintro_1.png",
-		"assets/sprite/Ralsei/spr_ralsei_battleintro/spr_ralsei_battleintro_2.png",
-		"assets/sprite/Ralsei/spr_ralsei_battleintro/spr_ralsei_battleintro_3.png",
-		"assets/sprite/Ralsei/spr_ralsei_battleintro/spr_ralsei_battleintro_4.png",
-		"assets/sprite/Ralsei/spr_ralsei_battleintro/spr_ralsei_battleintro_5.png",
-		"assets/sprite/Ralsei/spr_ralsei_battleintro/spr_ralsei_battleintro_6.png",
-		"assets/sprite/Ralsei/spr_ralsei_battleintro/spr_ralsei_battleintro_7.png",
-		"assets/sprite/Ralsei/spr_ralsei_battleintro/spr_ralsei_battleintro_8.png",
-		"assets/sprite/Ralsei/spr_ralsei_battleintro/spr_ralsei_battleintro_9.png",
-		"assets/sprite/Ralsei/spr_ralsei_battleintro/spr_ralsei_battleintro_10.png"
-	});
-	auto ralseiIdle = BattleActorVisual::loadTextures({
-		"assets/sprite/Ralsei/spr_ralsei_idle/spr_ralsei_idle_0.png",
-		"assets/sprite/Ralsei/spr_ralsei_idle/spr_ralsei_idle_1.png",
-		"assets/sprite/Ralsei/spr_ralsei_idle/spr_ralsei_idle_2.png",
-		"assets/sprite/Ralsei/spr_ralsei_idle/spr_ralsei_idle_3.png",
-		"assets/sprite/Ralsei/spr_ralsei_idle/spr_ralsei_idle_4.png"
-	});
-	m_partyVisuals[2].setIntroFrames(std::move(ralseiIntro), 0.128f);
-	m_partyVisuals[2].setIdleFrames(std::move(ralseiIdle), 0.12f);
+		// 入场 / 待机帧来自角色登记表（缺失 intro 时使用 idle 代替）
+		const CharacterSprites& sprites = CharacterRegistry::get(party[i].id);
+		m_partyVisuals[i].setIntroFrames(BattleActorVisual::loadTextures(sprites.battleIntro.paths), sprites.battleIntro.frameTime);
+		m_partyVisuals[i].setIdleFrames(BattleActorVisual::loadTextures(sprites.battleIdle.paths), sprites.battleIdle.frameTime);
+	}
 
 	for (auto& v : m_partyVisuals) v.startIntro();
 }
 
+// 成为栈顶：播放入场音效与循环 BGM（构造只加载资源，不产生声音）
+void BattleState::onEnter()
+{
+	auto& audio = AudioManager::getInstance();
+	audio.playSound("battle_intro");
+	audio.playMusic("assets/music/rudebuster_boss.ogg", true);
+}
+
 // 输入事件处理：
 // - 优先处理胜利/失败后的退出提示与对话确认
 // - 选择阶段处理菜单输入（撤销/排队指令/进入行动阶段）
@@ -311,12 +321,14 @@ void BattleState::update(float dt)
 			m_battleBgTimer -= m_battleBgFrameTime;
 			m_battleBgIndex = (m_battleBgIndex + 1) % static_cast<int>(m_battleBgFrames.size());
 			if (m_battleBgSprite) m_battleBgSprite->setTexture(m_battleBgFrames[m_battleBgIndex], true);
+			m_compositor.invalidate(Layer::World);
 		}
 	}
 	// 背景渐变：按 dt 累加淡入值（0 → 1）
 	if (m_bgFadeAlpha < 1.f) {
 		m_bgFadeTimer += dt;
 		m_bgFadeAlpha = std::min(1.f, m_bgFadeTimer / std::max(0.0001f, m_bgFadeDuration));
+		applyBackgroundFade();
 	}
 
 	// 对话打字机更新（胜利/退出等）
@@ -338,7 +350,9 @@ void BattleState::update(float dt)
 	}
 	// 战斗角色可视（入场 + 待机）始终更新，保证待机循环
 	for (auto& v : m_partyVisuals) v.update(dt);
+	updateFloatingNumbers(dt);
 	updateBattleBox(dt);
+	m_tpFlash = std::max(0.f, m_tpFlash - dt);
 
 	// Act 描述播报推进（底部 UI 区域）
 	if (m_playingActTexts) {
@@ -362,10 +376,7 @@ void BattleState::update(float dt)
 					m_pendingActTexts.clear();
 					m_actTextIndex = 0;
 					if (!m_isExitText) {
-						m_battle.executeQueuedCommands();
-						if (m_battle.getPhase() != BattlePhase::Victory && m_battle.getPhase() != BattlePhase::GameOver) {
-							startBattleBoxEnter();
-						}
+						resolveTurn();
 					} else {
 						m_isExitText = false; // 标记已处理退出文本
 					}
@@ -379,36 +390,31 @@ void BattleState::update(float dt)
 	m_prevPhase = m_battle.getPhase();
 }
 
-// 渲染：
-// - 先绘制战斗背景（不进行渐隐/渐显）
+// 渲染（经分层合成）：
+// - World：战斗背景帧；与 Overworld 捕获画面的交叉淡化在合成时完成
+// - UI：其余全部内容（见 drawScene）
+void BattleState::draw(sf::RenderTarget& target)
+{
+	target.clear(sf::Color(12, 12, 24));
+	m_compositor.render(Layer::World, [this](sf::RenderTarget& layer) {
+		if (m_battleBgSprite) layer.draw(*m_battleBgSprite);
+	});
+	m_compositor.render(Layer::UI, [this](sf::RenderTarget& layer) {
+		drawScene(layer);
+	});
+	m_compositor.composite(target);
+}
+
+// 场景内容：
 // - 显示战斗箱（或回退矩形），并在需要时绘制碰撞调试框
 // - 弹幕阶段绘制弹幕；盒子完全显示时绘制心形与护盾效果
 // - 绘制队伍角色入场/待机、敌人信息、底部菜单与 Act 文本、对话框
-void BattleState::draw(sf::RenderWindow& window)
+void BattleState::drawScene(sf::RenderTarget& target)
 {
-	// 背景：交叉淡入（Overworld → Battle）
-	window.clear(sf::Color(12, 12, 24));
-	// 先绘制 Overworld 背景（随渐变淡出）
-	if (m_overworldBgSprite) {
-		sf::Sprite ow = *m_overworldBgSprite;
-		sf::Color c = ow.getColor();
-		c.a = static_cast<std::uint8_t>(255.f * std::clamp(1.f - m_bgFadeAlpha, 0.f, 1.f));
-		ow.setColor(c);
-		window.draw(ow);
-	}
-	// 再绘制战斗背景（随渐变淡入）
-	if (!m_battleBgFrames.empty() && m_battleBgSprite) {
-		sf::Sprite bg = *m_battleBgSprite;
-		sf::Color c = bg.getColor();
-		c.a = static_cast<std::uint8_t>(255.f * std::clamp(m_bgFadeAlpha, 0.f, 1.f));
-		bg.setColor(c);
-		window.draw(bg);
-	}
 	// 弹幕盒不再显示，仅保留逻辑边界（入场保留期内不绘制 UI）
 	if (m_battle.getPhase() != BattlePhase::Intro && !m_introHoldActive) {
 		if (m_boxSprite && m_boxState != BoxState::Hidden) {
-			sf::Sprite box = *m_boxSprite;
-			window.draw(box);
+			target.draw(*m_boxSprite);
 		} else if (m_boxState != BoxState::Hidden) {
 			// Fallback draw if frames failed to load
 			sf::Vector2f fbSize = m_bulletBox.getSize();
@@ -422,7 +428,7 @@ void BattleState::draw(sf::RenderWindow& window)
 			fallback.setFillColor(sf::Color(0, 0, 0, 160));
 			fallback.setOutlineColor(sf::Color::White);
 			fallback.setOutlineThickness(3.f);
-			window.draw(fallback);
+			target.draw(fallback);
 		}
 		if (m_boxState != BoxState::Hidden) {
 			// Debug box
@@ -433,25 +439,12 @@ void BattleState::draw(sf::RenderWindow& window)
 				boxDbg.setFillColor(sf::Color(0, 0, 0, 0));
 				boxDbg.setOutlineColor(sf::Color(0, 120, 255, 200));
 				boxDbg.setOutlineThickness(2.f);
-				window.draw(boxDbg);
+				target.draw(boxDbg);
 			}
 
 			// Draw bullets when弹幕阶段
 			if (m_battle.getPhase() == BattlePhase::BulletHell) {
-				for (const auto& b : m_activeBullets) {
-					b.bullet.draw(window);
-					if (m_debugDraw) {
-						// Debug draw bullet collision bounds
-						sf::FloatRect r = b.bullet.getBounds();
-						sf::RectangleShape rect;
-						rect.setPosition({ r.position.x, r.position.y });
-						rect.setSize(r.size);
-						rect.setFillColor(sf::Color(255, 0, 255, 30));
-						rect.setOutlineColor(sf::Color(255, 0, 255, 180));
-						rect.setOutlineThickness(2.f);
-						window.draw(rect);
-					}
-				}
+				drawBullets(target);
 			}
 
 			// Draw soul when 盒子完全显示
@@ -464,20 +457,19 @@ void BattleState::draw(sf::RenderWindow& window)
 					soulDbg.setFillColor(sf::Color(255, 0, 0, 30));
 					soulDbg.setOutlineColor(sf::Color(255, 80, 80, 200));
 					soulDbg.setOutlineThickness(2.f);
-					window.draw(soulDbg);
+					target.draw(soulDbg);
 				}
 
 				// 圣斗篷光晕 & 护盾动画
-				bool anyShieldReady = m_sharedShieldReady && std::any_of(m_holyShieldReady.begin(), m_holyShieldReady.end(), [](bool v) { return v; });
-				if (anyShieldReady && m_holyGlowLoaded) {
+				if (m_shield.anyReady() && m_holyGlowLoaded) {
 					sf::Sprite glow(m_holyGlowTex);
 					glow.setOrigin(glow.getLocalBounds().size * 0.5f);
 					glow.setPosition(m_soul.getPosition());
 					glow.setColor(sf::Color(255, 255, 255, 128));
-					window.draw(glow);
+					target.draw(glow);
 				}
 
-				m_soul.draw(window);
+				m_soul.draw(target);
 
 				// 护盾破碎动画
 				if (m_shieldAnimPlaying && m_shieldAnimFrame < static_cast<int>(m_holyShieldFrames.size())) {
@@ -485,7 +477,7 @@ void BattleState::draw(sf::RenderWindow& window)
 					sh.setOrigin(sh.getLocalBounds().size * 0.5f);
 					sh.setPosition(m_soul.getPosition());
 					sh.setColor(sf::Color(255, 255, 255, 200)); // 80% 不透明度
-					window.draw(sh);
+					target.draw(sh);
 				}
 			}
 		}
@@ -494,37 +486,30 @@ void BattleState::draw(sf::RenderWindow& window)
 	// 三人入场/待机绘制（移至最上层，见下方）
 
 	// 敌人展示（贴图置于右侧 UI 上方）
-	const auto& enemies = m_battle.getEnemies();
-	sf::Vector2f viewSize = window.getView().getSize();
-	float panelTop = viewSize.y * 0.6f + 30.f; // 与底部 UI 对齐的基线
-	float baseX = viewSize.x - 260.f;
-	float baseY = panelTop - 220.f;
-	float gapY = 140.f;
-	for (std::size_t i = 0; i < enemies.size(); ++i) {
-		sf::Vector2f pos{ baseX, baseY + gapY * static_cast<float>(i) };
-		enemies[i].draw(window, m_font, pos);
-	}
+	drawEnemies(target);
 
 	if (m_battle.getPhase() != BattlePhase::Intro && !m_introHoldActive) {
-		m_menu.draw(window);
+		m_menu.draw(target);
+		drawTPBar(target);
 	}
 
 	// 底部 UI 区域播放 Act 描述（占用“高数题毫无仁慈”位置）
 	if (m_playingActTexts && !m_actCurrentText.isEmpty()) {
 		sf::Text t(m_font, m_actCurrentText.substring(0, m_actCharIndex), 20);
 		t.setFillColor(sf::Color::White);
-		sf::Vector2f viewSize2 = window.getView().getSize();
+		sf::Vector2f viewSize2 = target.getView().getSize();
 		float panelTop = viewSize2.y * 0.6f + 30.f;
 		t.setPosition({60.f, panelTop + 70.f});
-		window.draw(t);
+		target.draw(t);
 	}
 
 	if (m_dialogue.isActive()) {
-		m_dialogue.draw(window);
+		m_dialogue.draw(target);
 	}
 
 	// 角色动画置于最上层绘制，确保不被背景/敌人/弹幕覆盖
-	for (const auto& v : m_partyVisuals) v.draw(window);
+	for (const auto& v : m_partyVisuals) v.draw(target);
+	drawFloatingNumbers(target);
 }
 
 // 刷新菜单并将心形重置到盒子中心（新回合开始时）
@@ -579,29 +564,25 @@ void BattleState::handlePhaseTransitions()
 			m_actTimer = 0.f;
 			m_actPauseTimer = 0.4f;
 		} else {
-			//
-			m_battle.executeQueuedCommands();
-			if (m_battle.getPhase() != BattlePhase::Victory && m_battle.getPhase() != BattlePhase::GameOver) {
-				startBattleBoxEnter();
-			}
+			resolveTurn();
 		}
 	}
 	if (phase == BattlePhase::BulletHell && m_prevPhase == BattlePhase::ActionExecute) {
-		m_battle.setBulletExtraWait(5.f);
+		m_battle.setBulletExtraWait(BattleRules::kBulletExtraWait);
 		m_soul.setSpawnYOffset(-10.f);
 		syncSoulToBattleBox();
-		// 每个回合轮换弹幕模式
-		m_currentPattern = ((m_turnCount % 2) == 1) ? BulletPattern::PatternA : BulletPattern::PatternB;
-		m_activeBullets.clear();
-		m_bulletSpawnTimer = 0.f;
+		// 每只在场敌人一路弹幕：模式由其当前阶段指定，否则按回合轮换
+		m_attacks = BattleRules::attacksForTurn(m_battle.getEnemies(), m_turnCount);
+		m_bullets.clear();
+		m_hitPause = 0.f;
 		// 确保战斗箱已显示
 		if (m_boxState == BoxState::Hidden) {
 			startBattleBoxEnter();
 		}
 	}
 	if (phase == BattlePhase::TurnEnd && m_prevPhase == BattlePhase::BulletHell) {
-		m_activeBullets.clear();
-		m_bulletSpawnTimer = 0.f;
+		m_bullets.clear();
+		m_attacks.clear();
 		startBattleBoxExit();
 	}
 
@@ -621,38 +602,139 @@ void BattleState::handlePhaseTransitions()
 	}
 }
 
+// 背景渐变：合成时 Overworld 背景按 1 - alpha、World 图层按 alpha 叠加；
+// Overworld 画面完全淡出后释放捕获句柄
+void BattleState::applyBackgroundFade()
+{
+	const float alpha = std::clamp(m_bgFadeAlpha, 0.f, 1.f);
+	m_compositor.setOpacity(Layer::World, alpha);
+	if (alpha >= 1.f) {
+		m_compositor.clearBackdrop();
+	} else {
+		m_compositor.setBackdropOpacity(1.f - alpha);
+	}
+}
+
 // 旧版 HUD 绘制（敌人与日志）：当前逻辑保留、渲染已禁用（主 draw 已覆盖）
-void BattleState::drawHUD(sf::RenderWindow& window)
+void BattleState::drawHUD(sf::RenderTarget& target)
 {
 	// 敌人绘制与日志
-	const auto& enemies = m_battle.getEnemies();
-	float startX = 180.f;
-	for (std::size_t i = 0; i < enemies.size(); ++i) {
-		sf::Vector2f pos{ startX + static_cast<float>(i) * 200.f, 80.f };
-		enemies[i].draw(window, m_font, pos);
-	}
+	drawEnemies(target);
 
-	const auto& logs = m_battle.getLog();
+	const std::size_t logCount = m_battle.getLog().size();
 	float logY = 210.f;
-	for (const auto& line : logs) {
-		sf::Text t(m_font, line, 20);
+	for (std::size_t i = 0; i < logCount; ++i) {
+		sf::Text t(m_font, m_battle.logLine(i), 20);
 		t.setPosition({140.f, logY});
 		t.setFillColor(sf::Color(230, 230, 230));
-		window.draw(t);
+		target.draw(t);
 		logY += 24.f;
 	}
 }
 
+// 敌人绘制：有贴图的逐只画贴图；占位敌人的框与 HP/仁慈条追加进同一批顶点一次提交，
+// 名字沿用开战时创建的文本，只随仁慈状态换色
+void BattleState::drawEnemies(sf::RenderTarget& target)
+{
+	const auto& enemies = m_battle.getEnemies();
+	const std::size_t count = std::min(enemies.size(), m_enemySlots.size());
+	m_enemyBatch.clear();
+	for (std::size_t i = 0; i < count; ++i) {
+		const BattleRules::EnemySlot& slot = m_enemySlots[i];
+		if (enemies[i].hasSprite()) {
+			enemies[i].draw(target, slot.position, slot.scale);
+		} else {
+			enemies[i].appendPlaceholder(m_enemyBatch, slot.position, slot.scale);
+		}
+	}
+	m_enemyBatch.draw(target);
+	for (std::size_t i = 0; i < count && i < m_enemyNames.size(); ++i) {
+		if (enemies[i].hasSprite()) continue;
+		m_enemyNames[i].setFillColor(enemies[i].nameColor());
+		target.draw(m_enemyNames[i]);
+	}
+}
+
+// 回合结算：执行指令并生成飘字；行动直接分出胜负时不再放出战斗箱
+void BattleState::resolveTurn()
+{
+	m_battle.executeQueuedCommands();
+	spawnTurnFeedback();
+	if (m_battle.getPhase() != BattlePhase::Victory && m_battle.getPhase() != BattlePhase::GameOver) {
+		startBattleBoxEnter();
+	}
+}
+
+// 读取本回合结算事件：造成伤害的飘在敌人上方，回复的飘在目标角色上方；同一目标的多条依次上移
+void BattleState::spawnTurnFeedback()
+{
+	const int partyCount = static_cast<int>(m_partyVisuals.size());
+	std::vector<int> enemyStack(m_battle.getEnemies().size(), 0);
+	std::vector<int> heroStack(m_partyVisuals.size(), 0);
+	for (const auto& ev : m_battle.getTurnEvents()) {
+		FloatingNumber n;
+		n.amount = ev.amount;
+		if ((ev.kind == TurnEventKind::Damage || ev.kind == TurnEventKind::Act) && ev.amount > 0) {
+			if (ev.target < 0 || ev.target >= static_cast<int>(enemyStack.size())) continue;
+			const int stack = enemyStack[ev.target]++;
+			const BattleRules::EnemySlot& slot = m_enemySlots[static_cast<std::size_t>(ev.target)];
+			n.position = slot.position + sf::Vector2f{ 80.f * slot.scale, -10.f - 22.f * stack };
+		} else if ((ev.kind == TurnEventKind::Heal || ev.kind == TurnEventKind::ItemUsed) && ev.amount > 0) {
+			if (ev.target < 0 || ev.target >= partyCount) continue;
+			const int stack = heroStack[ev.target]++;
+			n.position = partySlotPosition(ev.target, partyCount) + sf::Vector2f{ 0.f, -40.f - 22.f * stack };
+			n.color = sf::Color(120, 255, 120);
+		} else {
+			continue;
+		}
+		m_floatingNumbers.push_back(n);
+	}
+}
+
+// 飘字上浮并在寿命结束后移除
+void BattleState::updateFloatingNumbers(float dt)
+{
+	for (auto& n : m_floatingNumbers) {
+		n.timer += dt;
+		n.position.y -= 30.f * dt;
+	}
+	m_floatingNumbers.erase(std::remove_if(m_floatingNumbers.begin(), m_floatingNumbers.end(), [this](const FloatingNumber& n) {
+		return n.timer >= m_floatingNumberLife;
+	}), m_floatingNumbers.end());
+}
+
+// 飘字后段线性淡出
+void BattleState::drawFloatingNumbers(sf::RenderTarget& target) const
+{
+	for (const auto& n : m_floatingNumbers) {
+		const float fade = std::clamp((m_floatingNumberLife - n.timer) / (m_floatingNumberLife * 0.4f), 0.f, 1.f);
+		sf::Text t(m_font, sf::String(std::to_string(n.amount)), 24);
+		sf::Color c = n.color;
+		c.a = static_cast<std::uint8_t>(255.f * fade);
+		t.setFillColor(c);
+		t.setOutlineColor(sf::Color(0, 0, 0, c.a));
+		t.setOutlineThickness(2.f);
+		t.setOrigin(t.getLocalBounds().size * 0.5f);
+		t.setPosition(n.position);
+		target.draw(t);
+	}
+}
+
 // 退出战斗：
-// - 胜利返回 Overworld，失败返回 Title
-// - 停止音乐，切换状态
+// - 胜利出栈，恢复挂起在下层的 Overworld（地图、队伍与音乐原样保留）
+// - 失败清空状态栈返回 Title
+// - 停止音乐；同一帧内可能多次确认，只提交一次切换
+// - 释放物品占用：最后一回合选中、或未被消耗（无效果）的物品不会把占用带出战斗
 void BattleState::tryExitBattle()
 {
+	if (m_exitRequested) return;
+	m_exitRequested = true;
+	Global::inventory.clearReservations();
 	AudioManager::getInstance().stopMusic();
 	if (m_victory) {
-		m_game.changeState(std::make_unique<OverworldState>(m_game));
+		m_game.popState();
 	} else {
-		m_game.changeState(std::make_unique<TitleState>(m_game));
+		m_game.resetStates(std::make_unique<TitleState>(m_game));
 	}
 }
 
@@ -692,8 +774,7 @@ void BattleState::updateBattleBoxTransform()
 void BattleState::syncSoulToBattleBox()
 {
 	if (!m_boxSprite || m_boxState == BoxState::Hidden) return;
-	sf::Vector2f size{ 145.f, 145.f };
-	m_boxBounds = sf::FloatRect({ m_boxPosition.x - size.x * 0.5f + 28.f, m_boxPosition.y - size.y * 0.5f + 32.f }, size);
+	m_boxBounds = BattleRules::soulBounds(m_boxPosition);
 	m_soul.setBounds(m_boxBounds);
 }
 
@@ -745,61 +826,97 @@ void BattleState::updateBattleBox(float dt)
 }
 
 // 弹幕更新：
-// - 按当前模式周期生成弹幕，并更新其运动与碰撞
-// - 命中时根据共享护盾与防御判定伤害，播放对应音效
-// - 命中后设置心形无敌时间，防止短时间内多次伤害
-// - 同步护盾破碎动画的逐帧推进
+// - 各敌人的弹幕流按各自模式周期生成，统一放入同一个池
+// - 弹幕池内核积分并判定命中/出界，只输出命中事件
+// - 命中事件单独结算：共享护盾与防御判定伤害，同帧多次命中只结算一次、各音效只播一次
+// - 结算后设置心形无敌时间与短暂的命中停顿
 void BattleState::updateBullets(float dt)
 {
 	if (m_battle.getPhase() != BattlePhase::BulletHell) return;
-	float spawnInterval = (m_currentPattern == BulletPattern::PatternA) ? 0.5f : 0.3f;
-	m_bulletSpawnTimer += dt;
-	while (m_bulletSpawnTimer >= spawnInterval) {
-		m_bulletSpawnTimer -= spawnInterval;
-		if (m_currentPattern == BulletPattern::PatternA) spawnPatternA();
-		else spawnPatternB();
+	updateShieldAnimation(dt);
+	// 命中停顿：弹幕生成与移动暂停，心形仍可移动
+	if (m_hitPause > 0.f) {
+		m_hitPause = std::max(0.f, m_hitPause - dt);
+		return;
+	}
+	for (auto& attack : m_attacks) {
+		attack.timer += dt;
+		while (attack.timer >= attack.interval) {
+			attack.timer -= attack.interval;
+			if (attack.pattern == BulletPattern::PatternA) spawnPatternA();
+			else spawnPatternB();
+		}
 	}
 
 	sf::Vector2f viewSize = m_game.getWindow().getView().getSize();
 	sf::FloatRect viewBounds({0.f, 0.f}, viewSize);
 
-	auto soulBounds = m_soul.getBounds();
-		auto intersects = [](const sf::FloatRect& a, const sf::FloatRect& b) {
-		float ax1 = a.position.x;
-		float ay1 = a.position.y;
-		float ax2 = ax1 + a.size.x;
-		float ay2 = ay1 + a.size.y;
-		float bx1 = b.position.x;
-		float by1 = b.position.y;
-		float bx2 = bx1 + b.size.x;
-		float by2 = by1 + b.size.y;
-		return !(ax2 < bx1 || ax1 > bx2 || ay2 < by1 || ay1 > by2);
-	};
-	m_activeBullets.erase(std::remove_if(m_activeBullets.begin(), m_activeBullets.end(), [&](ActiveBullet& b) {
-		b.bullet.update(dt);
-		bool hitSoul = intersects(soulBounds, b.bullet.getBounds());
-		if (hitSoul) {
-			if (!m_soul.isInvincible()) {
-				DamageResult dmgRes = b.hitsAll ? applyDamageAllHeroes(b.damage) : applyDamageRandomHero(b.damage);
-				bool shieldTriggered = dmgRes.shieldTriggered;
-				bool tookDamage = dmgRes.damageApplied;
-				if (shieldTriggered) {
-					AudioManager::getInstance().playSound("holyshield");
-					m_shieldAnimPlaying = !m_holyShieldFrames.empty();
-					m_shieldAnimFrame = 0;
-					m_shieldAnimTimer = 0.f;
-				}
-				if (tookDamage) {
-					AudioManager::getInstance().playSound("hurt");
-				}
-				m_soul.setInvincible(0.5f);
-			}
-			return true;
+	// 碰撞内核只积分、判定并输出命中事件（顺带标记擦弹范围内的弹幕）；伤害、护盾与音效在其后单独结算
+	m_bullets.setGrazeArea(m_boxBounds, m_grazeRadius);
+	m_hitEvents.clear();
+	m_bullets.step(dt, m_soul.getBounds(), viewBounds, m_hitEvents, JobSystem::getInstance());
+	const BattleRules::HitResolution hit = BattleRules::resolveHits(m_hitEvents, m_soul.isInvincible(),
+		m_battle.partyMutable(), m_battle.resolver(), m_shield, m_rng);
+	m_bullets.compact();
+	if (hit.resolved) {
+		if (hit.damage.shieldTriggered) {
+			AudioManager::getInstance().playSound("holyshield");
+			m_shieldAnimPlaying = !m_holyShieldFrames.empty();
+			m_shieldAnimFrame = 0;
+			m_shieldAnimTimer = 0.f;
 		}
-		if (b.bullet.isOffscreen(viewBounds)) return true;
-		return false;
-	}), m_activeBullets.end());
+		if (hit.damage.damageApplied) {
+			AudioManager::getInstance().playSound("hurt");
+		}
+		m_soul.setInvincible(BattleRules::kHitInvincibility);
+		m_hitPause = BattleRules::kHitPause;
+	}
+	updateGraze();
+}
 
+// 擦弹：网格覆盖战斗箱外扩的擦弹范围，只检查心形附近格子里的弹幕；无敌期间不计
+void BattleState::updateGraze()
+{
+	if (m_soul.isInvincible() || m_bullets.empty()) return;
+	m_bulletGrid.rebuild(m_bullets, BattleRules::kGrazeCellSize);
+	m_grazeEvents.clear();
+	m_bullets.collectGrazes(m_bulletGrid, m_soul.getBounds(), m_grazeRadius, m_grazeEvents);
+	if (m_grazeEvents.empty()) return;
+	m_battle.addTP(BattleRules::kGrazeTP * static_cast<float>(m_grazeEvents.size()));
+	m_tpFlash = kTpFlashTime;
+}
+
+// TP 条：竖条自下而上填充，满值变黄，擦弹后向白色提亮；上方为 TP 标志，下方为百分比（满值显示 MAX）
+void BattleState::drawTPBar(sf::RenderTarget& target)
+{
+	const float ratio = std::clamp(m_battle.getTP() / BattleRules::kMaxTP, 0.f, 1.f);
+	const float flash = m_tpFlash / kTpFlashTime;
+	const sf::Color base = (ratio >= 1.f) ? sf::Color(255, 208, 32) : sf::Color(255, 160, 64);
+	auto brighten = [flash](std::uint8_t c) { return static_cast<std::uint8_t>(c + (255 - c) * flash); };
+	const sf::Color fillColor(brighten(base.r), brighten(base.g), brighten(base.b));
+	const float fill = kTpBarSize.y * ratio;
+
+	m_tpBatch.clear();
+	m_tpBatch.add({ kTpBarPosition, kTpBarSize }, sf::Color(128, 0, 0));
+	m_tpBatch.add({ { kTpBarPosition.x, kTpBarPosition.y + kTpBarSize.y - fill }, { kTpBarSize.x, fill } }, fillColor);
+	m_tpBatch.addOutline({ kTpBarPosition, kTpBarSize }, 2.f, sf::Color::White);
+	m_tpBatch.draw(target);
+
+	if (m_tpLogoLoaded) {
+		sf::Sprite logo(m_tpLogoTex);
+		logo.setPosition({ kTpBarPosition.x - 1.f, kTpBarPosition.y - 48.f });
+		target.draw(logo);
+	}
+	const int percent = static_cast<int>(m_battle.getTP());
+	sf::Text label(m_tpFont, ratio >= 1.f ? sf::String("MAX") : sf::String(std::to_string(percent) + "%"), 16);
+	label.setFillColor(ratio >= 1.f ? sf::Color(255, 208, 32) : sf::Color::White);
+	label.setPosition({ kTpBarPosition.x - 6.f, kTpBarPosition.y + kTpBarSize.y + 4.f });
+	target.draw(label);
+}
+
+// 护盾破碎动画逐帧推进（命中停顿期间照常播放）
+void BattleState::updateShieldAnimation(float dt)
+{
 	if (m_shieldAnimPlaying && !m_holyShieldFrames.empty()) {
 		m_shieldAnimTimer += dt;
 		while (m_shieldAnimTimer >= m_shieldFrameTime) {
@@ -813,122 +930,49 @@ void BattleState::updateBullets(float dt)
 	}
 }
 
-// 弹幕模式 A：
-// - 在心形周围随机角度生成，朝心形方向匀速推进
-// - 伤害值偏高，碰撞框略作偏移用于贴合素材
+// 弹幕模式 A：生成参数见 BattleRules::spawnPatternA
 void BattleState::spawnPatternA()
 {
 	if (!m_bulletTex1Loaded) return;
-	const sf::Vector2f heart = m_soul.getPosition();
-	std::uniform_real_distribution<float> angleDist(0.f, 6.2831853f);
-	float ang = angleDist(m_rng);
-	sf::Vector2f dir{ std::cos(ang), std::sin(ang) };
-	sf::Vector2f spawnPos{ heart.x + dir.x * 150.f, heart.y + dir.y * 150.f };
-	sf::Vector2f toHeart{ heart.x - spawnPos.x, heart.y - spawnPos.y };
-	float len = std::sqrt(toHeart.x * toHeart.x + toHeart.y * toHeart.y);
-	if (len < 1e-3f) len = 1.f;
-	toHeart.x /= len; toHeart.y /= len;
-	float speed = 192.f; // 20% slower
-	ActiveBullet ab{ Bullet(m_bulletTexture1, spawnPos, { toHeart.x * speed, toHeart.y * speed }), 15, false };
-	ab.bullet.setHitboxOffset({ -2.f, -5.f });
-	m_activeBullets.push_back(std::move(ab));
-}
-
-// 弹幕模式 B：
-// - 在盒子上边界随机 X 生成，竖直下落
-// - 作为群体伤害（hitsAll），更容易触发共享护盾
+	m_bullets.spawn(BattleRules::spawnPatternA(m_soul.getPosition(), m_rng));
+}
+
+// 弹幕模式 B：生成参数见 BattleRules::spawnPatternB
 void BattleState::spawnPatternB()
 {
 	if (!m_bulletTex2Loaded) return;
-	float xMin = m_boxBounds.position.x;
-	float xMax = m_boxBounds.position.x + m_boxBounds.size.x;
-	std::uniform_real_distribution<float> xDist(xMin, xMax);
-	float spawnX = xDist(m_rng);
-	float spawnY = m_boxBounds.position.y - 8.f;
-	float speed = 260.f;
-	ActiveBullet ab{ Bullet(m_bulletTexture2, { spawnX, spawnY }, { 0.f, speed }), 10, true };
-	ab.bullet.setRotation(90.f);
-	m_activeBullets.push_back(std::move(ab));
-}
-
-// 对单个随机存活角色结算伤害：
-// - 若共享护盾可用且队伍中有圣斗篷存活，则直接吸收一次命中
-// - 伤害 = max(0, dmg - 基础防御)；防御中时减半（向上取整）
-BattleState::DamageResult BattleState::applyDamageRandomHero(int dmg)
-{
-	DamageResult res{};
-	auto& party = m_battle.partyMutable();
-	if (party.empty()) return res;
-	if (m_sharedShieldReady && hasMantleAlive()) {
-		consumeShield();
-		res.shieldTriggered = true;
-		return res;
-	}
-	std::vector<int> alive;
-	alive.reserve(party.size());
-	for (int i = 0; i < static_cast<int>(party.size()); ++i) {
-		if (party[i].hp > 0) alive.push_back(i);
-	}
-	if (alive.empty()) return res;
-	std::uniform_int_distribution<int> idxDist(0, static_cast<int>(alive.size()) - 1);
-	int chosen = alive[idxDist(m_rng)];
-	int realDmg = std::max(0, dmg - party[chosen].baseDefense);
-	if (party[chosen].defending) {
-		realDmg = (realDmg + 1) / 2; // 50% 减伤，向上取整
-	}
-	if (realDmg > 0) {
-		int before = party[chosen].hp;
-		party[chosen].hp = std::max(0, party[chosen].hp - realDmg);
-		res.damageApplied = (party[chosen].hp < before);
-	}
-	return res;
-}
-
-// 对所有存活角色结算群体伤害：
-// - 若共享护盾可用且队伍中有圣斗篷存活，则全体伤害被护盾完全吸收一次
-// - 个体伤害同样受基础防御与“防御中”状态影响
-BattleState::DamageResult BattleState::applyDamageAllHeroes(int dmg)
-{
-	DamageResult res{};
-	auto& party = m_battle.partyMutable();
-	if (m_sharedShieldReady && hasMantleAlive()) {
-		consumeShield();
-		res.shieldTriggered = true;
-		return res; 
-	}
-	for (std::size_t i = 0; i < party.size(); ++i) {
-		auto& h = party[i];
-		if (h.hp <= 0) continue;
-		int realDmg = std::max(0, dmg - h.baseDefense);
-		if (h.defending) {
-			realDmg = (realDmg + 1) / 2;
-		}
-		if (realDmg > 0) {
-			int before = h.hp;
-			h.hp = std::max(0, h.hp - realDmg);
-			res.damageApplied = res.damageApplied || (h.hp < before);
-		}
-	}
-	return res;
+	m_bullets.spawn(BattleRules::spawnPatternB(m_boxBounds, m_rng));
 }
 
-// 判定队伍中是否存在“携带圣斗篷且存活”的角色
-bool BattleState::hasMantleAlive() const
+// 弹幕按贴图种类各拼成一个顶点数组绘制（每种一次 draw）
+void BattleState::drawBullets(sf::RenderTarget& target)
 {
-	const auto& party = m_battle.getParty();
-	std::size_t n = std::min(party.size(), m_hasHolyMantle.size());
-	for (std::size_t i = 0; i < n; ++i) {
-		if (m_hasHolyMantle[i] && party[i].hp > 0) return true;
+	const std::pair<std::uint8_t, const sf::Texture*> kinds[] = {
+		{ BattleRules::kBulletClubs, m_bulletTex1Loaded ? &m_bulletTexture1 : nullptr },
+		{ BattleRules::kBulletDiamond, m_bulletTex2Loaded ? &m_bulletTexture2 : nullptr },
+	};
+	for (const auto& [kind, texture] : kinds) {
+		if (!texture) continue;
+		m_bulletVertices.clear();
+		m_bullets.appendQuads(kind, *texture, m_bulletVertices);
+		if (m_bulletVertices.getVertexCount() == 0) continue;
+		sf::RenderStates states;
+		states.texture = texture;
+		target.draw(m_bulletVertices, states);
+	}
+	if (m_debugDraw) {
+		// Debug draw bullet broad-phase bounds (pixel masks refine hits inside them)
+		for (std::size_t i = 0; i < m_bullets.size(); ++i) {
+			sf::FloatRect r = m_bullets.bounds(i);
+			sf::RectangleShape rect;
+			rect.setPosition({ r.position.x, r.position.y });
+			rect.setSize(r.size);
+			rect.setFillColor(sf::Color(255, 0, 255, 30));
+			rect.setOutlineColor(sf::Color(255, 0, 255, 180));
+			rect.setOutlineThickness(2.f);
+			target.draw(rect);
+		}
 	}
-	return false;
-}
-
-// 消耗共享护盾：
-// - 关闭当回合的共享护盾，并清空每个角色的护盾就绪状态
-void BattleState::consumeShield()
-{
-	m_sharedShieldReady = false;
-	std::fill(m_holyShieldReady.begin(), m_holyShieldReady.end(), false);
 }
 
 // 在新回合开始时重置护盾就绪：
@@ -937,17 +981,7 @@ void BattleState::consumeShield()
 // - 清零护盾破碎动画的播放状态
 void BattleState::resetHolyShieldReady()
 {
-	// 根据当前队伍状态重置护盾就绪
-	auto& party = m_battle.partyMutable();
-	std::size_t n = party.size();
-	m_holyShieldReady.resize(n, false);
-	m_sharedShieldReady = false;
-	for (std::size_t i = 0; i < n; ++i) {
-		bool hasMantle = (i < m_hasHolyMantle.size()) ? m_hasHolyMantle[i] : false;
-		bool ready = hasMantle && party[i].hp > 0;
-		m_holyShieldReady[i] = ready;
-		m_sharedShieldReady = m_sharedShieldReady || ready;
-	}
+	m_shield.resetForTurn(m_battle.getParty());
 	m_shieldAnimPlaying = false;
 	m_shieldAnimFrame = 0;
 	m_shieldAnimTimer = 0.f;
@@ -4,7 +4,7 @@
 
 控制当前敌人
 
-调用 Soul / Enemy / Bullet
+调用 Soul / Enemy / BulletPool
 
 战斗 UI
 
@@ -12,33 +12,53 @@
 */
 #pragma once
 #include <SFML/Graphics.hpp>
+#include <memory>
 #include <optional>
 #include <random>
+#include <string>
+#include <vector>
 #include "States/BaseState.h"
 #include "Battle/Battle.h"
 #include "UI/BattleMenu.h"
+#include "UI/RectBatch.h"
 #include "Battle/Soul.h"
 #include "UI/DialogBox.h"
 #include "Battle/BattleActor.h"
-#include "Battle/Bullet.h"
+#include "Battle/BulletPool.h"
+#include "Battle/BulletGrid.h"
+#include "Battle/BattleRules.h"
+#include "Game/GlobalContext.h"
+#include "Game/Compositor.h"
 
 class BattleState : public BaseState {
 public:
 	BattleState(Game& game,
 		std::vector<Enemy> enemies,
 		std::vector<sf::Vector2f> partyStarts,
-		std::optional<sf::Texture> overworldBgTex = std::nullopt,
-		sf::Vector2f overworldBgScale = {1.f, 1.f});
+		std::shared_ptr<const sf::Texture> overworldFrame = nullptr);
 
 	void handleEvent() override;
 	void update(float dt) override;
-	void draw(sf::RenderWindow& window) override;
+	void draw(sf::RenderTarget& target) override;
+	void onEnter() override;
+
+	// 构造时要加载的图片路径（供 Game::transitionTo 在后台预解码）
+	static std::vector<std::string> preloadPaths(const std::vector<HeroRuntime>& party, const std::vector<Enemy>& enemies);
 
 private:
 	void refreshMenuIfNeeded();
 	void handlePhaseTransitions();
-	void drawHUD(sf::RenderWindow& window);
+	void drawHUD(sf::RenderTarget& target);
+	void applyBackgroundFade();
+	void drawScene(sf::RenderTarget& target);
+	// 敌人：贴图逐只绘制，占位框与血条合成一批，名字文本开战时创建一次
+	void drawEnemies(sf::RenderTarget& target);
 	void tryExitBattle();
+	// 执行本回合指令并把结算事件转成飘字；未分出胜负时放出战斗箱
+	void resolveTurn();
+	void spawnTurnFeedback();
+	void updateFloatingNumbers(float dt);
+	void drawFloatingNumbers(sf::RenderTarget& target) const;
 	void startBattleBoxEnter();
 	void startBattleBoxExit();
 	void updateBattleBox(float dt);
@@ -47,11 +67,10 @@ private:
 	void updateBullets(float dt);
 	void spawnPatternA();
 	void spawnPatternB();
-	struct DamageResult { bool shieldTriggered = false; bool damageApplied = false; };
-	DamageResult applyDamageRandomHero(int dmg);
-	DamageResult applyDamageAllHeroes(int dmg);
-	bool hasMantleAlive() const;
-	void consumeShield();
+	void drawBullets(sf::RenderTarget& target);
+	void updateGraze();
+	void drawTPBar(sf::RenderTarget& target);
+	void updateShieldAnimation(float dt);
 	void resetHolyShieldReady();
 
 private:
@@ -61,18 +80,21 @@ private:
 	DialogueBox m_dialogue;
 	sf::RectangleShape m_bulletBox;
 	sf::Font m_font;
+	std::vector<BattleRules::EnemySlot> m_enemySlots; // 开战时按人数求解的站位
+	std::vector<sf::Text> m_enemyNames;               // 占位敌人的名字（与敌人下标对应）
+	RectBatch m_enemyBatch;                           // 占位框与 HP/仁慈条，每帧重建、一次提交
 	BattlePhase m_prevPhase = BattlePhase::Intro;
 	bool m_waitingForExit = false;
 	bool m_victory = false;
+	bool m_exitRequested = false;
 
 	// 三人战斗入场与待机动画
 	std::vector<BattleActorVisual> m_partyVisuals;
 	std::vector<sf::Vector2f> m_partyStarts;
 
-	// 背景：战斗动态帧与从 Overworld 捕获的背景的渐隐/渐显
-	std::optional<sf::Texture> m_overworldBg;
-	std::optional<sf::Sprite> m_overworldBgSprite;
-	sf::Vector2f m_overworldBgScale{1.f, 1.f};
+	// 分层合成：Overworld 捕获画面（共享句柄，不拷贝贴图）作为背景，World 图层为战斗背景帧，UI 图层为其余内容
+	// 交叉淡化只改合成不透明度；渐变结束即释放捕获画面
+	Compositor m_compositor;
 
 	std::vector<sf::Texture> m_battleBgFrames;
 	std::optional<sf::Sprite> m_battleBgSprite;
@@ -103,6 +125,15 @@ private:
 
 	// When true, Act-style text is used for exit message (no dialogue box)
 	bool m_isExitText = false;
+	// 回合事件飘字：伤害白字浮在敌人上方，治疗绿字浮在角色上方
+	struct FloatingNumber {
+		sf::Vector2f position;
+		int amount = 0;
+		sf::Color color = sf::Color::White;
+		float timer = 0.f;
+	};
+	std::vector<FloatingNumber> m_floatingNumbers;
+	float m_floatingNumberLife = 0.9f;
 	bool m_debugDraw = false;
 
 	// 回合计数（进入 Selection 阶段时递增）
@@ -123,25 +154,29 @@ private:
 	sf::FloatRect m_boxBounds{};
 
 	// 弹幕系统
-	struct ActiveBullet {
-		Bullet bullet;
-		int damage = 0;
-		bool hitsAll = false;
-	};
-	std::vector<ActiveBullet> m_activeBullets;
-	float m_bulletSpawnTimer = 0.f;
-	enum class BulletPattern { PatternA, PatternB };
-	BulletPattern m_currentPattern = BulletPattern::PatternA;
+	BulletPool m_bullets;                  // 所有敌人的弹幕共用一个池
+	std::vector<BulletHit> m_hitEvents;    // 本帧碰撞内核产出的命中事件（复用容量）
+	float m_hitPause = 0.f;                // 命中停顿剩余时间
+	BulletGrid m_bulletGrid;               // 擦弹宽相位：每步压紧后按战斗箱范围重建
+	std::vector<std::uint32_t> m_grazeEvents; // 本帧新擦到的弹幕（复用容量）
+	float m_grazeRadius = BattleRules::kGrazeRadius;
+	sf::VertexArray m_bulletVertices{ sf::PrimitiveType::Triangles };
+	std::vector<BattleRules::EnemyAttack> m_attacks; // 本回合各敌人贡献的弹幕流（各自计时）
 	sf::Texture m_bulletTexture1;
 	sf::Texture m_bulletTexture2;
 	bool m_bulletTex1Loaded = false;
 	bool m_bulletTex2Loaded = false;
 	std::mt19937 m_rng;
 
+	// TP 条：左侧竖条，TpBar 字体显示百分比；擦弹时短暂提亮
+	sf::Font m_tpFont;
+	sf::Texture m_tpLogoTex;
+	bool m_tpLogoLoaded = false;
+	RectBatch m_tpBatch;
+	float m_tpFlash = 0.f;
+
 	// Holy Mantle (per hero)
-	std::vector<bool> m_hasHolyMantle;
-	std::vector<bool> m_holyShieldReady;
-	bool m_sharedShieldReady = false;
+	BattleRules::HolyShield m_shield;
 	bool m_shieldAnimPlaying = false;
 	int m_shieldAnimFrame = 0;
 	float m_shieldAnimTimer = 0.f;
@@ -7,6 +7,8 @@
 #include "Game/SaveManager.h"
 #include "States/BattleState.h"
 #include "Battle/Calculus.h"
+#include "Overworld/RoomLoader.h"
+#include "Overworld/AnimationClip.h"
 #include <algorithm>
 #include <array>
 #include <cstdint>
@@ -16,75 +18,25 @@
 // 探索状态（OverworldState）模块说明
 // ------------------------------------
 // 负责游戏在“探索/行走”场景下的主循环，包括：
-// - 资源加载：字体、背景贴图、背景音乐与角色行走贴图集
+// - 资源加载：字体、背景音乐与角色行走贴图集
+// - 进入战斗：把当前世界画面渲染到常驻 RenderTexture，以共享句柄交给战斗做渐隐背景
 // - 输入分发：退出、调试开关、菜单/背包、对话锁定下的选择与推进
 // - 地图交互：探测“可交互物体”（存档点、道具、战斗触发等）并驱动 UI
-// - 队伍编队：队长与跟随者的历史轨迹与跟随行为
+// - 队伍编队：队长轨迹（LeaderTrail）与跟随者按路径距离的跟随行为
 // - 传送与渐变：房间切换的淡入淡出状态机
-// - 渲染管理：背景、地图项、角色、对话框、背包 UI、调试覆盖与渐变遮罩
+// - 渲染管理：背景、地图项、角色（持久 DrawList，静态道具预排序 + 动态项插入排序）、对话框、背包 UI、调试覆盖与渐变遮罩；
+//   经 Compositor 分层合成，UI 图层只在内容变化时重画，渐变遮罩在合成时叠加
 // 关键约定：
-// - 角色行走贴图按上下左右四方向、每方向四帧组织为 SpriteSet
+// - 角色行走贴图按上下左右四方向、每方向四帧组织为 SpriteSet，由 CharacterRegistry 按英雄 ID 提供；
+//   AnimationLibrary 将其打包为共享图集，同一角色的实例只占一张贴图
+// - 队伍成员与顺序来自 Global::partyHeroes，人数不限；队员在出生点后方按左右交替排成队形
 // - 交互对象通过 Map::checkInteraction 以“脚前方小矩形传感框”检出
 // - 渐变状态机分 None/Out/In；Out 完成后实际切房，随后 In 淡入
 // - 背包 UI 打开时锁定输入，不更新角色移动，关闭后恢复
+// - 进入战斗时本状态被压在栈下挂起（不销毁），战斗胜利出栈后原地恢复，无需重新加载
 //
 
 namespace {
-// 贴图路径：为 Kris 角色构造四个方向的 4 帧行走序列
-// 返回的 SpriteSet.frames 为 4 × 4 字符串数组，依次为 Down/Left/Right/Up
-SpriteSet makeKrisSprites() {
-    SpriteSet set{};
-    set.frames = {
-        std::array<std::string, 4>{
-            "assets/sprite/Kris/spr_krisd_dark/spr_krisd_dark_0.png",
-            "assets/sprite/Kris/spr_krisd_dark/spr_krisd_dark_1.png",
-            "assets/sprite/Kris/spr_krisd_dark/spr_krisd_dark_2.png",
-            "assets/sprite/Kris/spr_krisd_dark/spr_krisd_dark_3.png"},
-        std::array<std::string, 4>{
-            "assets/sprite/Kris/spr_krisl_dark/spr_krisl_dark_0.png",
-            "assets/sprite/Kris/spr_krisl_dark/spr_krisl_dark_1.png",
-            "assets/sprite/Kris/spr_krisl_dark/spr_krisl_dark_2.png",
-            "assets/sprite/Kris/spr_krisl_dark/spr_krisl_dark_3.png"},
-        std::array<std::string, 4>{
-            "assets/sprite/Kris/spr_krisr_dark/spr_krisr_dark_0.png",
-            "assets/sprite/Kris/spr_krisr_dark/spr_krisr_dark_1.png",
-            "assets/sprite/Kris/spr_krisr_dark/spr_krisr_dark_2.png",
-            "assets/sprite/Kris/spr_krisr_dark/spr_krisr_dark_3.png"},
-        std::array<std::string, 4>{
-            "assets/sprite/Kris/spr_krisu_dark/spr_krisu_dark_0.png",
-            "assets/sprite/Kris/spr_krisu_dark/spr_krisu_dark_1.png",
-            "assets/sprite/Kris/spr_krisu_dark/spr_krisu_dark_2.png",
-            "assets/sprite/Kris/spr_krisu_dark/spr_krisu_dark_3.png"}
-    };
-    return set;
-}
-
-// 贴图路径：为 Ralsei 角色构造四方向行走帧序列（每方向 4 帧）
-// 命名约定：assets/sprite/Ralsei/spr_ralsei_walk_<dir>/spr_ralsei_walk_<dir>_<frame>.png
-SpriteSet makeRalseiSprites() {
-    SpriteSet set{};
-    set.frames = {
-        std::array<std::string, 4>{ "assets/sprite/Ralsei/spr_ralsei_walk_down/spr_ralsei_walk_down_0.png", "assets/sprite/Ralsei/spr_ralsei_walk_down/spr_ralsei_walk_down_1.png", "assets/sprite/Ralsei/spr_ralsei_walk_down/spr_ralsei_walk_down_2.png", "assets/sprite/Ralsei/spr_ralsei_walk_down/spr_ralsei_walk_down_3.png" },
-        std::array<std::string, 4>{ "assets/sprite/Ralsei/spr_ralsei_walk_left/spr_ralsei_walk_left_0.png", "assets/sprite/Ralsei/spr_ralsei_walk_left/spr_ralsei_walk_left_1.png", "assets/sprite/Ralsei/spr_ralsei_walk_left/spr_ralsei_walk_left_2.png", "assets/sprite/Ralsei/spr_ralsei_walk_left/spr_ralsei_walk_left_3.png" },
-        std::array<std::string, 4>{ "assets/sprite/Ralsei/spr_ralsei_walk_right/spr_ralsei_walk_right_0.png", "assets/sprite/Ralsei/spr_ralsei_walk_right/spr_ralsei_walk_right_1.png", "assets/sprite/Ralsei/spr_ralsei_walk_right/spr_ralsei_walk_right_2.png", "assets/sprite/Ralsei/spr_ralsei_walk_right/spr_ralsei_walk_right_3.png" },
-        std::array<std::string, 4>{ "assets/sprite/Ralsei/spr_ralsei_walk_up/spr_ralsei_walk_up_0.png", "assets/sprite/Ralsei/spr_ralsei_walk_up/spr_ralsei_walk_up_1.png", "assets/sprite/Ralsei/spr_ralsei_walk_up/spr_ralsei_walk_up_2.png", "assets/sprite/Ralsei/spr_ralsei_walk_up/spr_ralsei_walk_up_3.png" }
-    };
-    return set;
-}
-
-// 贴图路径：为 Susie 角色构造四方向行走帧序列（每方向 4 帧）
-// 资源名后缀 “_dw” 与美术导出约定一致
-SpriteSet makeSusieSprites() {
-    SpriteSet set{};
-    set.frames = {
-        std::array<std::string, 4>{ "assets/sprite/Susie/spr_susie_walk_down_dw/spr_susie_walk_down_dw_0.png", "assets/sprite/Susie/spr_susie_walk_down_dw/spr_susie_walk_down_dw_1.png", "assets/sprite/Susie/spr_susie_walk_down_dw/spr_susie_walk_down_dw_2.png", "assets/sprite/Susie/spr_susie_walk_down_dw/spr_susie_walk_down_dw_3.png" },
-        std::array<std::string, 4>{ "assets/sprite/Susie/spr_susie_walk_left_dw/spr_susie_walk_left_dw_0.png", "assets/sprite/Susie/spr_susie_walk_left_dw/spr_susie_walk_left_dw_1.png", "assets/sprite/Susie/spr_susie_walk_left_dw/spr_susie_walk_left_dw_2.png", "assets/sprite/Susie/spr_susie_walk_left_dw/spr_susie_walk_left_dw_3.png" },
-        std::array<std::string, 4>{ "assets/sprite/Susie/spr_susie_walk_right_dw/spr_susie_walk_right_dw_0.png", "assets/sprite/Susie/spr_susie_walk_right_dw/spr_susie_walk_right_dw_1.png", "assets/sprite/Susie/spr_susie_walk_right_dw/spr_susie_walk_right_dw_2.png", "assets/sprite/Susie/spr_susie_walk_right_dw/spr_susie_walk_right_dw_3.png" },
-        std::array<std::string, 4>{ "assets/sprite/Susie/spr_susie_walk_up_dw/spr_susie_walk_up_dw_0.png", "assets/sprite/Susie/spr_susie_walk_up_dw/spr_susie_walk_up_dw_1.png", "assets/sprite/Susie/spr_susie_walk_up_dw/spr_susie_walk_up_dw_2.png", "assets/sprite/Susie/spr_susie_walk_up_dw/spr_susie_walk_up_dw_3.png" }
-    };
-    return set;
-}
-
 // 文本换行（按像素宽度）
 // 参数：
 // - input：要渲染的 sf::String（支持多语言，含中文）
@@ -127,40 +79,29 @@ sf::String wrapTextToWidth(const sf::String& input, float maxWidth, const sf::Fo
 OverworldState::OverworldState(Game& game)
     : BaseState(game),
       m_font("assets/font/Common.ttf"),
-      //m_backgroundTexture("assets/sprite/Room/room_alphysclass.png"),
-      m_backgroundSprite(m_backgroundTexture),
-      m_backgroundMusic("assets/music/Choral_Chambers.mp3"),
-    m_kris(game, makeKrisSprites()),
-    m_ralsei(game, makeRalseiSprites()),
-    m_susie(game, makeSusieSprites())
+      m_backgroundMusic("assets/music/Choral_Chambers.mp3")
 {
-    // 初始化探索状态的元素（字体/背景/音乐）
+    // 初始化探索状态的元素（字体/音乐）
 
     if (!m_font.openFromFile("assets/font/Common.ttf")) {
         // 处理字体加载失败
         std::cerr << "Failed to load font!" << std::endl;
     }
 
-    if (!m_backgroundTexture.loadFromFile("assets/sprite/Room/room_alphysclass.png")) {
-        // 处理背景纹理加载失败
-        std::cerr << "Failed to load overworld background texture!" << std::endl;
-    }
-
     if (!m_backgroundMusic.openFromFile("assets/music/Choral_Chambers.mp3")) {
         // 处理音乐加载失败
         std::cerr << "Failed to load overworld background music!" << std::endl;
     }
 
-    m_backgroundSprite.setPosition({0.f, 0.f});
-    m_backgroundSprite.setScale({2.0f, 2.0f});
+    // 世界图层每帧重画；UI 图层只在对话/背包内容变化时重画
+    m_compositor.setDynamic(Layer::World, true);
 
     m_backgroundMusic.setLooping(true);
     m_backgroundMusic.setVolume(30.f); // 设置适当的音量
     m_backgroundMusic.play();
 
-    // 初始化队伍顺序：默认 Kris 为队长，Susie、Ralsei 跟随
-    m_party = { &m_kris, &m_susie, &m_ralsei };
-    m_leaderIndex = 0; // Kris 为队长
+    // 初始化队伍：顺序与 Global::partyHeroes 一致，首位为队长
+    buildParty();
 
     // 初始开启调试矩形，可按 D 切换
     m_map.setDebugDraw(m_debugDrawEnabled);
@@ -177,19 +118,14 @@ OverworldState::OverworldState(Game& game)
         m_inventoryHeart.reset();
     }
 
-    // 加载地图（房间构建器）并设置初始位置：
-    // 若从“继续游戏”进入，依据 Global::currentMRoomName 决定出生点；否则默认教室
+    // 加载地图（assets/room 下的房间文件）并设置初始位置：
+    // 若从“继续游戏”进入，依据 Global::currentMRoomName 决定房间，出生点取房间文件中的默认值
     std::string desiredRoom = Global::currentMRoomName.empty() ? std::string("AlphysClass") : Global::currentMRoomName;
-    // 兜底：如果不是已知房间，则回落到 AlphysClass（防止默认值为 "Title" 导致地图为空）
-    if (desiredRoom != "AlphysClass" && desiredRoom != "SecretRoom") {
+    // 兜底：如果没有对应房间文件，则回落到 AlphysClass（防止默认值为 "Title" 导致地图为空）
+    if (!RoomLoader::exists(desiredRoom)) {
         desiredRoom = "AlphysClass";
     }
-    sf::Vector2f spawn = {350.f, 300.f};
-    if (desiredRoom == "SecretRoom") {
-        // 秘密房：存档点旁固定位置出生
-        spawn = {500.f, 320.f};
-    }
-    loadRoom(desiredRoom, spawn);
+    loadRoom(desiredRoom);
 }
 
 // 顶层输入事件处理：退出键、渐变锁、背包、对话锁、调试、菜单与交互
@@ -240,19 +176,15 @@ void OverworldState::handleEvent() {
                     if (m_dialogueBox.onConfirm()) {
                         // 对话结束后执行待处理动作（如拾取道具）
                         if (m_pendingAction == PendingAction::CollectHolyMantle) {
-                            auto& inv = Global::inventory;
-                            auto it = std::find_if(inv.begin(), inv.end(), [](const InventoryItem& item) {
-                                return item.id == "HolyMantle";
-                            });
-                            if (it == inv.end()) {
-                                inv.push_back(InventoryItem{ "HolyMantle", L"神圣斗篷", L"免疫每回合第一次受伤。" });
+                            if (!Global::inventory.contains("HolyMantle")) {
+                                Global::inventory.add("HolyMantle");
                             }
                             Global::hasHolyMantle = true;
                             // 重新加载当前地图以移除道具贴图与交互，保持当前位置
                             const sf::Vector2f curPos = getLeader().getPosition();
                             loadRoom(m_currentRoom, curPos);
                         } else if (m_pendingAction == PendingAction::StartBattleCalculus) {
-                            // 进入战斗：收集三人当前在 Overworld 的位置作为入场起点
+                            // 进入战斗：收集队员当前在 Overworld 的位置作为入场起点（顺序与 partyHeroes 一致）
                             std::vector<sf::Vector2f> starts;
                             starts.reserve(m_party.size());
                             for (auto* ch : m_party) {
@@ -260,8 +192,14 @@ void OverworldState::handleEvent() {
                                 starts.push_back(ch->getCenter());
                             }
                             m_pendingAction = PendingAction::None;
-                            m_isInputLocked = false;
-                            m_game.changeState(std::make_unique<BattleState>(m_game, makeCalculusEncounter(), std::move(starts), m_backgroundTexture, m_backgroundSprite.getScale()));
+                            // 战斗资源在后台预解码，完成后压栈；本状态挂起而非销毁，期间保持输入锁定（onResume 解锁）
+                            // 压栈前捕获最后一帧世界画面，作为战斗渐隐背景
+                            std::vector<Enemy> encounter = makeCalculusEncounter();
+                            std::vector<std::string> paths = BattleState::preloadPaths(Global::partyHeroes, encounter);
+                            const bool started = m_game.transitionTo([this, starts = std::move(starts), encounter = std::move(encounter)]() mutable -> std::unique_ptr<BaseState> {
+                                return std::make_unique<BattleState>(m_game, std::move(encounter), std::move(starts), captureFrame());
+                            }, std::move(paths));
+                            if (!started) m_isInputLocked = false;
                             return;
                         }
                         m_pendingAction = PendingAction::None;
@@ -370,6 +308,18 @@ void OverworldState::checkInteraction() {
     }
 }
 
+// 挂起：上层状态（战斗）运行期间暂停音乐，其余资源原样保留
+void OverworldState::onSuspend() {
+    m_backgroundMusic.pause();
+}
+
+// 恢复：从暂停处继续播放音乐并解锁输入（进入战斗前一直保持锁定）
+void OverworldState::onResume() {
+    m_pendingAction = PendingAction::None;
+    m_isInputLocked = false;
+    m_backgroundMusic.play();
+}
+
 // 主更新循环：地图动画、渐变优先、背包暂停、队伍跟随与传送
 void OverworldState::update(float dt) {
     // 地图内动画（例如存档点）始终更新
@@ -400,18 +350,15 @@ void OverworldState::update(float dt) {
 
     leader.updateLeader(dt, m_map);
     bool leaderMoving = leader.isMoving();
-    PositionRecord rec = leader.getRecord();
 
+    // 只记录移动：静止时轨迹保留，队长再次起步时队员沿原路径继续跟随
     if (leaderMoving) {
-        m_leaderHistory.push_front(rec);
-        if (m_leaderHistory.size() > m_maxHistory) {
-            m_leaderHistory.pop_back();
-        }
-    } else {
-        m_leaderHistory.clear();
-        m_leaderHistory.push_front(rec);
+        m_leaderTrail.push(leader.getRecord());
     }
 
+    // 靠近传送区时预加载目标房间，渐变期间即可完成
+    prefetchNearbyWarps();
+
     // 传送检查：使用脚底碰撞箱命中 WarpTrigger 后发起淡出
     if (WarpTrigger* warp = m_map.checkWarp(leader.getBounds())) {
         startFadeToRoom(warp->targetMap, warp->targetPos);
@@ -421,49 +368,128 @@ void OverworldState::update(float dt) {
     int followerSlot = 0;
     for (std::size_t i = 0; i < m_party.size(); ++i) {
         if (static_cast<int>(i) == m_leaderIndex) continue;
-        m_party[i]->updateFollower(m_leaderHistory, followerSlot, dt, leaderMoving, m_map);
+        m_party[i]->updateFollower(m_leaderTrail, followerSlot, dt, leaderMoving, m_map);
         ++followerSlot;
     }
+
+    m_camera.update(leader.getCenter(), dt);
 }
 
-// 绘制流程：背景 → 地图项+角色（按 y 排序） → 对话框 → 背包 UI → 调试 → 渐变遮罩
-void OverworldState::draw(sf::RenderWindow& window) {
-    // 1) 背景
-    m_map.drawBackground(window);
+// 绘制流程（经分层合成）：
+// - World（每帧）：背景 → 地图项+角色（裁剪后按 y 排序） → 调试覆盖，使用摄像机视图
+// - UI（内容变化时）：对话框 → 背包 UI，使用固定的 640x480 游戏视图
+// - 渐变遮罩在合成时叠加，不重画任何图层
+void OverworldState::draw(sf::RenderTarget& target) {
+    m_compositor.render(Layer::World, [this](sf::RenderTarget& layer) {
+        drawWorld(layer);
+        const sf::View uiView = layer.getView();
+        layer.setView(m_camera.makeView(uiView));
+        m_map.drawDebugOverlays(layer);
+        layer.setView(uiView);
+    });
 
-    // 2) 收集需要按 y 排序的绘制项（道具 + 角色）
-    std::vector<DrawItem> items;
-    items.reserve(m_party.size() + 8);
-    m_map.gatherDrawItems(items);
-    for (auto* ch : m_party) {
-        ch->collectDrawItem(items);
+    const UiSnapshot ui = makeUiSnapshot();
+    if (ui != m_uiSnapshot) {
+        m_uiSnapshot = ui;
+        m_compositor.invalidate(Layer::UI);
     }
-
-    std::stable_sort(items.begin(), items.end(), [](const DrawItem& a, const DrawItem& b) {
-        return a.yKey < b.yKey;
+    m_compositor.render(Layer::UI, [this](sf::RenderTarget& layer) {
+        if (m_dialogueBox.isActive()) {
+            m_dialogueBox.draw(layer);
+        }
+        if (m_inventoryOpen) {
+            drawInventory(layer);
+        }
     });
-    for (const auto& it : items) {
-        if (it.drawable) {
-            window.draw(*it.drawable);
+
+    m_compositor.setFade(sf::Color::Black, m_fadeAlpha);
+    m_compositor.composite(target);
+}
+
+// UI 图层的内容摘要：任一字段变化即重画 UI 图层
+OverworldState::UiSnapshot OverworldState::makeUiSnapshot() const {
+    UiSnapshot ui;
+    ui.dialogActive = m_dialogueBox.isActive();
+    ui.dialogRevision = m_dialogueBox.revision();
+    ui.inventoryOpen = m_inventoryOpen;
+    if (m_inventoryOpen) {
+        ui.itemCursor = m_itemCursor;
+        ui.actionCursor = m_actionCursor;
+        ui.selectingAction = m_selectingAction;
+        for (std::size_t i = 0; i < Global::inventory.size(); ++i) {
+            ui.inventoryHash = ui.inventoryHash * 31u + static_cast<std::uint32_t>(Global::inventory[i].count) + 1u;
         }
+        ui.inventoryHash = ui.inventoryHash * 31u + static_cast<std::uint32_t>(Global::inventory.size());
     }
+    return ui;
+}
 
-    // 3) 对话框（始终在最上层）
-    if (m_dialogueBox.isActive()) {
-        m_dialogueBox.draw(window);
-    }
+void OverworldState::drawWorld(sf::RenderTarget& target) {
+    const sf::View uiView = target.getView();
+    target.setView(m_camera.makeView(uiView));
+    const sf::FloatRect viewRect = m_camera.getViewRect();
 
-    // 物品栏 UI（居顶显示）
-    if (m_inventoryOpen) {
-        drawInventory(window);
+    m_map.drawBackground(target);
+
+    // 列表跨帧保留，只刷新动态项的排序键
+    if (!m_drawListValid || m_drawListRevision != m_map.entities().revision()) {
+        rebuildDrawList();
     }
+    m_map.refreshDrawList(m_drawList);
+    for (std::size_t i = 0; i < m_party.size() && i < m_partyDrawSlots.size(); ++i) {
+        const DrawItem item = m_party[i]->getDrawItem();
+        m_drawList.update(m_partyDrawSlots[i], item.yKey, item.bounds);
+    }
+    m_drawList.draw(target, viewRect);
+
+    target.setView(uiView);
+}
 
-    // 4) 调试覆盖（若开启）
-    m_map.drawDebugOverlays(window);
+// 捕获世界画面：渲染目标首次使用时创建，之后每次进入战斗重画一遍；
+// 返回的句柄与 m_frameCapture 共享所有权，战斗持有期间贴图保持有效
+std::shared_ptr<const sf::Texture> OverworldState::captureFrame() {
+    if (!m_frameCapture) {
+        auto capture = std::make_shared<sf::RenderTexture>();
+        if (!capture->resize({640u, 480u})) {
+            std::cerr << "OverworldState: failed to create frame capture target" << std::endl;
+            return nullptr;
+        }
+        m_frameCapture = std::move(capture);
+    }
+    m_frameCapture->setView(m_frameCapture->getDefaultView());
+    m_frameCapture->clear(sf::Color::Black);
+    drawWorld(*m_frameCapture);
+    m_frameCapture->display();
+    return std::shared_ptr<const sf::Texture>(m_frameCapture, &m_frameCapture->getTexture());
+}
 
-    // 5) 渐变遮罩
-    drawFade(window);
+// 按 Global::partyHeroes 创建队员；队伍为空时仍创建一名默认角色，保证始终有队长可操作
+void OverworldState::buildParty() {
+    m_members.clear();
+    m_party.clear();
+    for (const auto& hero : Global::partyHeroes) {
+        m_members.push_back(std::make_unique<OverworldCharacter>(m_game, AnimationLibrary::walk(hero.id)));
+    }
+    if (m_members.empty()) {
+        m_members.push_back(std::make_unique<OverworldCharacter>(m_game, AnimationLibrary::walk("kris")));
+    }
+    m_party.reserve(m_members.size());
+    for (auto& member : m_members) m_party.push_back(member.get());
+    m_leaderIndex = 0;
+    m_drawListValid = false;
+}
 
+// 重新登记绘制列表：地图实体（静态道具预排序）+ 队员（动态项）
+void OverworldState::rebuildDrawList() {
+    m_drawList.clear();
+    m_map.buildDrawList(m_drawList);
+    m_drawList.sortStatic();
+    m_partyDrawSlots.clear();
+    for (auto* ch : m_party) {
+        m_partyDrawSlots.push_back(m_drawList.addDynamic(ch->getDrawItem().drawable));
+    }
+    m_drawListRevision = m_map.entities().revision();
+    m_drawListValid = true;
 }
 
 // 获取当前队长引用（便于统一访问）
@@ -471,28 +497,54 @@ OverworldCharacter& OverworldState::getLeader() {
     return *m_party[m_leaderIndex];
 }
 
-// 构建并加载房间：同步全局房间名、重置队伍位置与历史
-void OverworldState::loadRoom(const std::string& roomName, const sf::Vector2f& playerPos)
+// 预加载：队长脚底中心到传送区的距离小于 m_prefetchRadius 时，后台开始加载目标房间
+void OverworldState::prefetchNearbyWarps()
+{
+    const sf::FloatRect feet = getLeader().getBounds();
+    const sf::Vector2f c = feet.position + feet.size * 0.5f;
+    for (const auto& warp : m_map.getWarps()) {
+        const sf::Vector2f lo = warp.area.position;
+        const sf::Vector2f hi = warp.area.position + warp.area.size;
+        const float dx = std::max({lo.x - c.x, 0.f, c.x - hi.x});
+        const float dy = std::max({lo.y - c.y, 0.f, c.y - hi.y});
+        if (dx * dx + dy * dy <= m_prefetchRadius * m_prefetchRadius) {
+            m_roomCache.prefetch(warp.targetMap);
+        }
+    }
+}
+
+// 加载房间：经 RoomCache 取得烘焙数据与贴图并实例化，同步全局房间名、重置队伍位置与轨迹
+void OverworldState::loadRoom(const std::string& roomName, const std::optional<sf::Vector2f>& playerPos)
 {
     m_currentRoom = roomName;
     // 同步全局当前房间名，便于存档
     Global::currentMRoomName = roomName;
 
-    if (roomName == "AlphysClass") {
-        buildAlphysClass(m_map);
-    } else if (roomName == "SecretRoom") {
-        buildSecretRoom(m_map);
+    // 命中常驻/预加载时不再读文件与解码贴图（拾取道具后的原地重载同样受益）
+    sf::Vector2f spawn = playerPos.value_or(sf::Vector2f{350.f, 300.f});
+    if (auto room = m_roomCache.acquire(roomName)) {
+        RoomLoader::apply(room->data, m_map, [&room](const std::string& path) { return room->texture(path); });
+        if (!playerPos.has_value()) spawn = room->data.spawn;
     } else {
         m_map.clear();
     }
 
-    // 重置队伍位置与历史
-    m_kris.setPosition(playerPos);
-    if (m_party.size() >= 2) m_party[1]->setPosition(playerPos + sf::Vector2f{-16.f, 12.f});
-    if (m_party.size() >= 3) m_party[2]->setPosition(playerPos + sf::Vector2f{16.f, 12.f});
+    // 重置队伍位置与轨迹：队长站在出生点，队员第 k 排左右交替站在其后方
+    getLeader().setPosition(spawn);
+    int followerSlot = 0;
+    for (std::size_t i = 0; i < m_party.size(); ++i) {
+        if (static_cast<int>(i) == m_leaderIndex) continue;
+        const float row = static_cast<float>(followerSlot / 2 + 1);
+        const float side = (followerSlot % 2 == 0) ? -1.f : 1.f;
+        m_party[i]->setPosition(spawn + sf::Vector2f{16.f * row * side, 12.f * row});
+        ++followerSlot;
+    }
+
+    m_leaderTrail.reset(getLeader().getRecord());
 
-    m_leaderHistory.clear();
-    m_leaderHistory.push_front(getLeader().getRecord());
+    // 摄像机：更新房间范围并直接对准队长
+    m_camera.setBounds(m_map.getCameraBounds());
+    m_camera.snapTo(getLeader().getCenter());
 }
 
 // 开始一次房间切换的渐变：先淡出（Out），Out 完成后执行实际换房，再淡入（In）
@@ -501,6 +553,7 @@ void OverworldState::startFadeToRoom(const std::string& roomName, const sf::Vect
     m_hasPendingWarp = true;
     m_pendingRoom = roomName;
     m_pendingSpawn = spawn;
+    m_roomCache.prefetch(roomName); // 兜底：未经过预加载范围（例如直接出生在传送区旁）
     m_fadePhase = FadePhase::Out;
     m_fadeTimer = 0.f;
     m_fadeAlpha = 0.f;
@@ -517,6 +570,10 @@ void OverworldState::updateFade(float dt)
     if (m_fadePhase == FadePhase::Out) {
         m_fadeAlpha = t;
         if (t >= 1.f) {
+            // 目标房间仍在后台加载：保持全黑等待，而不是在主线程阻塞
+            if (m_hasPendingWarp && !m_roomCache.isReady(m_pendingRoom)) {
+                return;
+            }
             if (m_hasPendingWarp) {
                 loadRoom(m_pendingRoom, m_pendingSpawn);
                 m_hasPendingWarp = false;
@@ -536,16 +593,6 @@ void OverworldState::updateFade(float dt)
     }
 }
 
-// 绘制黑色渐变遮罩（覆盖在最上层），alpha 由状态机控制
-void OverworldState::drawFade(sf::RenderWindow& window)
-{
-    if (m_fadePhase == FadePhase::None && m_fadeAlpha <= 0.f) return;
-    sf::RectangleShape mask({640.f, 480.f});
-    mask.setFillColor(sf::Color(0, 0, 0, static_cast<std::uint8_t>(255.f * std::clamp(m_fadeAlpha, 0.f, 1.f))));
-    mask.setPosition({0.f, 0.f});
-    window.draw(mask);
-}
-
 // 打开背包 UI：锁定输入，规范化游标位置
 void OverworldState::openInventory()
 {
@@ -631,7 +678,7 @@ void OverworldState::handleInventoryInput()
             auto& inv = Global::inventory;
             if (m_actionCursor == 0) {
                 // 使用：示例为“神圣斗篷”装备到 Kris 的第二护甲槽
-                const std::string itemId = inv[m_itemCursor].id;
+                const std::string itemId = inv[m_itemCursor].id();
                 bool consumed = false;
                 if (itemId == "HolyMantle") {
                     // 为 Kris 装备二号防具为 holy_mantle
@@ -645,7 +692,7 @@ void OverworldState::handleInventoryInput()
                     }
                 }
                 if (consumed) {
-                    inv.erase(inv.begin() + m_itemCursor);
+                    inv.remove(itemId);
                     int newCount = static_cast<int>(inv.size());
                     if (newCount == 0) {
                         m_itemCursor = 0;
@@ -657,9 +704,9 @@ void OverworldState::handleInventoryInput()
                 m_actionCursor = 0;
             } else {
                 // 丢弃：移除物品；若为“神圣斗篷”，同步清除全局标记
-                const std::string itemId = inv[m_itemCursor].id;
-                inv.erase(inv.begin() + m_itemCursor);
-                if (itemId == "HolyMantle") {
+                const std::string itemId = inv[m_itemCursor].id();
+                inv.remove(itemId);
+                if (itemId == "HolyMantle" && !inv.contains(itemId)) {
                     Global::hasHolyMantle = false;
                 }
                 int newCount = static_cast<int>(inv.size());
@@ -678,7 +725,7 @@ void OverworldState::handleInventoryInput()
 }
 
 // 背包绘制：整体布局、标题与描述区、列表与光标心形、底部动作区
-void OverworldState::drawInventory(sf::RenderWindow& window)
+void OverworldState::drawInventory(sf::RenderTarget& target)
 {
     const sf::Vector2f boxSize{520.f, 360.f};
     const sf::Vector2f boxPos{60.f, 60.f};
@@ -688,7 +735,7 @@ void OverworldState::drawInventory(sf::RenderWindow& window)
     bg.setFillColor(sf::Color(0, 0, 0, 220));
     bg.setOutlineColor(sf::Color::White);
     bg.setOutlineThickness(3.f);
-    window.draw(bg);
+    target.draw(bg);
 
     auto makeText = [&](const sf::String& str, unsigned int size) {
         sf::Text t(m_font, str, size);
@@ -699,12 +746,12 @@ void OverworldState::drawInventory(sf::RenderWindow& window)
     // 标题
     sf::Text title = makeText(sf::String(L"物品"), 28);
     title.setPosition({boxPos.x + boxSize.x * 0.5f - title.getGlobalBounds().size.x * 0.5f, boxPos.y + 12.f});
-    window.draw(title);
+    target.draw(title);
 
     // 描述区：显示物品说明或名称，超宽按像素换行
     sf::String descStr = L"没有物品。";
     if (!Global::inventory.empty() && m_itemCursor < static_cast<int>(Global::inventory.size())) {
-        const auto& item = Global::inventory[m_itemCursor];
+        const ItemData& item = *Global::inventory[m_itemCursor].item;
         if (!item.info.isEmpty()) {
             descStr = item.info;
         } else {
@@ -714,14 +761,16 @@ void OverworldState::drawInventory(sf::RenderWindow& window)
     sf::String descWrapped = wrapTextToWidth(descStr, boxSize.x - 40.f, m_font, 18);
     sf::Text desc = makeText(descWrapped, 18);
     desc.setPosition({boxPos.x + 20.f, boxPos.y + 58.f});
-    window.draw(desc);
+    target.draw(desc);
 
-    // 列表：逐行渲染；选中行高亮并在左侧绘制心形指示器
+    // 列表：逐行渲染（同种物品一行，数量大于 1 时附加 "xN"）；选中行高亮并在左侧绘制心形指示器
     float listStartY = boxPos.y + 110.f;
     const float lineH = 32.f;
     for (std::size_t i = 0; i < Global::inventory.size(); ++i) {
-        const auto& item = Global::inventory[i];
-        sf::Text row = makeText(item.name, 22);
+        const auto& stack = Global::inventory[i];
+        sf::String label = stack.item->name;
+        if (stack.count > 1) label += sf::String(" x" + std::to_string(stack.count));
+        sf::Text row = makeText(label, 22);
         float rowY = listStartY + lineH * static_cast<float>(i);
         row.setPosition({boxPos.x + 50.f, rowY});
         if (static_cast<int>(i) == m_itemCursor && !m_selectingAction) {
@@ -729,10 +778,10 @@ void OverworldState::drawInventory(sf::RenderWindow& window)
             if (m_inventoryHeart.has_value()) {
                 auto bounds = row.getGlobalBounds();
                 m_inventoryHeart->setPosition({boxPos.x + 24.f, rowY + bounds.size.y * 0.5f - 5.f});
-                window.draw(*m_inventoryHeart);
+                target.draw(*m_inventoryHeart);
             }
         }
-        window.draw(row);
+        target.draw(row);
     }
 
     // 底部操作：两项横向排列（使用/丢弃），选中项高亮并绘制心形
@@ -747,12 +796,12 @@ void OverworldState::drawInventory(sf::RenderWindow& window)
             if (m_inventoryHeart.has_value()) {
                 auto bounds = act.getGlobalBounds();
                 m_inventoryHeart->setPosition({actX - 26.f, actionY + bounds.size.y * 0.5f});
-                window.draw(*m_inventoryHeart);
+                target.draw(*m_inventoryHeart);
             }
         } else {
             act.setFillColor(sf::Color(220, 220, 220));
         }
-        window.draw(act);
+        target.draw(act);
     }
 }
 
@@ -12,36 +12,56 @@
 #pragma once
 #include <SFML/Graphics.hpp>
 #include <SFML/Audio.hpp>
-#include <deque>
+#include <memory>
+#include <optional>
 #include <vector>
 #include "States/BaseState.h"
+#include "Game/Compositor.h"
 #include "Overworld/Map.h"
+#include "Overworld/RoomCache.h"
+#include "Overworld/Camera.h"
+#include "Overworld/DrawList.h"
 #include "UI/DialogBox.h"
 #include "Overworld/OverworldCharacter.h"
-#include "Overworld/AlphysClass.h"
-#include "Overworld/SecretRoom.h"
 
 class OverworldState : public BaseState {
 private:
     // 私有成员变量（如果有的话）
     sf::Font m_font;
-    sf::Texture m_backgroundTexture;
-    sf::Sprite m_backgroundSprite;
     sf::Music m_backgroundMusic;
     GameMap m_map; // 地图数据与绘制
+    RoomCache m_roomCache; // 最近访问房间常驻 + 传送目标预加载
+    Camera m_camera;       // 跟随队长的摄像机（房间不大于 640x480 时保持静止）
+    const float m_prefetchRadius = 120.f; // 队长距传送区多近时开始预加载目标房间
     bool m_isInputLocked = false; // 输入锁定（对话时锁定）
     DialogueBox m_dialogueBox; // 对话框组件
 
-    OverworldCharacter m_kris;
-    OverworldCharacter m_ralsei;
-    OverworldCharacter m_susie;
-
+    // 队员按 Global::partyHeroes 的顺序创建（角色内部贴图自引用，故以 unique_ptr 持有）
+    std::vector<std::unique_ptr<OverworldCharacter>> m_members;
     std::vector<OverworldCharacter*> m_party; // 动态队伍，索引 0..n-1
     int m_leaderIndex = 0;                    // 当前队长在 m_party 中的索引
-    std::deque<PositionRecord> m_leaderHistory; // 队长移动记录
-    const std::size_t m_maxHistory = 300;       // 限制历史长度
+    LeaderTrail m_leaderTrail;                // 队长移动轨迹（环形缓冲，按路径距离采样）
+    DrawList m_drawList;                      // 持久 y 排序绘制列表（静态道具预排序 + 动态项插入排序）
+    std::vector<std::size_t> m_partyDrawSlots; // 队员在 m_drawList 中的动态句柄
+    std::uint32_t m_drawListRevision = 0;     // 登记时的实体增删计数
+    bool m_drawListValid = false;
     std::string m_currentRoom;
     bool m_debugDrawEnabled = false;              // 调试矩形开关
+    // 分层合成：World 每帧重画，UI 按内容摘要判断是否重画，渐变在合成时叠加
+    Compositor m_compositor;
+    struct UiSnapshot {
+        bool dialogActive = false;
+        std::uint32_t dialogRevision = 0;
+        bool inventoryOpen = false;
+        int itemCursor = 0;
+        int actionCursor = 0;
+        bool selectingAction = false;
+        std::uint32_t inventoryHash = 0;
+        bool operator==(const UiSnapshot&) const = default;
+    };
+    UiSnapshot m_uiSnapshot;
+    // 进入战斗时捕获的世界画面（640x480），以共享句柄交给战斗做渐隐背景，跨战斗复用
+    std::shared_ptr<sf::RenderTexture> m_frameCapture;
 
     // 物品栏 UI 状态
     bool m_inventoryOpen = false;
@@ -68,17 +88,29 @@ public:
     OverworldState(Game& game);
     virtual void handleEvent() override;
     virtual void update(float dt) override;
-    virtual void draw(sf::RenderWindow& window) override;
+    virtual void draw(sf::RenderTarget& target) override;
+    // 战斗等状态压在其上时挂起：暂停音乐，保留地图、队伍与贴图；恢复时继续播放并解锁输入
+    void onSuspend() override;
+    void onResume() override;
     void checkInteraction(); // 检查交互
-    void loadRoom(const std::string& roomName, const sf::Vector2f& playerPos);
+    // playerPos 为空时使用房间文件中的默认出生点
+    void loadRoom(const std::string& roomName, const std::optional<sf::Vector2f>& playerPos = std::nullopt);
     void openInventory();
     void closeInventory();
     void handleInventoryInput();
-    void drawInventory(sf::RenderWindow& window);
+    void drawInventory(sf::RenderTarget& target);
     void startFadeToRoom(const std::string& roomName, const sf::Vector2f& spawn);
     void updateFade(float dt);
-    void drawFade(sf::RenderWindow& window);
 
 private:
     OverworldCharacter& getLeader();
+    void buildParty();
+    // 地图实体或队伍变化后重新登记绘制列表
+    void rebuildDrawList();
+    // 世界层：背景 + y 排序的道具/NPC/角色（使用摄像机视图，结束后恢复 target 原视图）
+    void drawWorld(sf::RenderTarget& target);
+    // 把当前世界画面渲染到 m_frameCapture，返回与之共享所有权的贴图句柄（不拷贝贴图）
+    std::shared_ptr<const sf::Texture> captureFrame();
+    UiSnapshot makeUiSnapshot() const;
+    void prefetchNearbyWarps();
 };
\ No newline at end of file
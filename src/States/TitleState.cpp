@@ -112,21 +112,21 @@ void TitleState::update(float dt) {
     AudioManager::getInstance().update();
 }
 
-void TitleState::draw(sf::RenderWindow& window) {
+void TitleState::draw(sf::RenderTarget& target) {
     // 绘制标题界面
-    window.draw(m_backgroundSprite);
-    window.draw(m_titleText);
+    target.draw(m_backgroundSprite);
+    target.draw(m_titleText);
 
     // 先画菜单层
     for (const auto& option : m_menuOptions) {
-        window.draw(option);
+        target.draw(option);
     }
     sf::Vector2f textPos = m_menuOptions[m_selectIndex].getPosition();
     m_soulSprite.setPosition({textPos.x - 100.f, textPos.y - 8.f});
-    window.draw(m_soulSprite);
+    target.draw(m_soulSprite);
 
     // 最后绘制对话框，保证在最上层
-    m_dialogueBox.draw(window);
+    m_dialogueBox.draw(target);
 }
 
 void TitleState::updateTextColors() {
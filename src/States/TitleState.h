@@ -42,5 +42,5 @@ public:
     TitleState(Game& game);
     virtual void handleEvent() override;
     virtual void update(float dt) override;
-    virtual void draw(sf::RenderWindow& window) override;
+    virtual void draw(sf::RenderTarget& target) override;
 };
\ No newline at end of file
@@ -2,6 +2,8 @@
 #include "Manager/InputManager.h"
 #include "Manager/AudioManager.h"
 #include "Game/GlobalContext.h"
+#include "Game/CharacterRegistry.h"
+#include "Battle/BattleRules.h"
 #include <algorithm>
 #include <cctype>
 
@@ -24,9 +26,6 @@
 namespace {
 const sf::Color kPanelBg{0, 0, 0, 220};       // 面板背景色（半透明黑）
 const sf::Color kPanelOutline{80, 80, 80, 255}; // 面板边框颜色
-const sf::Color kCyan{40, 140, 200};           // 默认队员强调色（Kris）
-const sf::Color kSusie{200, 60, 160};          // Susie 强调色
-const sf::Color kRalsei{170, 200, 60};         // Ralsei 强调色
 const sf::Color kOrange{220, 120, 40};         // UI 按钮选中强调色
 const sf::Color kHPRed{220, 40, 40};           // HP 损失红色
 const float kPanelShiftDown = 30.f;            // 面板整体下移距离（留出战场空间）
@@ -98,9 +97,9 @@ BattleMenu::BattleMenu()
 			m_headTextures.emplace(key, std::move(set));
 		}
 	};
-	loadHeadSet("kris");
-	loadHeadSet("susie");
-	loadHeadSet("ralsei");
+	for (const auto& [key, sprites] : CharacterRegistry::characters) {
+		loadHeadSet(key);
+	}
 }
 
 // 根据行动类型刷新子选项列表（Act 来源于当前角色预设，Item 来源于全局背包）
@@ -117,48 +116,27 @@ void BattleMenu::refreshOptionsForAction(ActionType action)
 		break;
 	case ActionType::Act:
 		{
-			// 根据当前角色动态生成可用 Act；若无匹配则回退到“查看”占位
-			auto heroActs = [&]() {
-				std::vector<Option> acts;
-				if (!m_partyRef || m_currentHero < 0 || m_currentHero >= static_cast<int>(m_partyRef->size())) {
-					acts.push_back({ sf::String(L"查看"), sf::String(L"查看敌方参数"), ActData{ sf::String(L"查看"), sf::String(L"你检查了敌方状态"), 0, 0, 15.f }, std::nullopt });
-					return acts;
-				}
-				auto heroId = toLowerId((*m_partyRef)[m_currentHero].id);
-				if (heroId == "kris") {
-					acts.push_back({ sf::String(L"查看"), sf::String(L"注意到"), ActData{ sf::String(L"查看"), sf::String(L"你试着使用瞪眼法...\n可惜你不是拉马努金。"), 0, 0, 15.f }, std::nullopt });
-					acts.push_back({ sf::String(L"计算"), sf::String(L"尝试计算化简"), ActData{ sf::String(L"计算"), sf::String(L"你尝试着进行计算"), 10, 0, 10.f }, std::nullopt });
-					acts.push_back({ sf::String(L"凑微分"), sf::String(L"换元（不包括三角换元）"), ActData{ sf::String(L"凑微分"), sf::String(L"你进行了凑微分变形"), 6, 0, 18.f }, std::nullopt });
-				} else if (heroId == "susie") {
-					acts.push_back({ sf::String(L"逃跑"), sf::String(L"给你路打油"), ActData{ sf::String(L"逃跑"), sf::String(L"Susie尝试逃跑...\nRalsei制止了她!"), 8, 0, 8.f }, std::nullopt });
-					acts.push_back({ sf::String(L"拆分积分"), sf::String(L"将区间拆分后积分"), ActData{ sf::String(L"拆分积分"), sf::String(L"Susie进行了拆分积分"), 14, 0, 6.f }, std::nullopt });
-				} else if (heroId == "ralsei") {
-					acts.push_back({ sf::String(L"三角代换"), sf::String(L"使用三角代换求解"), ActData{ sf::String(L"三角代换"), sf::String(L"Ralsei使用了三角代换。"), 0, 0, 22.f }, std::nullopt });
-					acts.push_back({ sf::String(L"三角恒等变换"), sf::String(L"三角恒等变换"), ActData{ sf::String(L"三角恒等变换"), sf::String(L"Ralsei使用了三角恒等变换。"), 0, 0, 28.f }, std::nullopt });
-				} else {
-					acts.push_back({ sf::String(L"查看"), sf::String(L"注意到"), ActData{ sf::String(L"查看"), sf::String(L"你试着使用瞪眼法...\n可惜你不是拉马努金。"), 0, 0, 15.f }, std::nullopt });
-				}
-				return acts;
-			}();
-			for (auto& opt : heroActs) m_options.push_back(opt);
+			// 根据当前角色生成可用 Act（清单见 BattleRules::heroActs，无匹配时回退到“查看”）
+			std::string heroId;
+			if (m_partyRef && m_currentHero >= 0 && m_currentHero < static_cast<int>(m_partyRef->size())) {
+				heroId = toLowerId((*m_partyRef)[m_currentHero].id);
+			}
+			for (const auto& act : BattleRules::heroActs(heroId)) {
+				m_options.push_back({ act.data.name, act.hint, act.data, std::nullopt });
+			}
 		}
 		break;
 	case ActionType::Item:
 		if (Global::inventory.empty()) {
 			m_options.push_back({ sf::String(L"无物品"), sf::String(L"包里什么也没有"), std::nullopt, std::nullopt });
 		} else {
-			// 对每种 ID，跳过已被其他角色暂存占用的数量，再展示剩余实例
-			std::map<std::string, int> reservedConsumed; // 记录本次遍历中已跳过的实例计数
-			for (const auto& it : Global::inventory) {
-				int reserved = 0; // 已占用（锁定）的实例数量
-				auto rcIt = m_reservedItemCounts.find(it.id);
-				if (rcIt != m_reservedItemCounts.end()) reserved = std::max(0, rcIt->second);
-				int consumed = reservedConsumed[it.id]; // 我们已跳过的数量
-				if (consumed < reserved) {
-					reservedConsumed[it.id] = consumed + 1; // 跳过一个被占用的实例
-					continue; // 此实例被占用，跳过展示
-				}
-				m_options.push_back({ it.name, it.info, std::nullopt, it.id }); // 展示可用实例
+			// 每种物品只占一行；已被其他角色暂存占用的数量不计入，数量大于 1 时附加 "xN"
+			for (const auto& stack : Global::inventory) {
+				int avail = stack.available();
+				if (avail <= 0) continue;
+				sf::String label = stack.item->name;
+				if (avail > 1) label += sf::String(" x" + std::to_string(avail));
+				m_options.push_back({ label, stack.item->info, std::nullopt, stack.id() });
 			}
 			if (m_options.empty()) {
 				m_options.push_back({ sf::String(L"无可用物品"), sf::String(L"已被其他角色占用"), std::nullopt, std::nullopt });
@@ -187,13 +165,20 @@ void BattleMenu::beginTurn(const std::vector<HeroRuntime>& party, const std::vec
 	m_enemiesRef = &enemies;
 	m_partySize = static_cast<int>(party.size());
 	m_enemyCount = static_cast<int>(enemies.size());
+	m_enemyNameTexts.clear();
+	m_enemyNameTexts.reserve(enemies.size());
+	for (const auto& e : enemies) {
+		sf::Text name(m_font, e.getName(), 18);
+		name.setFillColor(sf::Color::White);
+		m_enemyNameTexts.push_back(std::move(name));
+	}
 	m_currentHero = 0;
 	m_heroCursor = 0;
 	m_lastCompletedHero = -1;
 	m_doneHeroes.assign(m_partySize, false);
 	m_committedActions.assign(m_partySize, std::nullopt);
 	m_committedItems.assign(m_partySize, std::nullopt);
-	m_reservedItemCounts.clear(); // 清空上一回合的物品暂存占用
+	Global::inventory.clearReservations(); // 清空上一回合的物品暂存占用
 	m_completedOrder.clear(); // 清空撤销栈
 	m_actionCursor = 0;
 	m_targetCursor = 0;
@@ -265,11 +250,7 @@ BattleMenu::MenuResult BattleMenu::handleInput(sf::RenderWindow& window)
 					// 若撤销的是物品，减少占用计数并清除已提交物品
 					if (m_committedActions[heroToUndo].has_value() && *m_committedActions[heroToUndo] == ActionType::Item) {
 						if (static_cast<int>(m_committedItems.size()) > heroToUndo && m_committedItems[heroToUndo].has_value()) {
-							auto it = m_reservedItemCounts.find(*m_committedItems[heroToUndo]);
-							if (it != m_reservedItemCounts.end() && it->second > 0) {
-								it->second -= 1;
-								if (it->second == 0) m_reservedItemCounts.erase(it);
-							}
+							Global::inventory.release(*m_committedItems[heroToUndo]);
 							m_committedItems[heroToUndo].reset();
 						}
 					}
@@ -360,7 +341,7 @@ BattleMenu::MenuResult BattleMenu::handleInput(sf::RenderWindow& window)
 			m_pendingItem = opt.itemId;
 			// 选择物品后暂存占用计数，避免其他角色重复选择同名物品的过量实例；撤销/取消时会归还
 			if (chosen == ActionType::Item && m_pendingItem.has_value()) {
-				m_reservedItemCounts[*m_pendingItem] += 1;
+				Global::inventory.reserve(*m_pendingItem);
 			}
 			m_stage = Stage::Target;
 			m_targetCursor = 0;
@@ -386,11 +367,7 @@ BattleMenu::MenuResult BattleMenu::handleInput(sf::RenderWindow& window)
 			} else {
 				// 若为物品选择阶段，取消时减少占用计数并清除待提交物品
 				if (chosen == ActionType::Item && m_pendingItem.has_value()) {
-					auto it = m_reservedItemCounts.find(*m_pendingItem);
-					if (it != m_reservedItemCounts.end() && it->second > 0) {
-						it->second -= 1;
-						if (it->second == 0) m_reservedItemCounts.erase(it);
-					}
+					Global::inventory.release(*m_pendingItem);
 					m_pendingItem.reset();
 				}
 				m_stage = Stage::Option;
@@ -447,10 +424,10 @@ void BattleMenu::update(float dt)
 }
 
 // 绘制状态栏：每个队员的头像、姓名与 HP 条（选中时上移高亮）
-void BattleMenu::drawStatus(sf::RenderWindow& window, float yOffset) const
+void BattleMenu::drawStatus(sf::RenderTarget& target, float yOffset) const
 {
 	if (!m_partyRef) return;
-	const sf::Vector2f viewSize = window.getView().getSize();
+	const sf::Vector2f viewSize = target.getView().getSize();
 	float panelTop = viewSize.y * 0.6f + kPanelShiftDown;
 	const float paddingX = 24.f;
 	const float gapX = 12.f;
@@ -461,10 +438,7 @@ void BattleMenu::drawStatus(sf::RenderWindow& window, float yOffset) const
 	const float liftY = 20.f;                             // 选中高亮时上移距离
 
 	auto heroColor = [&](const HeroRuntime& h) {
-		std::string key = toLowerId(h.id);
-		if (key == "susie") return kSusie;
-		if (key == "ralsei") return kRalsei;
-		return kCyan;
+		return CharacterRegistry::get(h.id).accent;
 	};
 
 	auto headVariantForHero = [&](int heroIndex) {
@@ -503,7 +477,7 @@ void BattleMenu::drawStatus(sf::RenderWindow& window, float yOffset) const
 		box.setFillColor(sf::Color(0, 0, 0, 180));
 		box.setOutlineThickness(isCurrent ? 2.f : 1.f);
 		box.setOutlineColor(isCurrent ? accent : sf::Color(80, 80, 80));
-		window.draw(box);
+		target.draw(box);
 
 		std::string key = toLowerId(h.id);
 		const sf::Texture* headTex = nullptr;
@@ -519,54 +493,54 @@ void BattleMenu::drawStatus(sf::RenderWindow& window, float yOffset) const
 			sf::Sprite head(*headTex);
 			head.setScale({1.f, 1.f});
 			head.setPosition({x + 6.f, y + 10.f});
-			window.draw(head);
+			target.draw(head);
 		} else {
 			sf::CircleShape stub(10.f);
 			stub.setFillColor(isCurrent ? accent : sf::Color(120, 120, 120));
 			stub.setPosition({x + 10.f, y + 8.f});
-			window.draw(stub); // 贴图缺失时用占位圆点保证布局稳定
+			target.draw(stub); // 贴图缺失时用占位圆点保证布局稳定
 		}
 
 		sf::Text name(m_font, h.name, 18);
 		name.setFillColor(sf::Color::White);
 		name.setPosition({x + 44.f, y});
-		window.draw(name);
+		target.draw(name);
 
 		sf::Text hpLabel(m_font, sf::String(L"HP"), 14);
 		hpLabel.setFillColor(sf::Color::White);
 		hpLabel.setPosition({x + 50.f, y + 18.f});
-		window.draw(hpLabel);
+		target.draw(hpLabel);
 
 		float ratio = (h.maxHP > 0) ? std::clamp(static_cast<float>(h.hp) / static_cast<float>(h.maxHP), 0.f, 1.f) : 0.f; // HP 比例（0~1）
 		float barW = std::max(80.f, boxW - 88.f);
 		sf::RectangleShape hpBar({barW, 10.f});
 		hpBar.setPosition({x + 76.f, y + 22.f});
 		hpBar.setFillColor(sf::Color(30, 30, 30));
-		window.draw(hpBar);
+		target.draw(hpBar);
 		sf::Color hpColor = accent;
 		sf::RectangleShape hpFill({barW * ratio, 10.f});
 		hpFill.setPosition({x + 76.f, y + 22.f});
 		hpFill.setFillColor(hpColor);
-		window.draw(hpFill);
+		target.draw(hpFill);
 		if (ratio < 1.f) {
 			float lostW = barW * (1.f - ratio);
 			sf::RectangleShape hpLost({lostW, 10.f});
 			hpLost.setPosition({x + 76.f + barW * ratio, y + 22.f});
 			hpLost.setFillColor(kHPRed);
-			window.draw(hpLost);
+			target.draw(hpLost);
 		}
 
 		sf::Text hpText(m_font, sf::String((std::to_string(h.hp) + std::string("/ ") + std::to_string(h.maxHP)).c_str()), 12);
 		hpText.setFillColor(sf::Color::White);
 		hpText.setPosition({x + 120.f, y + 2.f});
-		window.draw(hpText);
+		target.draw(hpText);
 	}
 }
 
 // 绘制行动图标：居中排列，当前行动高亮；在 Action/Option/Target 阶段显示
-void BattleMenu::drawActions(sf::RenderWindow& window, float yOffset) const
+void BattleMenu::drawActions(sf::RenderTarget& target, float yOffset) const
 {
-	const sf::Vector2f viewSize = window.getView().getSize();
+	const sf::Vector2f viewSize = target.getView().getSize();
 	// 仅当进入 Action/Option/Target 阶段时展示图标，并锚定到当前角色的原始框位置
 	if (!(m_stage == Stage::Action || m_stage == Stage::Option || m_stage == Stage::Target)) return;
 	int heroIndex = m_currentHero;
@@ -594,24 +568,24 @@ void BattleMenu::drawActions(sf::RenderWindow& window, float yOffset) const
 			sf::Sprite sprite = *icon.sprite;
 			if (selected) sprite.setTexture(icon.selected, true); else sprite.setTexture(icon.normal, true);
 			sprite.setPosition({x, iconBaseY});
-			window.draw(sprite);
+			target.draw(sprite);
 		} else {
 			sf::RectangleShape box({48.f, 32.f});
 			box.setPosition({x, iconBaseY});
 			box.setFillColor(sf::Color(20, 30, 60, 240));
 			box.setOutlineColor(selected ? kOrange : sf::Color(100, 100, 100));
 			box.setOutlineThickness(2.f);
-			window.draw(box);
+			target.draw(box);
 		}
 	}
 }
 
 // 绘制子选项或目标列表：
 // - Option 阶段：左侧列表 + 右侧描述；心形指示当前项
-// - Target 阶段：Item → 我方列表；否则 → 敌人卡片（含 HP/Mercy 条）
-void BattleMenu::drawOptions(sf::RenderWindow& window, float yOffset) const
+// - Target 阶段：Item → 我方列表；否则 → 敌人卡片（含 HP/Mercy 条，多敌人时滚动）
+void BattleMenu::drawOptions(sf::RenderTarget& target, float yOffset) const
 {
-	const sf::Vector2f viewSize = window.getView().getSize();
+	const sf::Vector2f viewSize = target.getView().getSize();
 	float panelTop = viewSize.y * 0.6f + kPanelShiftDown;
 	float startY = panelTop + 70.f + yOffset; // 子选项/目标列表起始 Y（在面板内再下移一定距离）
 	float lineH = 26.f;                       // 每行高度
@@ -625,7 +599,7 @@ void BattleMenu::drawOptions(sf::RenderWindow& window, float yOffset) const
 		sf::Text tip(m_font, m_idleTipText, 18);
 		tip.setFillColor(sf::Color(200, 200, 200));
 		tip.setPosition({textX, startY});
-		window.draw(tip);
+		target.draw(tip);
 		return;
 	}
 
@@ -637,7 +611,7 @@ void BattleMenu::drawOptions(sf::RenderWindow& window, float yOffset) const
 				sf::Text tip(m_font, sf::String(L"没有可选择的目标"), 18);
 				tip.setFillColor(sf::Color(200, 200, 200));
 				tip.setPosition({textX, y});
-				window.draw(tip);
+				target.draw(tip);
 				return;
 			}
 			for (int i = 0; i < m_partySize; ++i) {
@@ -645,12 +619,12 @@ void BattleMenu::drawOptions(sf::RenderWindow& window, float yOffset) const
 				if (m_heart && i == m_targetCursor) {
 					sf::Sprite heart = *m_heart;
 					heart.setPosition({textX - 26.f, lineY + 2.f}); // 子选项心形下移 6px
-					window.draw(heart);
+					target.draw(heart);
 				}
 				sf::Text t(m_font, (*m_partyRef)[i].name, 18);
 				t.setFillColor(i == m_targetCursor ? sf::Color(255, 240, 150) : sf::Color::White);
 				t.setPosition({textX, lineY});
-				window.draw(t);
+				target.draw(t);
 			}
 			return;
 		}
@@ -668,63 +642,51 @@ void BattleMenu::drawOptions(sf::RenderWindow& window, float yOffset) const
 		sf::Text hpLabel(m_font, sf::String(L"HP"), 14);
 		hpLabel.setFillColor(sf::Color(220, 220, 220));
 		hpLabel.setPosition({hpX, labelY});
-		window.draw(hpLabel);
+		target.draw(hpLabel);
 		sf::Text mercyLabel(m_font, sf::String(L"Mercy"), 14);
 		mercyLabel.setFillColor(sf::Color(220, 220, 220));
 		mercyLabel.setPosition({mercyX, labelY});
-		window.draw(mercyLabel);
-
-		for (int i = 0; i < m_enemyCount; ++i) {
+		target.draw(mercyLabel);
+
+		// 面板只放得下少数几张卡片；敌人更多时以游标所在卡片为准滚动显示
+		const float stride = cardH + gapY;
+		const float listTop = panelTop + 70.f + 8.f - 20.f; // 不含引入动画偏移，滚动窗口大小保持稳定
+		const int visible = std::max(1, static_cast<int>((viewSize.y - listTop) / stride));
+		const int first = std::clamp(m_targetCursor - visible + 1, 0, std::max(0, m_enemyCount - visible));
+		const int last = std::min(m_enemyCount, first + visible);
+		m_barBatch.clear();
+		for (int i = first; i < last; ++i) {
+			const int row = i - first;
 			float x = areaX;
-			float y = areaY + (cardH + gapY) * static_cast<float>(i) - (i == 0 ? 20.f : 0.f); // 第一张额外上移 20px
+			float y = areaY + stride * static_cast<float>(row) - (row == 0 ? 20.f : 0.f); // 第一张额外上移 20px
 
 			if (m_heart && i == m_targetCursor) {
 				sf::Sprite heart = *m_heart;
 				heart.setPosition({x - 22.f, y + cardH * 0.5f - 6.f});
-				window.draw(heart);
+				target.draw(heart);
 			}
 
 			if (m_enemiesRef && i < static_cast<int>(m_enemiesRef->size())) {
 				const auto& e = (*m_enemiesRef)[i];
-				sf::Text name(m_font, e.getName(), 18);
-				name.setFillColor(sf::Color::White);
-				name.setPosition({x + 12.f, y + 6.f});
-				window.draw(name);
+				if (i < static_cast<int>(m_enemyNameTexts.size())) {
+					sf::RenderStates states;
+					states.transform.translate({x + 12.f, y + 6.f});
+					target.draw(m_enemyNameTexts[i], states);
+				}
 
 				float barY = y + 15.f; // HP/Mercy 条整体下移 5px
 				float hpRatio = (e.getMaxHP() > 0) ? std::clamp(static_cast<float>(e.getHP()) / static_cast<float>(e.getMaxHP()), 0.f, 1.f) : 0.f;
 				float hpLeftW = barWidth * hpRatio;
-				float hpRightW = barWidth - hpLeftW;
-				if (hpLeftW > 0.f) {
-					sf::RectangleShape hpLeft({hpLeftW, 10.f});
-					hpLeft.setPosition({hpX, barY});
-					hpLeft.setFillColor(sf::Color(70, 190, 90));
-					window.draw(hpLeft);
-				}
-				if (hpRightW > 0.f) {
-					sf::RectangleShape hpRight({hpRightW, 10.f});
-					hpRight.setPosition({hpX + hpLeftW, barY});
-					hpRight.setFillColor(sf::Color(120, 40, 40));
-					window.draw(hpRight);
-				}
+				m_barBatch.add({{hpX, barY}, {hpLeftW, 10.f}}, sf::Color(70, 190, 90));
+				m_barBatch.add({{hpX + hpLeftW, barY}, {barWidth - hpLeftW, 10.f}}, sf::Color(120, 40, 40));
 
 				float mercyRatio = std::clamp(e.getMercy() / 100.f, 0.f, 1.f);
 				float mercyLeftW = barWidth * mercyRatio;
-				float mercyRightW = barWidth - mercyLeftW;
-				if (mercyLeftW > 0.f) {
-					sf::RectangleShape mercyLeft({mercyLeftW, 10.f});
-					mercyLeft.setPosition({mercyX, barY});
-					mercyLeft.setFillColor(sf::Color(240, 200, 40));
-					window.draw(mercyLeft);
-				}
-				if (mercyRightW > 0.f) {
-					sf::RectangleShape mercyRight({mercyRightW, 10.f});
-					mercyRight.setPosition({mercyX + mercyLeftW, barY});
-					mercyRight.setFillColor(sf::Color(160, 100, 40));
-					window.draw(mercyRight);
-				}
+				m_barBatch.add({{mercyX, barY}, {mercyLeftW, 10.f}}, sf::Color(240, 200, 40));
+				m_barBatch.add({{mercyX + mercyLeftW, barY}, {barWidth - mercyLeftW, 10.f}}, sf::Color(160, 100, 40));
 			}
 		}
+		m_barBatch.draw(target);
 		return;
 	}
 
@@ -732,7 +694,7 @@ void BattleMenu::drawOptions(sf::RenderWindow& window, float yOffset) const
 		sf::Text tip(m_font, sf::String(L"没有可用选项"), 18);
 		tip.setFillColor(sf::Color(180, 180, 180));
 		tip.setPosition({textX, startY});
-		window.draw(tip);
+		target.draw(tip);
 		return;
 	}
 
@@ -742,12 +704,12 @@ void BattleMenu::drawOptions(sf::RenderWindow& window, float yOffset) const
 		if (selected && m_heart) {
 			sf::Sprite heart = *m_heart;
 			heart.setPosition({textX - 26.f, y + 1.f}); // 子选项心形下移 5px
-			window.draw(heart);
+			target.draw(heart);
 		}
 		sf::Text opt(m_font, m_options[i].label, 18);
 		opt.setFillColor(selected ? sf::Color(255, 240, 150) : sf::Color::White);
 		opt.setPosition({textX, y});
-		window.draw(opt);
+		target.draw(opt);
 	}
 
 	// 描述显示右侧
@@ -755,13 +717,13 @@ void BattleMenu::drawOptions(sf::RenderWindow& window, float yOffset) const
 	sf::Text desc(m_font, m_options[sel].desc, 16);
 	desc.setFillColor(sf::Color(200, 200, 200));
 	desc.setPosition({textX + 180.f, startY});
-	window.draw(desc);
+	target.draw(desc);
 }
 
 // 顶层绘制：面板背景与边框 → 状态栏 → 行动图标 → 子选项/目标区
-void BattleMenu::draw(sf::RenderWindow& window) const
+void BattleMenu::draw(sf::RenderTarget& target) const
 {
-	const sf::Vector2f viewSize = window.getView().getSize();
+	const sf::Vector2f viewSize = target.getView().getSize();
 	float panelTop = viewSize.y * 0.6f + kPanelShiftDown;
 	float yOffset = (1.f - easeOutCubic(m_panelReveal)) * (viewSize.y - panelTop);
 	sf::RectangleShape panel({viewSize.x, viewSize.y - panelTop});
@@ -769,9 +731,9 @@ void BattleMenu::draw(sf::RenderWindow& window) const
 	panel.setFillColor(kPanelBg);
 	panel.setOutlineThickness(3.f);
 	panel.setOutlineColor(kPanelOutline);
-	window.draw(panel);
+	target.draw(panel);
 
-	drawStatus(window, yOffset);
-	drawActions(window, yOffset);
-	drawOptions(window, yOffset);
+	drawStatus(target, yOffset);
+	drawActions(target, yOffset);
+	drawOptions(target, yOffset);
 }
\ No newline at end of file
@@ -4,9 +4,9 @@
 #include <vector>
 #include <algorithm>
 #include <map>
-#include <map>
 #include "Battle/Battle.h"
 #include "Battle/Enemy.h"
+#include "UI/RectBatch.h"
 
 // 负责菜单输入与光标绘制（Deltarune 风格）
 class BattleMenu {
@@ -20,7 +20,7 @@ public:
 	};
 	MenuResult handleInput(sf::RenderWindow& window);
 	void update(float dt);
-	void draw(sf::RenderWindow& window) const;
+	void draw(sf::RenderTarget& target) const;
 	void setShowIdleTip(bool show) { m_showIdleTip = show; }
 	void setIdleTip(const sf::String& tip) { m_idleTipText = tip; }
 
@@ -46,9 +46,9 @@ private:
 
 	void refreshOptionsForAction(ActionType action);
 	bool actionNeedsTarget(ActionType action) const;
-	void drawStatus(sf::RenderWindow& window, float yOffset) const;
-	void drawActions(sf::RenderWindow& window, float yOffset) const;
-	void drawOptions(sf::RenderWindow& window, float yOffset) const;
+	void drawStatus(sf::RenderTarget& target, float yOffset) const;
+	void drawActions(sf::RenderTarget& target, float yOffset) const;
+	void drawOptions(sf::RenderTarget& target, float yOffset) const;
 
 private:
 	Stage m_stage = Stage::Done;
@@ -74,7 +74,6 @@ private:
 	std::optional<std::string> m_pendingItem; // 在 Option 阶段缓存的物品 ID
 	std::vector<std::optional<ActionType>> m_committedActions; // 已提交行动的记录，供头像 variant 及撤销使用
 	std::vector<std::optional<std::string>> m_committedItems; // 每个角色本回合已提交的物品ID
-	std::map<std::string, int> m_reservedItemCounts; // 本回合暂存占用的物品计数（支持同名多件）
 	std::vector<int> m_completedOrder; // 已完成角色的顺序栈（用于多次撤销）
 	float m_panelReveal = 0.f; // 0 -> hidden below, 1 -> fully shown
 	bool m_hasShownUI = false; // 是否已播放过面板上滑动画
@@ -82,6 +81,8 @@ private:
 	IconPair m_icons[5]; // Fight, Act, Item, Spare, Defend
 	std::map<std::string, std::map<int, sf::Texture>> m_headTextures;
 	const std::vector<Enemy>* m_enemiesRef = nullptr;
+	std::vector<sf::Text> m_enemyNameTexts; // 目标卡片上的敌人名字，每回合开始时创建一次
+	mutable RectBatch m_barBatch;           // 目标卡片的 HP/Mercy 条，绘制时重建并一次提交
 	bool m_showIdleTip = true;
 	sf::String m_idleTipText = sf::String(L"高数题毫无仁慈。");
 };
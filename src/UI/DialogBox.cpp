@@ -106,6 +106,7 @@ void DialogueBox::update(float dt) {
             }
             // 增加一个字
             m_charIndex++;
+            ++m_revision;
             
             // SFML 的 substring 方法：从 0 开始，截取 m_charIndex 个长度
             m_renderText.setString(m_targetText.substring(0, m_charIndex));
@@ -125,17 +126,17 @@ void DialogueBox::update(float dt) {
 }
 
 
-void DialogueBox::draw(sf::RenderWindow& window) {
+void DialogueBox::draw(sf::RenderTarget& target) {
     if (!m_active) return;
 
-    window.draw(m_boxBg);     // 画黑底
-    window.draw(m_boxBorder); // 画白框
+    target.draw(m_boxBg);     // 画黑底
+    target.draw(m_boxBorder); // 画白框
 
     if (m_hasFace && m_faceSprite.has_value()) {
-        window.draw(*m_faceSprite); // 解引用来绘制头像
+        target.draw(*m_faceSprite); // 解引用来绘制头像
     }
 
-    window.draw(m_renderText); // 画文字 
+    target.draw(m_renderText); // 画文字 
 
     // 文本打完后绘制选项（选项模式）
     if (m_isChoiceMode && !isTyping() && !m_optionTexts.empty()) {
@@ -146,7 +147,7 @@ void DialogueBox::draw(sf::RenderWindow& window) {
             } else {
                 m_optionTexts[i].setFillColor(sf::Color::White);
             }
-            window.draw(m_optionTexts[i]);
+            target.draw(m_optionTexts[i]);
         }
         // 红心指示器：放在当前选项左侧居中
         if (m_selectorSprite.has_value()) {
@@ -155,7 +156,7 @@ void DialogueBox::draw(sf::RenderWindow& window) {
             sf::FloatRect hb = m_selectorSprite->getGlobalBounds();
             sf::Vector2f heartPos{ b.position.x - hb.size.x - 10.f, b.position.y + (b.size.y - hb.size.y) * 0.5f };
             m_selectorSprite->setPosition(heartPos);
-            window.draw(*m_selectorSprite);
+            target.draw(*m_selectorSprite);
         }
     }
 }
@@ -175,6 +176,7 @@ bool DialogueBox::start(const sf::String& text, const sf::Texture* faceTexture,
     }
 
     m_active = true;
+    ++m_revision;
     m_targetText = wrapTextToWidth(text, 520.f, m_font, m_renderText.getCharacterSize()); // 先软换行再打字
     m_charIndex = 0;
     m_timer = 0.f;
@@ -206,6 +208,7 @@ bool DialogueBox::onConfirm() {
     const bool wasTyping = m_charIndex < m_targetText.getSize();
 
     // 无论如何先同步到全文，避免逻辑分支遗漏
+    ++m_revision;
     m_charIndex = m_targetText.getSize();
     m_renderText.setString(m_targetText);
     m_timer = 0.f;
@@ -235,6 +238,7 @@ bool DialogueBox::startWithChoices(const sf::String& text,
     if (!ok) return false;
     m_isChoiceMode = true;
     m_selectIndex = 0;
+    ++m_revision;
     m_optionTexts.clear();
     m_optionTexts.reserve(options.size());
     // 横向居中排布：起点根据数量自适应，左右放置
@@ -256,6 +260,7 @@ void DialogueBox::moveSelection(int delta)
     if (!isChoiceActive() || m_optionTexts.empty()) return;
     int n = static_cast<int>(m_optionTexts.size());
     m_selectIndex = (m_selectIndex + delta + n) % n;
+    ++m_revision;
     AudioManager::getInstance().playSound("button_move");
 }
 
@@ -264,6 +269,7 @@ std::optional<int> DialogueBox::onConfirmChoice()
     if (!isChoiceActive()) return std::nullopt;
     int chosen = m_selectIndex;
     m_active = false;
+    ++m_revision;
     m_isChoiceMode = false;
     AudioManager::getInstance().playSound("button_select");
     return chosen;
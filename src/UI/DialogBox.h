@@ -3,6 +3,7 @@
 #include <string>
 #include <vector>
 #include <optional>
+#include <cstdint>
 
 class DialogueBox {
 public:
@@ -25,7 +26,7 @@ public:
     void update(float dt);
     
     // 渲染
-    void draw(sf::RenderWindow& window);
+    void draw(sf::RenderTarget& target);
 
     // 玩家按下了确定键 (Z/Enter)
     // 返回值: true 表示这段话这就结束了(翻页)，false 表示刚刚跳过打字机直接显示全了
@@ -47,9 +48,12 @@ public:
     bool isTyping() const { return m_charIndex < m_targetText.getSize(); }
     // 对话框是否激活
     bool isActive() const { return m_active; }
+    // 显示内容版本号：开始/关闭对话、打出新字、切换选项时递增（供分层合成判断是否重画）
+    std::uint32_t revision() const { return m_revision; }
 
 private:
     bool m_active = false;
+    std::uint32_t m_revision = 0;
 
     // --- 文本相关 ---
     sf::Font m_font;
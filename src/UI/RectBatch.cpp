@@ -0,0 +1,48 @@
+﻿#include "UI/RectBatch.h"
+
+
+//
+// 纯色矩形批（RectBatch）
+// ----------------------
+// 职责：
+// - 以两个三角形表示一个矩形，追加进同一个顶点数组
+// 关键约定：
+// - 宽或高不为正的矩形直接忽略（如比例为 0 的血条前景）
+// - 不带贴图，颜色写在顶点上
+//
+
+void RectBatch::add(const sf::FloatRect& rect, sf::Color color)
+{
+	if (rect.size.x <= 0.f || rect.size.y <= 0.f) return;
+	const sf::Vector2f p = rect.position;
+	const sf::Vector2f q = rect.position + rect.size;
+	const sf::Vertex quad[4] = {
+		{ { p.x, p.y }, color },
+		{ { q.x, p.y }, color },
+		{ { q.x, q.y }, color },
+		{ { p.x, q.y }, color },
+	};
+	m_vertices.append(quad[0]);
+	m_vertices.append(quad[1]);
+	m_vertices.append(quad[2]);
+	m_vertices.append(quad[0]);
+	m_vertices.append(quad[2]);
+	m_vertices.append(quad[3]);
+}
+
+void RectBatch::addOutline(const sf::FloatRect& rect, float thickness, sf::Color color)
+{
+	const float t = thickness;
+	const sf::Vector2f p = rect.position;
+	const sf::Vector2f s = rect.size;
+	add({ { p.x - t, p.y - t }, { s.x + 2.f * t, t } }, color); // 上
+	add({ { p.x - t, p.y + s.y }, { s.x + 2.f * t, t } }, color); // 下
+	add({ { p.x - t, p.y }, { t, s.y } }, color);                 // 左
+	add({ { p.x + s.x, p.y }, { t, s.y } }, color);               // 右
+}
+
+void RectBatch::draw(sf::RenderTarget& target, const sf::RenderStates& states) const
+{
+	if (empty()) return;
+	target.draw(m_vertices, states);
+}
@@ -0,0 +1,25 @@
+﻿/*
+纯色矩形批。
+包含：
+
+把同一帧的血条、仁慈条、占位框等纯色矩形追加到一个顶点数组
+
+一次 draw 提交全部矩形
+*/
+
+#pragma once
+#include <SFML/Graphics.hpp>
+
+class RectBatch {
+public:
+	// 清空顶点但保留容量，逐帧重建不再分配
+	void clear() { m_vertices.clear(); }
+	void add(const sf::FloatRect& rect, sf::Color color);
+	// 向外描边（与 RectangleShape 正描边厚度一致）
+	void addOutline(const sf::FloatRect& rect, float thickness, sf::Color color);
+	bool empty() const { return m_vertices.getVertexCount() == 0; }
+	void draw(sf::RenderTarget& target, const sf::RenderStates& states = sf::RenderStates::Default) const;
+
+private:
+	sf::VertexArray m_vertices{ sf::PrimitiveType::Triangles };
+};
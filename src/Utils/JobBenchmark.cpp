@@ -0,0 +1,135 @@
+﻿#include "Utils/JobBenchmark.h"
+#include "Utils/JobSystem.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+//
+// 任务系统微基准（JobBenchmark）
+// ----------------------------
+// 职责：
+// - 对 1..N 个线程（N-1 个工作线程 + 调用线程）各建一个任务系统，依次测量：
+//   schedule 空任务、parallelFor 单元素块、主线程队列空任务的单任务耗时；依赖链每跳耗时；计算任务的扩展性
+// 关键约定：
+// - 计时包含提交与等待全部完成，反映调用方看到的端到端开销
+// - 扩展性任务的结果按元素写回并求和，任一线程数与单线程不同即报告 MISMATCH
+//
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+double elapsedNs(Clock::time_point start)
+{
+	return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+}
+
+// 空任务经 schedule 派发：全部计入同一个计数器后等待
+double scheduleNs(JobSystem& jobs, int count)
+{
+	const auto start = Clock::now();
+	JobSystem::CounterPtr counter;
+	for (int i = 0; i < count; ++i) {
+		counter = jobs.schedule([] {}, nullptr, JobSystem::Affinity::Any, counter);
+	}
+	jobs.wait(counter);
+	return elapsedNs(start) / std::max(1, count);
+}
+
+// 空块经 parallelFor 派发（粒度 1，每块一个任务，不分配内存）
+double parallelForNs(JobSystem& jobs, int count)
+{
+	std::atomic<int> touched{ 0 };
+	const auto start = Clock::now();
+	jobs.parallelFor(static_cast<std::size_t>(count), 1, [&](std::size_t, std::size_t) {
+		touched.fetch_add(1, std::memory_order_relaxed);
+	});
+	return elapsedNs(start) / std::max(1, touched.load());
+}
+
+// 主线程任务：进入主线程队列，由调用线程（即主线程）在 wait 中逐个执行
+double mainThreadNs(JobSystem& jobs, int count)
+{
+	const auto start = Clock::now();
+	JobSystem::CounterPtr counter;
+	for (int i = 0; i < count; ++i) {
+		counter = jobs.schedule([] {}, nullptr, JobSystem::Affinity::MainThread, counter);
+	}
+	jobs.wait(counter);
+	return elapsedNs(start) / std::max(1, count);
+}
+
+// 依赖链：每个任务依赖前一个任务的计数器，只能逐个执行
+double chainNs(JobSystem& jobs, int length)
+{
+	const auto start = Clock::now();
+	JobSystem::CounterPtr previous;
+	for (int i = 0; i < length; ++i) {
+		previous = jobs.schedule([] {}, previous);
+	}
+	jobs.wait(previous);
+	return elapsedNs(start) / std::max(1, length);
+}
+
+struct ScalingResult {
+	double ms = 0.0;
+	std::uint64_t checksum = 0;
+};
+
+// 计算任务：每个元素做固定次数的 xorshift，结果写回各自下标
+ScalingResult scaling(JobSystem& jobs, const JobBenchmarkConfig& config, std::vector<std::uint64_t>& out)
+{
+	const std::size_t count = static_cast<std::size_t>(std::max(0, config.workItems));
+	out.assign(count, 0);
+	const auto start = Clock::now();
+	jobs.parallelFor(count, static_cast<std::size_t>(std::max(1, config.grain)), [&](std::size_t b, std::size_t e) {
+		for (std::size_t i = b; i < e; ++i) {
+			std::uint64_t x = i * 0x9E3779B97F4A7C15ull + 1;
+			for (int k = 0; k < config.workPerItem; ++k) {
+				x ^= x << 13;
+				x ^= x >> 7;
+				x ^= x << 17;
+			}
+			out[i] = x;
+		}
+	});
+	ScalingResult result;
+	result.ms = elapsedNs(start) / 1e6;
+	for (std::uint64_t v : out) result.checksum += v;
+	return result;
+}
+}
+
+std::string runJobBenchmark(const JobBenchmarkConfig& config)
+{
+	const int maxThreads = config.maxThreads > 0
+		? config.maxThreads
+		: static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+	char buf[256];
+	std::string s;
+	std::snprintf(buf, sizeof(buf), "Job system benchmark: %d jobs, chain %d, %d items x %d iterations, grain %d\n",
+		config.jobs, config.chainLength, config.workItems, config.workPerItem, config.grain);
+	s += buf;
+	s += "  threads  schedule ns  parallelFor ns  main ns  chain ns/hop  work ms  speedup  result\n";
+
+	std::vector<std::uint64_t> out;
+	ScalingResult baseline;
+	for (int threads = 1; threads <= maxThreads; ++threads) {
+		JobSystem jobs(static_cast<unsigned>(threads - 1));
+		const double scheduled = scheduleNs(jobs, config.jobs);
+		const double ranged = parallelForNs(jobs, config.jobs);
+		const double onMain = mainThreadNs(jobs, config.jobs);
+		const double chained = chainNs(jobs, config.chainLength);
+		const ScalingResult r = scaling(jobs, config, out);
+		if (threads == 1) baseline = r;
+		std::snprintf(buf, sizeof(buf), "  %7d  %11.1f  %14.1f  %7.1f  %12.1f  %7.2f  %6.2fx  %s\n",
+			threads, scheduled, ranged, onMain, chained, r.ms,
+			r.ms > 0.0 ? baseline.ms / r.ms : 0.0,
+			r.checksum == baseline.checksum ? "match" : "MISMATCH");
+		s += buf;
+	}
+	return s;
+}
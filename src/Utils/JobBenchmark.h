@@ -0,0 +1,24 @@
+﻿/*
+任务系统微基准（无窗口）。
+包含：
+
+派发开销：空任务经 schedule / parallelFor / 主线程队列的单任务耗时
+
+依赖链延迟：逐个依赖前一任务的链上每一跳的耗时
+
+扩展性：同一计算量按 1..N 个线程执行的耗时、加速比与结果校验
+*/
+#pragma once
+#include <string>
+
+struct JobBenchmarkConfig {
+	int jobs = 100000;          // 派发开销测试的空任务数
+	int chainLength = 10000;    // 依赖链长度
+	int workItems = 1 << 20;    // 扩展性测试的元素数
+	int workPerItem = 64;       // 每个元素的迭代次数
+	int grain = 4096;           // 扩展性测试的 parallelFor 粒度
+	int maxThreads = 0;         // 0 表示硬件线程数
+};
+
+// 运行并返回可直接打印的报告
+std::string runJobBenchmark(const JobBenchmarkConfig& config);
@@ -0,0 +1,260 @@
+﻿#include "Utils/JobSystem.h"
+#include <algorithm>
+#include <cassert>
+#include <exception>
+#include <iostream>
+
+//
+// 任务系统（JobSystem）
+// --------------------
+// 职责：
+// - 维护固定数量的工作线程；每个线程一条受互斥量保护的双端队列
+// - 工作线程先取自己的队列，空了再按顺序从其他队列尾部窃取；都空时在条件变量上休眠
+// - 等待方在计数归零前同样窃取并执行任务，而不是阻塞；parallelFor 的等待方只执行本次的块，
+//   主线程在 wait 中只执行计入被等计数器的任务，避免接手无关的解码/存档等长任务
+// - schedule 的依赖任务挂在被依赖计数器上，计数归零时由最后完成的线程放入队列
+// - 主线程任务进入单独的队列，只在主线程的 pumpMainThread / wait 中执行
+// 关键约定：
+// - 工作线程提交到自己的队列头部；外部线程轮流提交到各队列
+// - parallelFor 不分配内存，上下文由其栈帧持有，等待结束前保证有效；schedule 的任务持有自己的函数对象
+// - 没有工作线程时，非主线程任务在提交处直接执行
+// - 析构时工作线程先执行完已入队的任务再退出；剩余的主线程任务及其放出的后续任务由析构线程执行，
+//   不留下挂在未完成计数器上的任务
+//
+
+namespace {
+thread_local const JobSystem* t_owner = nullptr; // 当前线程所属的任务系统（外部线程为空）
+thread_local int t_workerIndex = -1;              // 当前线程在所属任务系统中的工作线程下标
+}
+
+JobSystem& JobSystem::getInstance()
+{
+	// 至少保留一个工作线程，单核机器上后台解码等任务也不会阻塞主线程
+	static JobSystem instance(std::max(2u, std::thread::hardware_concurrency()) - 1);
+	return instance;
+}
+
+JobSystem::JobSystem(unsigned workerCount)
+	: m_mainThread(std::this_thread::get_id())
+{
+	m_workers.reserve(workerCount);
+	for (unsigned i = 0; i < workerCount; ++i) {
+		m_workers.push_back(std::make_unique<Worker>());
+	}
+	for (unsigned i = 0; i < workerCount; ++i) {
+		m_workers[i]->thread = std::thread(&JobSystem::workerLoop, this, static_cast<int>(i));
+	}
+}
+
+JobSystem::~JobSystem()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_sleepMutex);
+		m_stopping = true;
+	}
+	m_wake.notify_all();
+	for (auto& w : m_workers) {
+		if (w->thread.joinable()) w->thread.join();
+	}
+	m_drained = true;
+	for (;;) {
+		std::unique_ptr<Job> job;
+		{
+			std::lock_guard<std::mutex> lock(m_mainMutex);
+			if (m_mainJobs.empty()) break;
+			job = std::move(m_mainJobs.front());
+			m_mainJobs.pop_front();
+		}
+		execute(*job);
+	}
+	assert(m_liveJobs.load() == 0 && "JobSystem destroyed with jobs parked on unfinished counters");
+}
+
+int JobSystem::selfIndex() const
+{
+	return t_owner == this ? t_workerIndex : -1;
+}
+
+void JobSystem::submit(const Task& task)
+{
+	const int self = selfIndex();
+	const std::size_t index = (self >= 0)
+		? static_cast<std::size_t>(self)
+		: m_nextQueue.fetch_add(1, std::memory_order_relaxed) % m_workers.size();
+	{
+		std::lock_guard<std::mutex> lock(m_workers[index]->mutex);
+		m_workers[index]->tasks.push_front(task);
+	}
+	m_queued.fetch_add(1, std::memory_order_release);
+	{
+		// 与休眠方的检查互斥，避免提交恰好落在“检查为空”与“开始等待”之间而丢失唤醒
+		std::lock_guard<std::mutex> lock(m_sleepMutex);
+	}
+	m_wake.notify_one();
+}
+
+// 取一个任务执行：自己的队列头部优先，其次从其他队列尾部窃取；没有任务返回 false
+// accept 非空时只取满足条件的任务（自己的队列从头部找，其他队列从尾部找）
+bool JobSystem::tryRun(int self, TaskFilter accept, const void* context)
+{
+	const std::size_t count = m_workers.size();
+	const auto matches = [&](const Task& t) { return accept(t, context); };
+	Task task;
+	bool found = false;
+	if (self >= 0) {
+		Worker& own = *m_workers[static_cast<std::size_t>(self)];
+		std::lock_guard<std::mutex> lock(own.mutex);
+		auto it = accept ? std::find_if(own.tasks.begin(), own.tasks.end(), matches) : own.tasks.begin();
+		if (it != own.tasks.end()) {
+			task = *it;
+			own.tasks.erase(it);
+			found = true;
+		}
+	}
+	const std::size_t start = (self >= 0) ? static_cast<std::size_t>(self) + 1 : 0;
+	for (std::size_t k = 0; !found && k < count; ++k) {
+		Worker& victim = *m_workers[(start + k) % count];
+		std::lock_guard<std::mutex> lock(victim.mutex);
+		auto it = accept ? std::find_if(victim.tasks.rbegin(), victim.tasks.rend(), matches) : victim.tasks.rbegin();
+		if (it != victim.tasks.rend()) {
+			task = *it;
+			victim.tasks.erase(std::next(it).base());
+			found = true;
+		}
+	}
+	if (!found) return false;
+	m_queued.fetch_sub(1, std::memory_order_acq_rel);
+	run(task);
+	return true;
+}
+
+void JobSystem::run(const Task& task)
+{
+	if (task.job) {
+		std::unique_ptr<Job> job(task.job);
+		execute(*job);
+		return;
+	}
+	task.invoke(task.context, task.begin, task.end);
+	task.remaining->fetch_sub(1, std::memory_order_acq_rel);
+}
+
+void JobSystem::waitFor(const std::atomic<std::size_t>& remaining)
+{
+	// 只执行本次 parallelFor 的块：其余块要么在队列中可被自己取到，要么正由其他线程执行
+	const TaskFilter ownChunk = [](const Task& t, const void* context) { return t.remaining == context; };
+	while (remaining.load(std::memory_order_acquire) > 0) {
+		if (!tryRun(selfIndex(), ownChunk, &remaining)) std::this_thread::yield();
+	}
+}
+
+void JobSystem::workerLoop(int index)
+{
+	t_owner = this;
+	t_workerIndex = index;
+	for (;;) {
+		if (tryRun(index)) continue;
+		std::unique_lock<std::mutex> lock(m_sleepMutex);
+		m_wake.wait(lock, [this] { return m_stopping || m_queued.load(std::memory_order_acquire) > 0; });
+		if (m_stopping && m_queued.load(std::memory_order_acquire) == 0) return;
+	}
+}
+
+JobSystem::CounterPtr JobSystem::schedule(std::function<void()> fn, const CounterPtr& dependency,
+	Affinity affinity, CounterPtr counter)
+{
+	if (!counter) counter = std::make_shared<Counter>();
+	counter->m_pending.fetch_add(1, std::memory_order_acq_rel);
+	m_liveJobs.fetch_add(1, std::memory_order_relaxed);
+	auto job = std::make_unique<Job>();
+	job->owner = this;
+	job->fn = std::move(fn);
+	job->counter = counter;
+	job->affinity = affinity;
+
+	if (dependency) {
+		// 与 finish 在同一把锁下检查：要么挂上等待列表，要么确认依赖已完成，不会漏放
+		std::lock_guard<std::mutex> lock(dependency->m_mutex);
+		if (!dependency->done()) {
+			dependency->m_continuations.push_back(std::move(job));
+			return counter;
+		}
+	}
+	dispatch(std::move(job));
+	return counter;
+}
+
+void JobSystem::dispatch(std::unique_ptr<Job> job)
+{
+	if (job->affinity == Affinity::MainThread) {
+		std::lock_guard<std::mutex> lock(m_mainMutex);
+		m_mainJobs.push_back(std::move(job));
+		return;
+	}
+	if (m_workers.empty() || m_drained) {
+		execute(*job);
+		return;
+	}
+	Task task;
+	task.job = job.release();
+	submit(task);
+}
+
+void JobSystem::execute(Job& job)
+{
+	try {
+		job.fn();
+	} catch (const std::exception& e) {
+		// 异常不跨线程传播：记录后照常完成计数，等待方不会卡住
+		std::cerr << "JobSystem: job failed: " << e.what() << std::endl;
+	}
+	finish(*job.counter);
+	m_liveJobs.fetch_sub(1, std::memory_order_relaxed);
+}
+
+// 计数归零时放出依赖它的任务；计数器被复用（归零后又计入新任务）时留给下一次归零
+void JobSystem::finish(Counter& counter)
+{
+	if (counter.m_pending.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+	std::vector<std::unique_ptr<Job>> ready;
+	{
+		std::lock_guard<std::mutex> lock(counter.m_mutex);
+		if (!counter.done()) return;
+		ready.swap(counter.m_continuations);
+	}
+	for (auto& job : ready) {
+		JobSystem* owner = job->owner;
+		owner->dispatch(std::move(job));
+	}
+}
+
+void JobSystem::wait(const CounterPtr& counter)
+{
+	if (!counter) return;
+	const bool onMain = isMainThread();
+	// 主线程只帮忙执行计入该计数器的任务；依赖的前置任务由工作线程执行
+	const TaskFilter counted = [](const Task& t, const void* context) { return t.job && t.job->counter.get() == context; };
+	while (!counter->done()) {
+		if (onMain && pumpMainThread(1) > 0) continue;
+		const bool ran = onMain ? tryRun(selfIndex(), counted, counter.get()) : tryRun(selfIndex());
+		if (!ran) std::this_thread::yield();
+	}
+}
+
+std::size_t JobSystem::pumpMainThread(std::size_t maxJobs)
+{
+	if (!isMainThread()) return 0;
+	std::size_t ran = 0;
+	while (ran < maxJobs) {
+		std::unique_ptr<Job> job;
+		{
+			std::lock_guard<std::mutex> lock(m_mainMutex);
+			if (m_mainJobs.empty()) break;
+			job = std::move(m_mainJobs.front());
+			m_mainJobs.pop_front();
+		}
+		execute(*job);
+		++ran;
+	}
+	return ran;
+}
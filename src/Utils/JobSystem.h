@@ -0,0 +1,152 @@
+﻿/*
+任务系统（工作窃取线程池）。
+包含：
+
+固定数量的工作线程，每个线程一条双端任务队列
+
+空闲线程从其他队列尾部窃取任务
+
+parallelFor：按固定粒度切块分发，调用线程只帮忙执行本次的块，全部完成后返回
+
+schedule：提交通用任务，以计数器表示完成与依赖；可限定只在主线程执行（GPU 上传）
+*/
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class JobSystem {
+public:
+	// 任务亲和性：MainThread 任务只由主线程在 pumpMainThread / wait 中执行（创建 sf::Texture 等 OpenGL 资源）
+	enum class Affinity { Any, MainThread };
+
+	class Counter;
+	using CounterPtr = std::shared_ptr<Counter>;
+
+private:
+	// 通用任务：由 schedule 堆分配，执行后释放
+	struct Job {
+		JobSystem* owner = nullptr;
+		std::function<void()> fn;
+		CounterPtr counter;
+		Affinity affinity = Affinity::Any;
+	};
+
+public:
+	// 完成计数器：计入的任务提交时 +1、执行完 -1，归零即这一组任务全部完成
+	// 在提交方、依赖方与等待方之间共享；同一计数器可汇集多个任务（扇入）
+	class Counter {
+	public:
+		bool done() const { return m_pending.load(std::memory_order_acquire) == 0; }
+
+	private:
+		friend class JobSystem;
+		std::atomic<std::size_t> m_pending{ 0 };
+		std::mutex m_mutex;
+		std::vector<std::unique_ptr<Job>> m_continuations; // 依赖本计数器、等其归零才入队的任务
+	};
+
+	// 全局实例：工作线程数为硬件线程数 - 1（调用线程本身也执行任务）
+	static JobSystem& getInstance();
+
+	explicit JobSystem(unsigned workerCount);
+	~JobSystem();
+
+	JobSystem(const JobSystem&) = delete;
+	JobSystem& operator=(const JobSystem&) = delete;
+
+	unsigned workerCount() const { return static_cast<unsigned>(m_workers.size()); }
+
+	// 构造任务系统的线程视为主线程
+	bool isMainThread() const { return std::this_thread::get_id() == m_mainThread; }
+
+	// 提交通用任务：dependency 非空时等它归零后才入队；任务计入 counter（为空则新建）并返回该计数器
+	// 任务不可依赖自己所计入的计数器
+	CounterPtr schedule(std::function<void()> fn, const CounterPtr& dependency = nullptr,
+		Affinity affinity = Affinity::Any, CounterPtr counter = nullptr);
+
+	// 等待计数器归零（空指针视为已完成）：在主线程调用时执行主线程任务，并只帮忙执行计入该计数器的任务
+	// （不会接手无关的长任务而卡住一帧）；在其他线程调用时执行队列中的任意任务
+	void wait(const CounterPtr& counter);
+
+	// 主线程每帧调用：执行至多 maxJobs 个已就绪的主线程任务，返回执行数量；其他线程调用直接返回 0
+	std::size_t pumpMainThread(std::size_t maxJobs = std::numeric_limits<std::size_t>::max());
+
+	// 把 [0, count) 按 grain 切成块（块边界恰为 grain 的整数倍），对每块调用 fn(begin, end)
+	// 块的划分只取决于 count 与 grain，与线程数无关；fn 须可并发调用且各块互不写同一数据
+	template <typename Fn>
+	void parallelFor(std::size_t count, std::size_t grain, const Fn& fn)
+	{
+		if (count == 0) return;
+		if (grain == 0) grain = 1;
+		if (m_workers.empty() || count <= grain) {
+			for (std::size_t b = 0; b < count; b += grain) fn(b, std::min(count, b + grain));
+			return;
+		}
+		const std::size_t chunks = (count + grain - 1) / grain;
+		std::atomic<std::size_t> remaining{ chunks };
+		for (std::size_t c = 0; c < chunks; ++c) {
+			const std::size_t b = c * grain;
+			submit({ &invokeRange<Fn>, &fn, b, std::min(count, b + grain), &remaining });
+		}
+		waitFor(remaining);
+	}
+
+private:
+	// 队列中的一项：parallelFor 的区间块（函数指针 + 上下文 + 区间，完成后递减计数，不做堆分配），
+	// 或 schedule 提交的通用任务（job 非空，所有权随任务转移）
+	struct Task {
+		void (*invoke)(const void* context, std::size_t begin, std::size_t end) = nullptr;
+		const void* context = nullptr;
+		std::size_t begin = 0;
+		std::size_t end = 0;
+		std::atomic<std::size_t>* remaining = nullptr;
+		Job* job = nullptr;
+	};
+
+	struct Worker {
+		std::mutex mutex;
+		std::deque<Task> tasks; // 所属线程从头部取，窃取者从尾部取
+		std::thread thread;
+	};
+
+	template <typename Fn>
+	static void invokeRange(const void* context, std::size_t begin, std::size_t end)
+	{
+		(*static_cast<const Fn*>(context))(begin, end);
+	}
+
+	// 任务筛选：等待方只帮忙执行与自己相关的任务
+	using TaskFilter = bool (*)(const Task& task, const void* context);
+
+	int selfIndex() const;
+	void submit(const Task& task);
+	bool tryRun(int self, TaskFilter accept = nullptr, const void* context = nullptr);
+	void run(const Task& task);
+	void waitFor(const std::atomic<std::size_t>& remaining);
+	void workerLoop(int index);
+	void dispatch(std::unique_ptr<Job> job);
+	void execute(Job& job);
+	static void finish(Counter& counter);
+
+	std::vector<std::unique_ptr<Worker>> m_workers;
+	std::atomic<std::size_t> m_queued{ 0 };  // 所有队列中尚未取出的任务数
+	std::atomic<unsigned> m_nextQueue{ 0 };  // 外部线程提交时轮流选择队列
+	std::mutex m_sleepMutex;
+	std::condition_variable m_wake;
+	bool m_stopping = false;
+	bool m_drained = false;                  // 析构时工作线程退出后置位：此后放出的任务在析构线程直接执行
+	std::atomic<std::size_t> m_liveJobs{ 0 }; // schedule 提交、尚未执行完的任务数（含挂在计数器上的）
+
+	std::thread::id m_mainThread;
+	std::mutex m_mainMutex;
+	std::deque<std::unique_ptr<Job>> m_mainJobs; // 已就绪、等待主线程执行的任务
+};
@@ -1,10 +1,95 @@
+#include <charconv>
+#include <cstring>
 #include <iostream>
+#include <string>
 #include <SFML/Graphics.hpp>
 #include "Game/Game.h"
+#include "Game/Database.h"
+#include "Battle/Calculus.h"
+#include "Battle/BattleSimulator.h"
+#include "Battle/BulletBenchmark.h"
+#include "Utils/JobBenchmark.h"
 
-int main() {
+// 整个参数解析为整数（from_chars 不抛异常）；含非数字字符或越界时返回 false
+template <typename T>
+static bool parseNumber(const char* text, T& out) {
+    const char* end = text + std::strlen(text);
+    const auto [ptr, ec] = std::from_chars(text, end, out);
+    return ec == std::errc() && ptr == end;
+}
+
+// 参数错误：打印用法并返回非零退出码
+static int usage(const char* line) {
+    std::cerr << "usage: " << line << std::endl;
+    return 2;
+}
+
+// 离线平衡模拟：--simulate N [seed] [--threads T] [--mantle heroIndex] [--enemies count]
+// 不创建窗口，直接把统计结果打印到标准输出
+static int runSimulation(int argc, char** argv, int argi) {
+    const char* const kUsage = "--simulate [battles] [seed] [--threads T] [--mantle heroIndex] [--enemies count]";
+    SimulationConfig config;
+    int enemyCount = 1;
+    if (argi < argc && argv[argi][0] != '-' && !parseNumber(argv[argi++], config.battles)) return usage(kUsage);
+    if (argi < argc && argv[argi][0] != '-' && !parseNumber(argv[argi++], config.seed)) return usage(kUsage);
+    // 其余参数必须是成对的“选项 值”：未知选项或缺值都报错，不静默按默认值运行
+    for (; argi < argc; argi += 2) {
+        if (argi + 1 >= argc) return usage(kUsage);
+        const std::string key = argv[argi];
+        bool ok = false;
+        if (key == "--threads") ok = parseNumber(argv[argi + 1], config.threads);
+        else if (key == "--mantle") ok = parseNumber(argv[argi + 1], config.mantleWearer);
+        else if (key == "--enemies") ok = parseNumber(argv[argi + 1], enemyCount);
+        if (!ok) return usage(kUsage);
+    }
+    Database::init();
+    BattleSimulator simulator(config);
+    std::cout << simulator.run(makeCalculusEncounter(enemyCount)).format();
+    return 0;
+}
+
+// 弹幕更新基准：--bench-bullets [count] [steps] [--threads maxThreads]
+// 依次用 1..maxThreads 个线程推进同一批弹幕，打印每步耗时、加速比与结果一致性
+static int runBulletBench(int argc, char** argv, int argi) {
+    const char* const kUsage = "--bench-bullets [count] [steps] [--threads maxThreads]";
+    BulletBenchmarkConfig config;
+    if (argi < argc && argv[argi][0] != '-' && !parseNumber(argv[argi++], config.bullets)) return usage(kUsage);
+    if (argi < argc && argv[argi][0] != '-' && !parseNumber(argv[argi++], config.steps)) return usage(kUsage);
+    for (; argi < argc; argi += 2) {
+        if (argi + 1 >= argc || std::string(argv[argi]) != "--threads") return usage(kUsage);
+        if (!parseNumber(argv[argi + 1], config.maxThreads)) return usage(kUsage);
+    }
+    std::cout << runBulletBenchmark(config);
+    return 0;
+}
+
+// 任务系统微基准：--bench-jobs [jobs] [--chain length] [--items count] [--threads maxThreads]
+// 依次用 1..maxThreads 个线程测量派发开销、依赖链延迟与计算任务的加速比
+static int runJobBench(int argc, char** argv, int argi) {
+    const char* const kUsage = "--bench-jobs [jobs] [--chain length] [--items count] [--threads maxThreads]";
+    JobBenchmarkConfig config;
+    if (argi < argc && argv[argi][0] != '-' && !parseNumber(argv[argi++], config.jobs)) return usage(kUsage);
+    for (; argi < argc; argi += 2) {
+        if (argi + 1 >= argc) return usage(kUsage);
+        const std::string key = argv[argi];
+        bool ok = false;
+        if (key == "--chain") ok = parseNumber(argv[argi + 1], config.chainLength);
+        else if (key == "--items") ok = parseNumber(argv[argi + 1], config.workItems);
+        else if (key == "--threads") ok = parseNumber(argv[argi + 1], config.maxThreads);
+        if (!ok) return usage(kUsage);
+    }
+    std::cout << runJobBenchmark(config);
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    for (int i = 1; i < argc; ++i) {
+        if (std::string(argv[i]) == "--simulate") return runSimulation(argc, argv, i + 1);
+        if (std::string(argv[i]) == "--bench-bullets") return runBulletBench(argc, argv, i + 1);
+        if (std::string(argv[i]) == "--bench-jobs") return runJobBench(argc, argv, i + 1);
+    }
     std::cout << "Hello, WHUDR!" << std::endl;
     Game game;
     game.run();
     return 0;
-}
\ No newline at end of file
+}